@@ -5,9 +5,14 @@
  * @date   August 14, 2024
 */
 #include "cbuild.h"
+#include "include/shared/pack.h"
+#include "include/shared/cooked.h"
 #include <unistd.h>
 
 #define GAME_NAME "bigmode-2025"
+// NOTE(alicia): raygui loads styles with fopen so
+// they have to be shipped as loose files.
+#define LOOSE_RESOURCES_DIR "resources/ui/styles"
 // 1 gib
 #define TOTAL_MEMORY 536870912
 
@@ -90,6 +95,8 @@ enum Mode {
     M_PACKAGE,
     M_EDITOR,
     M_TEST,
+    M_PACK,
+    M_COOK,
 
     M_COUNT
 };
@@ -115,6 +122,10 @@ struct Args {
         struct Package {
             struct Build build;
         } package;
+        struct Cook {
+            struct Build build;
+            bool is_forced;
+        } cook;
     };
 };
 
@@ -124,6 +135,8 @@ int mode_run( struct Args* args );
 int mode_package( struct Args* args );
 int mode_editor( struct Args* args );
 int mode_test( struct Args* args );
+int mode_pack( struct Args* args );
+int mode_cook( struct Args* args );
 
 bool __make_dirs( const char* first, ... );
 #define make_dirs( ... ) __make_dirs( __VA_ARGS__, NULL )
@@ -174,6 +187,13 @@ int main( int argc, const char** argv ) {
                 }
             }
 
+            if( args.mode == M_COOK ) {
+                if( string_cmp( arg, string_text("-force") ) ) {
+                    args.cook.is_forced = true;
+                    continue;
+                }
+            }
+
             if( args.mode == M_BUILD ) {
                 String target_prefix = string_text("-target=");
                 if(
@@ -206,6 +226,8 @@ int main( int argc, const char** argv ) {
         case M_PACKAGE: return mode_package( &args );
         case M_EDITOR:  return mode_editor( &args );
         case M_TEST:    return mode_test( &args );
+        case M_PACK:    return mode_pack( &args );
+        case M_COOK:    return mode_cook( &args );
         case M_COUNT:   return 1;
     }
 
@@ -357,7 +379,17 @@ int mode_package( struct Args* args ) {
         return result;
     }
 
-    result = quick_cmd( "zip", "-r", "resources.zip", "resources" );
+    args->cook.is_forced = false;
+    result = mode_cook( args );
+    if( result ) {
+        return result;
+    }
+    result = mode_pack( args );
+    if( result ) {
+        return result;
+    }
+
+    result = quick_cmd( "zip", "-r", "resources.zip", PACK_PATH, LOOSE_RESOURCES_DIR );
     if( result ) {
         cb_error( "Failed to zip resources!" );
         return result;
@@ -521,6 +553,276 @@ int mode_test( struct Args* args ) {
     return 0;
 }
 
+int mode_cook( struct Args* args ) {
+    bool is_forced = args->cook.is_forced;
+
+    struct Build* build = &args->build;
+    build->target = target_native();
+
+    String cc  = target_compiler( build->target );
+    String cpp = target_cpp_compiler( build->target );
+    String ar  = target_ar( build->target );
+
+    if( !process_in_path( cpp.cc ) ) {
+        cb_error( "%s is required!", cpp.cc );
+        return 1;
+    }
+
+    make_dirs( "vendor", local_fmt( "vendor/%s", target_to_string(build->target).cc ) );
+
+    if( !path_exists(
+        local_fmt("vendor/%s/libraylib.a", target_to_string(build->target).cc)
+    ) ) {
+        int result = build_dependency_raylib(
+            build->target, cc.cc, ar.cc );
+        if( result ) {
+            return result;
+        }
+    }
+
+    const char* cooker = NULL;
+    int result = 0;
+    switch( build->target ) {
+        case T_GNU_LINUX: {
+            make_dirs( "build", "build/linux" );
+            cooker = "./build/linux/bigmode-2025-cook";
+            result = quick_cmd( cpp.cc,
+                "cook/main.cpp", "-Iinclude", "-Iraylib/src", "-Wall", "-O2",
+                "-Lvendor/linux", "-l:libraylib.a",
+                "-lGL", "-lm", "-lpthread", "-ldl", "-lrt", "-lX11", "-static-libgcc",
+                "-o", cooker );
+        } break;
+        case T_WINDOWS: {
+            make_dirs( "build", "build/windows" );
+            cooker = "./build/windows/bigmode-2025-cook.exe";
+            result = quick_cmd( cpp.cc,
+                "cook/main.cpp", "-Iinclude", "-Iraylib/src", "-Wall", "-O2",
+                "-Lvendor/windows", "-l:libraylib.a", "-static-libgcc",
+                "-static", "-lgdi32", "-lwinmm",
+                "-lopengl32", "-lshell32", "-o", cooker );
+        } break;
+
+        case T_NATIVE:
+        case T_WEB:
+        case T_COUNT: unreachable();
+    }
+    if( result ) {
+        cb_error( "Failed to compile cooker!" );
+        return result;
+    }
+
+    if( is_forced ) {
+        return quick_cmd( cooker, "--force" );
+    }
+    return quick_cmd( cooker );
+}
+
+struct PackSource {
+    String   path;
+    uint64_t hash;
+    uint64_t size;
+};
+static int pack_source_cmp( const void* a, const void* b ) {
+    const struct PackSource* lhs = a;
+    const struct PackSource* rhs = b;
+    if( lhs->hash < rhs->hash ) {
+        return -1;
+    }
+    return lhs->hash > rhs->hash;
+}
+static uint64_t pack_align( uint64_t value ) {
+    return (value + (PACK_ALIGN - 1)) & ~(uint64_t)(PACK_ALIGN - 1);
+}
+static bool pack_write_padding( FILE* file, uint64_t from, uint64_t to ) {
+    static const uint8_t zero[PACK_ALIGN] = {};
+    return fwrite( zero, 1, to - from, file ) == to - from;
+}
+/// @brief Check if file should go into resource pack.
+/// Loose files and sources that have a cooked version are left out,
+/// game only reads cooked version of those.
+static bool pack_should_include( String path ) {
+    char normalized[512];
+    if( path.len >= sizeof(normalized) ) {
+        return true;
+    }
+    for( usize i = 0; i < path.len + 1; ++i ) {
+        normalized[i] = path.cc[i] == '\\' ? '/' : path.cc[i];
+    }
+
+    if( strncmp(
+        normalized, LOOSE_RESOURCES_DIR "/", sizeof(LOOSE_RESOURCES_DIR "/") - 1 ) == 0
+    ) {
+        return false;
+    }
+
+    char cooked[512];
+    // NOTE(alicia): streamed files used to be cooked, leftovers are never read.
+    if(
+        cooked_path( COOKED_STREAMED_DIR, "", cooked, sizeof(cooked) ) &&
+        strncmp( normalized, cooked, strlen( cooked ) ) == 0
+    ) {
+        return false;
+    }
+
+    const char* ext = cooked_ext( normalized );
+    if( !ext || !cooked_path( normalized, ext, cooked, sizeof(cooked) ) ) {
+        return true;
+    }
+    return !path_exists( cooked );
+}
+int mode_pack( struct Args* args ) {
+    unused(args);
+    f64 start = timer_milliseconds();
+
+    WalkDirectory wd = {};
+    if( !path_walk_dir( "resources", true, false, &wd ) ) {
+        cb_error( "Failed to walk resources directory!" );
+        return 1;
+    }
+
+    usize source_size = sizeof(struct PackSource) * (wd.count ? wd.count : 1);
+    struct PackSource* sources = memory_alloc( source_size );
+    if( !sources ) {
+        path_walk_free( &wd );
+        cb_error( "Failed to allocate pack sources!" );
+        return 1;
+    }
+
+    usize    source_count = 0;
+    uint64_t names_size   = 0;
+    for( usize i = 0; i < wd.count; ++i ) {
+        if( !pack_should_include( wd.paths[i] ) ) {
+            continue;
+        }
+        struct PackSource* source = sources + source_count++;
+        source->path = wd.paths[i];
+        source->hash = pack_hash( source->path.cc, source->path.len );
+
+        FILE* file = fopen( source->path.cc, "rb" );
+        if( !file ) {
+            cb_error( "Failed to open %s!", source->path.cc );
+            memory_free( sources, source_size );
+            path_walk_free( &wd );
+            return 1;
+        }
+        fseek( file, 0, SEEK_END );
+        source->size = (uint64_t)ftell( file );
+        fclose( file );
+
+        names_size += source->path.len + 1;
+    }
+
+    qsort( sources, source_count, sizeof(*sources), pack_source_cmp );
+
+    // NOTE(alicia): game looks files up by hash, two paths
+    // with the same hash would make lookups ambiguous.
+    for( usize i = 1; i < source_count; ++i ) {
+        if( sources[i].hash == sources[i - 1].hash ) {
+            cb_error(
+                "%s and %s have the same hash, rename one of them!",
+                sources[i - 1].path.cc, sources[i].path.cc );
+            memory_free( sources, source_size );
+            path_walk_free( &wd );
+            return 1;
+        }
+    }
+
+    struct PackHeader header = {};
+    memcpy( header.identifier, PACK_IDENTIFIER, 4 );
+    header.version      = PACK_VERSION;
+    header.entry_count  = (uint32_t)source_count;
+    header.names_offset = sizeof(header) + (sizeof(struct PackEntry) * source_count);
+
+    uint64_t offset = pack_align( header.names_offset + names_size );
+    header.total_size = offset;
+    for( usize i = 0; i < source_count; ++i ) {
+        header.total_size = pack_align( header.total_size + sources[i].size );
+    }
+
+    FILE* pack = fopen( PACK_PATH, "wb" );
+    if( !pack ) {
+        cb_error( "Failed to open " PACK_PATH " for writing!" );
+        memory_free( sources, source_size );
+        path_walk_free( &wd );
+        return 1;
+    }
+
+    bool success = fwrite( &header, sizeof(header), 1, pack ) == 1;
+
+    uint64_t name_offset = 0;
+    uint64_t data_offset = offset;
+    for( usize i = 0; success && i < source_count; ++i ) {
+        struct PackEntry entry = {};
+        entry.hash        = sources[i].hash;
+        entry.offset      = data_offset;
+        entry.size        = sources[i].size;
+        entry.name_offset = (uint32_t)name_offset;
+        entry.name_len    = (uint32_t)sources[i].path.len;
+
+        success = fwrite( &entry, sizeof(entry), 1, pack ) == 1;
+
+        name_offset += sources[i].path.len + 1;
+        data_offset  = pack_align( data_offset + sources[i].size );
+    }
+    for( usize i = 0; success && i < source_count; ++i ) {
+        // NOTE(alicia): game paths always use forward slashes.
+        for( usize c = 0; success && c < sources[i].path.len + 1; ++c ) {
+            char character = sources[i].path.cc[c];
+            if( character == '\\' ) {
+                character = '/';
+            }
+            success = fputc( character, pack ) != EOF;
+        }
+    }
+    if( success ) {
+        success = pack_write_padding( pack, header.names_offset + names_size, offset );
+    }
+
+    static uint8_t buffer[64 * 1024];
+    for( usize i = 0; success && i < source_count; ++i ) {
+        FILE* file = fopen( sources[i].path.cc, "rb" );
+        if( !file ) {
+            cb_error( "Failed to open %s!", sources[i].path.cc );
+            success = false;
+            break;
+        }
+
+        uint64_t remaining = sources[i].size;
+        while( success && remaining ) {
+            usize to_read = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+            if( fread( buffer, 1, to_read, file ) != to_read ) {
+                cb_error( "Failed to read %s!", sources[i].path.cc );
+                success = false;
+                break;
+            }
+            success    = fwrite( buffer, 1, to_read, pack ) == to_read;
+            remaining -= to_read;
+        }
+        fclose( file );
+
+        if( success ) {
+            success = pack_write_padding(
+                pack, sources[i].size, pack_align( sources[i].size ) );
+        }
+    }
+
+    fclose( pack );
+    memory_free( sources, source_size );
+    path_walk_free( &wd );
+
+    if( !success ) {
+        cb_error( "Failed to write " PACK_PATH "!" );
+        file_remove( PACK_PATH );
+        return 1;
+    }
+
+    f64 end = timer_milliseconds();
+    cb_info(
+        "Packed %u files (%.2fMB) into " PACK_PATH " in %fms",
+        header.entry_count, (f64)header.total_size / (1024.0 * 1024.0), end - start );
+    return 0;
+}
+
 int build_linux( const char* cpp, struct Build* build ) {
     make_dirs( "build", "build/linux" );
 
@@ -775,7 +1077,11 @@ int mode_help( struct Args* args ) {
             printf( "  -optimized        Optimize with -O2 rather than -O0\n" );
             printf( "  -strip-symbols    Strip debug symbols.\n" );
         } break;
+        case M_COOK: {
+            printf( "  -force            Cook every asset, even if it's up to date.\n" );
+        } break;
         case M_TEST:
+        case M_PACK:
         case M_PACKAGE:
         case M_EDITOR:
         case M_COUNT:   break;
@@ -791,6 +1097,8 @@ String mode_description( enum Mode mode ) {
         case M_PACKAGE: return string_text("Compile in Release mode and package for each platform (Windows,Linux and Web)");
         case M_EDITOR:  return string_text("Compile and run editor (native only).");
         case M_TEST:    return string_text("Compile and run quick test (linux only).");
+        case M_PACK:    return string_text("Pack resources directory into " PACK_PATH ".");
+        case M_COOK:    return string_text("Cook textures and audio into resources/cooked (native only).");
         case M_COUNT: unreachable();
     }
 }
@@ -802,6 +1110,8 @@ String mode_to_string( enum Mode mode ) {
         case M_PACKAGE: return string_text("package");
         case M_EDITOR:  return string_text("editor");
         case M_TEST:    return string_text("test");
+        case M_PACK:    return string_text("pack");
+        case M_COOK:    return string_text("cook");
         case M_COUNT: unreachable();
     }
 }
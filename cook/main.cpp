@@ -0,0 +1,151 @@
+/**
+ * @file   main.cpp
+ * @brief  Asset cooker.
+ * Converts textures to mipmapped RGBA and waves to 16-bit PCM
+ * so that game doesn't have to decode them at load time.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 08, 2025
+*/
+// IWYU pragma: begin_keep
+#include "raylib.h"
+
+#include "shared/cooked.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+// IWYU pragma: end_keep
+
+#define COOK_MAX_PATH (512)
+
+/// @brief Check if cooked file is missing or older than source.
+bool is_stale( const char* src, const char* dst ) {
+    if( !FileExists( dst ) ) {
+        return true;
+    }
+    return GetFileModTime( src ) > GetFileModTime( dst );
+}
+
+bool write_cooked(
+    const char* dst, const void* header, int header_size,
+    const void* data, int data_size
+) {
+    MakeDirectory( GetDirectoryPath( dst ) );
+
+    int   size   = header_size + data_size;
+    char* buffer = (char*)malloc( size );
+    if( !buffer ) {
+        return false;
+    }
+    memcpy( buffer, header, header_size );
+    memcpy( buffer + header_size, data, data_size );
+
+    bool result = SaveFileData( dst, buffer, size );
+    free( buffer );
+    return result;
+}
+
+bool cook_texture( const char* src, const char* dst ) {
+    Image image = LoadImage( src );
+    if( !image.data ) {
+        return false;
+    }
+    ImageFormat( &image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 );
+    ImageMipmaps( &image );
+
+    // NOTE(alicia): ImageMipmaps stores mip chain contiguously after base level.
+    int data_size = 0;
+    int width     = image.width;
+    int height    = image.height;
+    for( int i = 0; i < image.mipmaps; ++i ) {
+        data_size += GetPixelDataSize( width, height, image.format );
+        width  = width  > 1 ? width  / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    CookedTextureHeader header = {};
+    memcpy( header.identifier, COOKED_TEXTURE_IDENTIFIER, 4 );
+    header.version   = COOKED_VERSION;
+    header.width     = image.width;
+    header.height    = image.height;
+    header.mipmaps   = image.mipmaps;
+    header.format    = image.format;
+    header.data_size = data_size;
+
+    bool result = write_cooked( dst, &header, sizeof(header), image.data, data_size );
+    UnloadImage( image );
+    return result;
+}
+bool cook_wave( const char* src, const char* dst ) {
+    Wave wave = LoadWave( src );
+    if( !wave.data ) {
+        return false;
+    }
+    // NOTE(alicia): sample rate is left alone, device rate isn't known until runtime.
+    WaveFormat( &wave, wave.sampleRate, 16, wave.channels );
+
+    CookedWaveHeader header = {};
+    memcpy( header.identifier, COOKED_WAVE_IDENTIFIER, 4 );
+    header.version     = COOKED_VERSION;
+    header.frame_count = wave.frameCount;
+    header.sample_rate = wave.sampleRate;
+    header.sample_size = wave.sampleSize;
+    header.channels    = wave.channels;
+    header.data_size   = wave.frameCount * wave.channels * (wave.sampleSize / 8);
+
+    bool result = write_cooked( dst, &header, sizeof(header), wave.data, header.data_size );
+    UnloadWave( wave );
+    return result;
+}
+
+int main( int argc, char** argv ) {
+    SetTraceLogLevel( LOG_WARNING );
+
+    bool is_forced = false;
+    for( int i = 1; i < argc; ++i ) {
+        if( strcmp( argv[i], "--force" ) == 0 ) {
+            is_forced = true;
+        } else {
+            fprintf( stderr, "error: unrecognized argument '%s'!\n", argv[i] );
+            return 1;
+        }
+    }
+
+    FilePathList files = LoadDirectoryFilesEx( "resources", ".png;.jpg;.wav", true );
+
+    int cooked  = 0;
+    int skipped = 0;
+    int failed  = 0;
+    for( unsigned int i = 0; i < files.count; ++i ) {
+        const char* src = files.paths[i];
+        const char* ext = cooked_ext( src );
+        if( !ext ) {
+            continue;
+        }
+        bool is_wave = strcmp( ext, COOKED_WAVE_EXT ) == 0;
+
+        char dst[COOK_MAX_PATH];
+        if( !cooked_path( src, ext, dst, sizeof(dst) ) ) {
+            fprintf( stderr, "error: path '%s' is too long!\n", src );
+            failed++;
+            continue;
+        }
+
+        if( !is_forced && !is_stale( src, dst ) ) {
+            skipped++;
+            continue;
+        }
+
+        bool result = is_wave ? cook_wave( src, dst ) : cook_texture( src, dst );
+        if( result ) {
+            printf( "cooked %s -> %s\n", src, dst );
+            cooked++;
+        } else {
+            fprintf( stderr, "error: failed to cook '%s'!\n", src );
+            failed++;
+        }
+    }
+    UnloadDirectoryFiles( files );
+
+    printf( "cooked %i, up to date %i, failed %i\n", cooked, skipped, failed );
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,371 @@
+#if !defined(EDITOR_GENERATE_H)
+#define EDITOR_GENERATE_H
+/**
+ * @file   generate.h
+ * @brief  Procedural map generator.
+ * Used to make large maps for benchmarking collision, AI and rendering.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 09, 2025
+*/
+// IWYU pragma: begin_keep
+#include "editor/map.h"
+#include "shared/buffer.h"
+#include "raymath.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// IWYU pragma: end_keep
+
+#define MAP_GENERATE_MIN_CELLS         (2)
+#define MAP_GENERATE_MAX_CELLS         (256)
+#define MAP_GENERATE_DEFAULT_CELL_SIZE (8.0f)
+
+enum class GenerateKind {
+    MAZE,
+    ARENA,
+
+    COUNT
+};
+inline
+const char* to_string( GenerateKind kind ) {
+    switch( kind ) {
+        case GenerateKind::MAZE:  return "Maze";
+        case GenerateKind::ARENA: return "Arena";
+        case GenerateKind::COUNT: break;
+    }
+    return "";
+}
+
+struct GenerateSettings {
+    GenerateKind   kind;
+    int            width;
+    int            height;
+    float          cell_size;
+    int            enemy_count;
+    int            battery_count;
+    uint32_t       seed;
+    LevelCondition condition;
+};
+
+inline
+GenerateSettings generate_default_settings() {
+    GenerateSettings result = {};
+    result.kind          = GenerateKind::MAZE;
+    result.width         = 16;
+    result.height        = 16;
+    result.cell_size     = MAP_GENERATE_DEFAULT_CELL_SIZE;
+    result.enemy_count   = 8;
+    result.battery_count = 8;
+    result.seed          = 1;
+    result.condition     = LevelCondition::DEFEAT_ENEMIES_AND_COLLECT_BATTERIES;
+    return result;
+}
+
+// NOTE(alicia): own generator instead of GetRandomValue so that
+// same seed gives same map on every platform and in headless mode.
+struct GenerateRandom {
+    uint32_t state;
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    /// @brief Random integer in [0, max).
+    int range( int max ) {
+        return max > 0 ? (int)(next() % (uint32_t)max) : 0;
+    }
+    /// @brief Random float in [0, 1).
+    float unit() {
+        return (float)(next() >> 8) / (float)(1 << 24);
+    }
+};
+
+struct GenerateGrid {
+    int     width;
+    int     height;
+    float   cell_size;
+    Vector2 origin;
+
+    // NOTE(alicia): lattice point -> vertex index, -1 if unused.
+    int* lattice;
+
+    Vector2 lattice_position( int x, int y ) {
+        return origin + Vector2{ x * cell_size, y * cell_size };
+    }
+    Vector2 cell_center( int cell ) {
+        int x = cell % width;
+        int y = cell / width;
+        return origin + Vector2{ (x + 0.5f) * cell_size, (y + 0.5f) * cell_size };
+    }
+};
+
+inline
+int generate_lattice_vertex( MapStorage* storage, GenerateGrid* grid, int x, int y ) {
+    int* index = grid->lattice + (y * (grid->width + 1)) + x;
+    if( *index < 0 ) {
+        *index = storage->vertexes.len;
+        buf_append( &storage->vertexes, grid->lattice_position( x, y ) );
+    }
+    return *index;
+}
+inline
+void generate_segment( MapStorage* storage, int start, int end ) {
+    EdSegment segment = {};
+    segment.start = start;
+    segment.end   = end;
+    segment.tint  = WHITE;
+    buf_append( &storage->segments, segment );
+}
+inline
+void generate_object( MapStorage* storage, ObjectType type, Vector2 position, LevelCondition condition ) {
+    EdObject object = {};
+    object.position = position;
+    object.type     = type;
+    if( type == ObjectType::LEVEL_EXIT ) {
+        object.level_exit.condition = condition;
+    }
+    buf_append( &storage->objects, object );
+}
+
+/// @brief Emit walls along lattice lines, merging straight runs into one segment.
+/// horizontal has (height + 1) * width entries, vertical has (width + 1) * height.
+inline
+void generate_walls(
+    MapStorage* storage, GenerateGrid* grid,
+    const bool* horizontal, const bool* vertical
+) {
+    for( int y = 0; y <= grid->height; ++y ) {
+        int run_start = -1;
+        for( int x = 0; x <= grid->width; ++x ) {
+            bool is_wall = x < grid->width && horizontal[(y * grid->width) + x];
+            if( is_wall && run_start < 0 ) {
+                run_start = x;
+            } else if( !is_wall && run_start >= 0 ) {
+                generate_segment(
+                    storage,
+                    generate_lattice_vertex( storage, grid, run_start, y ),
+                    generate_lattice_vertex( storage, grid, x, y ) );
+                run_start = -1;
+            }
+        }
+    }
+    for( int x = 0; x <= grid->width; ++x ) {
+        int run_start = -1;
+        for( int y = 0; y <= grid->height; ++y ) {
+            bool is_wall = y < grid->height && vertical[(x * grid->height) + y];
+            if( is_wall && run_start < 0 ) {
+                run_start = y;
+            } else if( !is_wall && run_start >= 0 ) {
+                generate_segment(
+                    storage,
+                    generate_lattice_vertex( storage, grid, x, run_start ),
+                    generate_lattice_vertex( storage, grid, x, y ) );
+                run_start = -1;
+            }
+        }
+    }
+}
+
+/// @brief Carve a maze with randomized depth first search,
+/// then knock out extra walls so there's more than one route through it.
+inline
+void generate_maze( MapStorage* storage, GenerateGrid* grid, GenerateRandom* rng ) {
+    int w = grid->width;
+    int h = grid->height;
+
+    bool* horizontal = (bool*)malloc( sizeof(bool) * (h + 1) * w );
+    bool* vertical   = (bool*)malloc( sizeof(bool) * (w + 1) * h );
+    bool* visited    = (bool*)calloc( w * h, sizeof(bool) );
+    int*  stack      = (int*)malloc( sizeof(int) * w * h );
+    for( int i = 0; i < (h + 1) * w; ++i ) {
+        horizontal[i] = true;
+    }
+    for( int i = 0; i < (w + 1) * h; ++i ) {
+        vertical[i] = true;
+    }
+
+    int stack_len = 0;
+    stack[stack_len++] = 0;
+    visited[0] = true;
+    while( stack_len ) {
+        int cell = stack[stack_len - 1];
+        int x    = cell % w;
+        int y    = cell / w;
+
+        int neighbors[4];
+        int neighbor_count = 0;
+        if( x > 0     && !visited[cell - 1] ) neighbors[neighbor_count++] = cell - 1;
+        if( x < w - 1 && !visited[cell + 1] ) neighbors[neighbor_count++] = cell + 1;
+        if( y > 0     && !visited[cell - w] ) neighbors[neighbor_count++] = cell - w;
+        if( y < h - 1 && !visited[cell + w] ) neighbors[neighbor_count++] = cell + w;
+
+        if( !neighbor_count ) {
+            stack_len--;
+            continue;
+        }
+
+        int next = neighbors[rng->range( neighbor_count )];
+        if( next == cell - 1 ) {
+            vertical[(x * h) + y] = false;
+        } else if( next == cell + 1 ) {
+            vertical[((x + 1) * h) + y] = false;
+        } else if( next == cell - w ) {
+            horizontal[(y * w) + x] = false;
+        } else {
+            horizontal[((y + 1) * w) + x] = false;
+        }
+
+        visited[next] = true;
+        stack[stack_len++] = next;
+    }
+
+    int extra = (w * h) / 10;
+    for( int i = 0; i < extra; ++i ) {
+        if( rng->range( 2 ) ) {
+            int x = 1 + rng->range( w - 1 );
+            vertical[(x * h) + rng->range( h )] = false;
+        } else {
+            int y = 1 + rng->range( h - 1 );
+            horizontal[(y * w) + rng->range( w )] = false;
+        }
+    }
+
+    generate_walls( storage, grid, horizontal, vertical );
+
+    free( horizontal );
+    free( vertical );
+    free( visited );
+    free( stack );
+}
+
+/// @brief Open room with square pillars scattered through it.
+/// @param[out] out_blocked Cells that objects can't be placed in.
+inline
+void generate_arena(
+    MapStorage* storage, GenerateGrid* grid, GenerateRandom* rng, bool* out_blocked
+) {
+    int w = grid->width;
+    int h = grid->height;
+
+    bool* horizontal = (bool*)calloc( (h + 1) * w, sizeof(bool) );
+    bool* vertical   = (bool*)calloc( (w + 1) * h, sizeof(bool) );
+    for( int x = 0; x < w; ++x ) {
+        horizontal[x]           = true;
+        horizontal[(h * w) + x] = true;
+    }
+    for( int y = 0; y < h; ++y ) {
+        vertical[y]           = true;
+        vertical[(w * h) + y] = true;
+    }
+    generate_walls( storage, grid, horizontal, vertical );
+    free( horizontal );
+    free( vertical );
+
+    float half = grid->cell_size * 0.2f;
+    for( int cell = 0; cell < w * h; ++cell ) {
+        // NOTE(alicia): spawn and exit cells are always open.
+        if( cell == 0 || cell == (w * h) - 1 || rng->unit() > 0.2f ) {
+            continue;
+        }
+        out_blocked[cell] = true;
+
+        Vector2 center = grid->cell_center( cell );
+        Vector2 corners[] = {
+            center + Vector2{ -half, -half },
+            center + Vector2{  half, -half },
+            center + Vector2{  half,  half },
+            center + Vector2{ -half,  half },
+        };
+        int first = storage->vertexes.len;
+        for( int i = 0; i < 4; ++i ) {
+            buf_append( &storage->vertexes, corners[i] );
+        }
+        for( int i = 0; i < 4; ++i ) {
+            generate_segment( storage, first + i, first + ((i + 1) % 4) );
+        }
+    }
+}
+
+/// @brief Replace contents of storage with generated map.
+/// Player spawns in first cell, level exit is placed in opposite corner.
+inline
+void map_generate( MapStorage* storage, const GenerateSettings* settings ) {
+    storage->objects.len  = 0;
+    storage->vertexes.len = 0;
+    storage->segments.len = 0;
+
+    GenerateGrid grid = {};
+    grid.width     = Clamp( settings->width,  MAP_GENERATE_MIN_CELLS, MAP_GENERATE_MAX_CELLS );
+    grid.height    = Clamp( settings->height, MAP_GENERATE_MIN_CELLS, MAP_GENERATE_MAX_CELLS );
+    grid.cell_size =
+        settings->cell_size > 0.0f ? settings->cell_size : MAP_GENERATE_DEFAULT_CELL_SIZE;
+    grid.origin = Vector2{ grid.width * grid.cell_size, grid.height * grid.cell_size } * -0.5f;
+
+    int lattice_count = (grid.width + 1) * (grid.height + 1);
+    int cell_count    = grid.width * grid.height;
+
+    grid.lattice = (int*)malloc( sizeof(int) * lattice_count );
+    for( int i = 0; i < lattice_count; ++i ) {
+        grid.lattice[i] = -1;
+    }
+    bool* blocked = (bool*)calloc( cell_count, sizeof(bool) );
+
+    GenerateRandom rng = {};
+    // NOTE(alicia): xorshift gets stuck on zero.
+    rng.state = settings->seed ? settings->seed : 0x9E3779B9;
+
+    switch( settings->kind ) {
+        case GenerateKind::MAZE: {
+            generate_maze( storage, &grid, &rng );
+        } break;
+        case GenerateKind::ARENA: {
+            generate_arena( storage, &grid, &rng, blocked );
+        } break;
+        case GenerateKind::COUNT: break;
+    }
+
+    int spawn_cell = 0;
+    int exit_cell  = cell_count - 1;
+    generate_object(
+        storage, ObjectType::PLAYER_SPAWN, grid.cell_center( spawn_cell ), settings->condition );
+    generate_object(
+        storage, ObjectType::LEVEL_EXIT, grid.cell_center( exit_cell ), settings->condition );
+
+    int* free_cells = (int*)malloc( sizeof(int) * cell_count );
+    int  free_count = 0;
+    for( int cell = 0; cell < cell_count; ++cell ) {
+        if( cell != spawn_cell && cell != exit_cell && !blocked[cell] ) {
+            free_cells[free_count++] = cell;
+        }
+    }
+    for( int i = free_count - 1; i > 0; --i ) {
+        int j = rng.range( i + 1 );
+        int t = free_cells[i];
+        free_cells[i] = free_cells[j];
+        free_cells[j] = t;
+    }
+
+    // NOTE(alicia): once every cell is taken, objects share cells
+    // and get jittered so they don't sit on top of each other.
+    int total = settings->enemy_count + settings->battery_count;
+    for( int i = 0; free_count && i < total; ++i ) {
+        ObjectType type =
+            i < settings->enemy_count ? ObjectType::ENEMY : ObjectType::BATTERY;
+
+        Vector2 position = grid.cell_center( free_cells[i % free_count] );
+        if( i >= free_count ) {
+            float jitter = grid.cell_size * 0.3f;
+            position.x += (rng.unit() - 0.5f) * 2.0f * jitter;
+            position.y += (rng.unit() - 0.5f) * 2.0f * jitter;
+        }
+        generate_object( storage, type, position, settings->condition );
+    }
+
+    free( free_cells );
+    free( blocked );
+    free( grid.lattice );
+}
+
+#endif /* header guard */
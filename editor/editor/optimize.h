@@ -0,0 +1,375 @@
+#if !defined(EDITOR_OPTIMIZE_H)
+#define EDITOR_OPTIMIZE_H
+/**
+ * @file   optimize.h
+ * @brief  Map geometry optimizer.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 09, 2025
+*/
+// IWYU pragma: begin_keep
+#include "editor/map.h"
+#include "raymath.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// IWYU pragma: end_keep
+
+#define MAP_OPTIMIZE_DEFAULT_WELD_DISTANCE (0.01f)
+// NOTE(alicia): sine of largest angle between two segments
+// that still counts as collinear.
+#define MAP_OPTIMIZE_COLLINEAR_EPSILON     (0.001f)
+
+struct MapOptimizeStats {
+    int vertexes_before;
+    int vertexes_after;
+    int segments_before;
+    int segments_after;
+
+    int welded;
+    int degenerate;
+    int duplicate;
+    int merged;
+};
+
+inline
+uint64_t map_optimize_cell_key( int x, int y ) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+inline
+uint64_t map_optimize_hash( uint64_t key ) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/// @brief Spread bits of 16-bit value to even bits.
+inline
+uint32_t map_optimize_morton_spread( uint32_t v ) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+inline
+uint32_t map_optimize_morton( Vector2 point, Vector2 min, Vector2 inv_extent ) {
+    Vector2 t = (point - min) * inv_extent;
+    uint32_t x = (uint32_t)(Clamp( t.x, 0.0f, 1.0f ) * 65535.0f);
+    uint32_t y = (uint32_t)(Clamp( t.y, 0.0f, 1.0f ) * 65535.0f);
+    return map_optimize_morton_spread( x ) | (map_optimize_morton_spread( y ) << 1);
+}
+
+struct MapOptimizeSortItem {
+    uint32_t key;
+    int      index;
+};
+inline
+int map_optimize_sort_cmp( const void* a, const void* b ) {
+    auto* lhs = (const MapOptimizeSortItem*)a;
+    auto* rhs = (const MapOptimizeSortItem*)b;
+    if( lhs->key != rhs->key ) {
+        return lhs->key < rhs->key ? -1 : 1;
+    }
+    // NOTE(alicia): keeps sort stable so output is deterministic.
+    return lhs->index - rhs->index;
+}
+
+/// @brief Weld vertexes closer than weld_distance with a spatial hash.
+/// @return Number of vertexes that were welded into another.
+inline
+int map_optimize_weld( MapStorage* storage, float weld_distance, int* out_remap ) {
+    int count = storage->vertexes.len;
+
+    int table_cap = 16;
+    while( table_cap < count * 2 ) {
+        table_cap *= 2;
+    }
+    // NOTE(alicia): open addressing, key -> first representative in cell.
+    uint64_t* keys  = (uint64_t*)malloc( sizeof(uint64_t) * table_cap );
+    int*      heads = (int*)malloc( sizeof(int) * table_cap );
+    int*      next  = (int*)malloc( sizeof(int) * (count ? count : 1) );
+    for( int i = 0; i < table_cap; ++i ) {
+        heads[i] = -1;
+    }
+
+    float cell_size = weld_distance > 0.0f ? weld_distance : MAP_OPTIMIZE_DEFAULT_WELD_DISTANCE;
+    float dist_sqr  = weld_distance * weld_distance;
+
+    int welded = 0;
+    for( int i = 0; i < count; ++i ) {
+        Vector2 v  = storage->vertexes.buf[i];
+        int     cx = (int)floorf( v.x / cell_size );
+        int     cy = (int)floorf( v.y / cell_size );
+
+        int found = -1;
+        for( int y = cy - 1; found < 0 && y <= cy + 1; ++y ) {
+            for( int x = cx - 1; found < 0 && x <= cx + 1; ++x ) {
+                uint64_t key  = map_optimize_cell_key( x, y );
+                uint64_t slot = map_optimize_hash( key ) & (table_cap - 1);
+                while( heads[slot] >= 0 && keys[slot] != key ) {
+                    slot = (slot + 1) & (table_cap - 1);
+                }
+                for( int rep = heads[slot]; rep >= 0; rep = next[rep] ) {
+                    if( Vector2DistanceSqr( storage->vertexes.buf[rep], v ) <= dist_sqr ) {
+                        found = rep;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if( found >= 0 ) {
+            out_remap[i] = found;
+            welded++;
+            continue;
+        }
+
+        out_remap[i] = i;
+        uint64_t key  = map_optimize_cell_key( cx, cy );
+        uint64_t slot = map_optimize_hash( key ) & (table_cap - 1);
+        while( heads[slot] >= 0 && keys[slot] != key ) {
+            slot = (slot + 1) & (table_cap - 1);
+        }
+        keys[slot] = key;
+        next[i]    = heads[slot];
+        heads[slot] = i;
+    }
+
+    free( keys );
+    free( heads );
+    free( next );
+    return welded;
+}
+
+/// @brief Weld vertexes, drop degenerate and duplicate segments,
+/// merge collinear runs and sort geometry in Morton order.
+/// Objects aren't touched.
+inline
+MapOptimizeStats map_optimize( MapStorage* storage, float weld_distance ) {
+    MapOptimizeStats stats = {};
+    stats.vertexes_before = storage->vertexes.len;
+    stats.segments_before = storage->segments.len;
+
+    int vertex_count  = storage->vertexes.len;
+    int segment_count = storage->segments.len;
+    int alloc_count   = (vertex_count > segment_count ? vertex_count : segment_count) + 1;
+
+    int* remap = (int*)malloc( sizeof(int) * alloc_count );
+    stats.welded = map_optimize_weld( storage, weld_distance, remap );
+
+    /* Remap segments and drop degenerates and duplicates. */ {
+        int table_cap = 16;
+        while( table_cap < segment_count * 2 ) {
+            table_cap *= 2;
+        }
+        // NOTE(alicia): open addressing set of (min, max) vertex pairs,
+        // all bits set marks an empty slot.
+        uint64_t* pairs = (uint64_t*)malloc( sizeof(uint64_t) * table_cap );
+        memset( pairs, 0xFF, sizeof(uint64_t) * table_cap );
+
+        int len = 0;
+        for( int i = 0; i < segment_count; ++i ) {
+            EdSegment s = storage->segments.buf[i];
+            s.start = remap[s.start];
+            s.end   = remap[s.end];
+
+            if( s.start == s.end ) {
+                stats.degenerate++;
+                continue;
+            }
+
+            uint64_t key = s.start < s.end ?
+                map_optimize_cell_key( s.start, s.end ) :
+                map_optimize_cell_key( s.end, s.start );
+            uint64_t slot = map_optimize_hash( key ) & (table_cap - 1);
+            while( pairs[slot] != UINT64_MAX && pairs[slot] != key ) {
+                slot = (slot + 1) & (table_cap - 1);
+            }
+            if( pairs[slot] == key ) {
+                stats.duplicate++;
+                continue;
+            }
+            pairs[slot] = key;
+
+            storage->segments.buf[len++] = s;
+        }
+        segment_count = storage->segments.len = len;
+
+        free( pairs );
+    }
+
+    /* Merge collinear runs through vertexes shared by exactly two segments. */ {
+        int* degree = (int*)calloc( alloc_count, sizeof(int) );
+        int* first  = (int*)malloc( sizeof(int) * alloc_count );
+        int* second = (int*)malloc( sizeof(int) * alloc_count );
+        bool* is_removed = (bool*)calloc( segment_count + 1, sizeof(bool) );
+
+        bool changed = true;
+        while( changed ) {
+            changed = false;
+
+            for( int i = 0; i < vertex_count; ++i ) {
+                degree[i] = 0;
+                first[i]  = second[i] = -1;
+            }
+            for( int i = 0; i < segment_count; ++i ) {
+                if( is_removed[i] ) {
+                    continue;
+                }
+                EdSegment* s = storage->segments.buf + i;
+                int ends[2] = { s->start, s->end };
+                for( int e = 0; e < 2; ++e ) {
+                    int v = ends[e];
+                    if( degree[v] == 0 ) {
+                        first[v] = i;
+                    } else if( degree[v] == 1 ) {
+                        second[v] = i;
+                    }
+                    degree[v]++;
+                }
+            }
+
+            for( int v = 0; v < vertex_count; ++v ) {
+                if( degree[v] != 2 ) {
+                    continue;
+                }
+                int a_index = first[v];
+                int b_index = second[v];
+                if( is_removed[a_index] || is_removed[b_index] ) {
+                    continue;
+                }
+
+                EdSegment* a = storage->segments.buf + a_index;
+                EdSegment* b = storage->segments.buf + b_index;
+
+                int a_other = a->start == v ? a->end : a->start;
+                int b_other = b->start == v ? b->end : b->start;
+                if( a_other == b_other ) {
+                    continue;
+                }
+
+                Vector2 center = storage->vertexes.buf[v];
+                Vector2 to_a   = Vector2Normalize( storage->vertexes.buf[a_other] - center );
+                Vector2 to_b   = Vector2Normalize( storage->vertexes.buf[b_other] - center );
+
+                // NOTE(alicia): collinear and on opposite sides of shared vertex.
+                float cross = (to_a.x * to_b.y) - (to_a.y * to_b.x);
+                if(
+                    fabsf( cross ) > MAP_OPTIMIZE_COLLINEAR_EPSILON ||
+                    Vector2DotProduct( to_a, to_b ) > 0.0f
+                ) {
+                    continue;
+                }
+
+                // NOTE(alicia): keep winding of first segment.
+                if( a->start == v ) {
+                    a->start = b_other;
+                } else {
+                    a->end = b_other;
+                }
+                is_removed[b_index] = true;
+                stats.merged++;
+                changed = true;
+            }
+        }
+
+        int len = 0;
+        for( int i = 0; i < segment_count; ++i ) {
+            if( !is_removed[i] ) {
+                storage->segments.buf[len++] = storage->segments.buf[i];
+            }
+        }
+        segment_count = storage->segments.len = len;
+
+        free( degree );
+        free( first );
+        free( second );
+        free( is_removed );
+    }
+
+    Vector2 min = {}, max = {};
+    for( int i = 0; i < vertex_count; ++i ) {
+        Vector2 v = storage->vertexes.buf[i];
+        if( i == 0 ) {
+            min = max = v;
+            continue;
+        }
+        min = Vector2Min( min, v );
+        max = Vector2Max( max, v );
+    }
+    Vector2 extent     = max - min;
+    Vector2 inv_extent = {
+        extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+        extent.y > 0.0f ? 1.0f / extent.y : 0.0f };
+
+    /* Drop unreferenced vertexes and sort the rest in Morton order. */ {
+        bool* is_used = (bool*)calloc( alloc_count, sizeof(bool) );
+        for( int i = 0; i < segment_count; ++i ) {
+            is_used[storage->segments.buf[i].start] = true;
+            is_used[storage->segments.buf[i].end]   = true;
+        }
+
+        MapOptimizeSortItem* items =
+            (MapOptimizeSortItem*)malloc( sizeof(MapOptimizeSortItem) * alloc_count );
+        int used_count = 0;
+        for( int i = 0; i < vertex_count; ++i ) {
+            if( !is_used[i] ) {
+                continue;
+            }
+            items[used_count].key   =
+                map_optimize_morton( storage->vertexes.buf[i], min, inv_extent );
+            items[used_count].index = i;
+            used_count++;
+        }
+        qsort( items, used_count, sizeof(*items), map_optimize_sort_cmp );
+
+        EdVertex* sorted = (EdVertex*)malloc( sizeof(EdVertex) * alloc_count );
+        for( int i = 0; i < used_count; ++i ) {
+            sorted[i]             = storage->vertexes.buf[items[i].index];
+            remap[items[i].index] = i;
+        }
+        memcpy( storage->vertexes.buf, sorted, sizeof(EdVertex) * used_count );
+        vertex_count = storage->vertexes.len = used_count;
+
+        for( int i = 0; i < segment_count; ++i ) {
+            storage->segments.buf[i].start = remap[storage->segments.buf[i].start];
+            storage->segments.buf[i].end   = remap[storage->segments.buf[i].end];
+        }
+
+        free( sorted );
+        free( items );
+        free( is_used );
+    }
+
+    /* Sort segments by Morton order of their midpoints. */ {
+        MapOptimizeSortItem* items =
+            (MapOptimizeSortItem*)malloc( sizeof(MapOptimizeSortItem) * alloc_count );
+        for( int i = 0; i < segment_count; ++i ) {
+            EdSegment* s = storage->segments.buf + i;
+            Vector2 mid  = Vector2Lerp(
+                storage->vertexes.buf[s->start], storage->vertexes.buf[s->end], 0.5f );
+            items[i].key   = map_optimize_morton( mid, min, inv_extent );
+            items[i].index = i;
+        }
+        qsort( items, segment_count, sizeof(*items), map_optimize_sort_cmp );
+
+        EdSegment* sorted = (EdSegment*)malloc( sizeof(EdSegment) * alloc_count );
+        for( int i = 0; i < segment_count; ++i ) {
+            sorted[i] = storage->segments.buf[items[i].index];
+        }
+        memcpy( storage->segments.buf, sorted, sizeof(EdSegment) * segment_count );
+
+        free( sorted );
+        free( items );
+    }
+
+    free( remap );
+
+    stats.vertexes_after = storage->vertexes.len;
+    stats.segments_after = storage->segments.len;
+    return stats;
+}
+
+#endif /* header guard */
@@ -12,7 +12,10 @@
 
 #include "shared/level.h"
 #include "shared/world.h"
+#include "shared/map_accel.h"
 #include "editor/map.h"
+#include "editor/optimize.h"
+#include "editor/generate.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -52,6 +55,7 @@ int mode_key( Mode mode );
 const char* collate_modes();
 const char* collate_objects();
 const char* collate_level_conditions();
+const char* collate_generate_kinds();
 
 enum class SelectionType {
     NONE,
@@ -120,6 +124,7 @@ enum FileMode {
     NONE,
     SAVING,
     LOADING,
+    GENERATING,
 };
 
 struct State {
@@ -130,6 +135,22 @@ struct State {
     FileMode file_mode;
     GuiWindowFileDialogState file_dialog_state;
 
+    struct {
+        GenerateSettings settings;
+
+        int kind;
+        int condition;
+        int seed;
+
+        bool kind_edit;
+        bool condition_edit;
+        bool width_edit;
+        bool height_edit;
+        bool enemy_edit;
+        bool battery_edit;
+        bool seed_edit;
+    } generate;
+
     struct {
         char* buf;
         int   len;
@@ -200,8 +221,26 @@ Vector2 round( Vector2 v );
 void hover_items( State& state, Vector2 mouse_world_position );
 void set_mode( State& state, Mode mode );
 void save_map( State& state, const char* path );
-void load_map( State& state, const char* path );
-int main() {
+bool load_map( State& state, const char* path );
+/// @brief Load and resave maps without opening a window.
+/// Rebuilds their acceleration data and upgrades them to current version.
+int bake_maps( int count, char** paths );
+/// @brief Weld, merge and sort map geometry without opening a window.
+/// Optimized maps are saved in place.
+int optimize_maps( int count, char** paths );
+/// @brief Generate a map without opening a window.
+int generate_map( int argc, char** argv );
+int main( int argc, char** argv ) {
+    if( argc > 1 && strcmp( argv[1], "--bake" ) == 0 ) {
+        return bake_maps( argc - 2, argv + 2 );
+    }
+    if( argc > 1 && strcmp( argv[1], "--optimize" ) == 0 ) {
+        return optimize_maps( argc - 2, argv + 2 );
+    }
+    if( argc > 1 && strcmp( argv[1], "--generate" ) == 0 ) {
+        return generate_map( argc - 2, argv + 2 );
+    }
+
     InitWindow( DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT, "BIGMODE Game Jam 2025 - Editor" );
     SetExitKey( KEY_NULL );
 
@@ -234,6 +273,12 @@ int main() {
     const char* modes = collate_modes();
     const char* object_sc_list = collate_objects();
     const char* level_condition_list = collate_level_conditions();
+    const char* generate_kind_list   = collate_generate_kinds();
+
+    state.generate.settings  = generate_default_settings();
+    state.generate.kind      = (int)state.generate.settings.kind;
+    state.generate.condition = (int)state.generate.settings.condition;
+    state.generate.seed      = (int)state.generate.settings.seed;
 
     set_mode( state, Mode::SELECT );
 
@@ -815,6 +860,12 @@ int main() {
 
             button.x += button.width + GUI_GUTTER;
 
+            if( GuiButton( button, "Generate" ) ) {
+                state.file_mode = FileMode::GENERATING;
+            }
+
+            button.x += button.width + GUI_GUTTER;
+
             if( GuiButton( button, "Test" ) ) {
                 const char* test_map = "resources/maps/__test__.map";
                 save_map( state, test_map );
@@ -1174,7 +1225,7 @@ int main() {
                 diag->windowActive = false;
             }
 
-        } else {
+        } else if( state.file_mode == FileMode::LOADING ) {
             auto* diag = &state.file_dialog_state;
             diag->windowActive = true;
             diag->saveFileMode = false;
@@ -1193,6 +1244,99 @@ int main() {
                 diag->windowActive = false;
             }
 
+        } else {
+            auto* gen = &state.generate;
+
+            Rectangle window = {
+                (scr_width  / 2.0f) - (400 / 2.0f),
+                (scr_height / 2.0f) - (300 / 2.0f),
+                400.0f, 300.0f
+            };
+            bool is_closed = GuiWindowBox( window, "Generate Map" );
+
+            Rectangle setting = window;
+            setting.x      += GUI_GUTTER;
+            setting.y      += TOP_PANEL_HEIGHT + GUI_GUTTER;
+            setting.width  -= GUI_GUTTER * 2.0;
+            setting.height  = 24.0;
+
+            float     label_width = MeasureTextEx( font, "Batteries", FONT_SIZE, 1.0 ).x + GUI_GUTTER;
+            Rectangle input       = setting;
+            input.x     += label_width;
+            input.width -= label_width;
+
+            // NOTE(alicia): dropdowns are drawn after everything else
+            // so that their open list isn't covered by controls below them.
+            Rectangle kind_input = input;
+            GuiLabel( setting, "Kind" );
+            setting.y += setting.height + GUI_GUTTER;
+            input.y    = setting.y;
+
+            #define GENERATE_SPINNER( label, value, min, max, edit ) do {\
+                GuiLabel( setting, label );\
+                if( GuiSpinner( input, "", value, min, max, edit ) ) {\
+                    edit = !edit;\
+                }\
+                setting.y += setting.height + GUI_GUTTER;\
+                input.y    = setting.y;\
+            } while(0)
+
+            GENERATE_SPINNER(
+                "Width", &gen->settings.width,
+                MAP_GENERATE_MIN_CELLS, MAP_GENERATE_MAX_CELLS, gen->width_edit );
+            GENERATE_SPINNER(
+                "Height", &gen->settings.height,
+                MAP_GENERATE_MIN_CELLS, MAP_GENERATE_MAX_CELLS, gen->height_edit );
+            GENERATE_SPINNER(
+                "Enemies", &gen->settings.enemy_count, 0, 4096, gen->enemy_edit );
+            GENERATE_SPINNER(
+                "Batteries", &gen->settings.battery_count, 0, 4096, gen->battery_edit );
+
+            #undef GENERATE_SPINNER
+
+            GuiLabel( setting, "Seed" );
+            if( GuiValueBox( input, "", &gen->seed, 0, INT32_MAX, gen->seed_edit ) ) {
+                gen->seed_edit = !gen->seed_edit;
+            }
+            setting.y += setting.height + GUI_GUTTER;
+            input.y    = setting.y;
+
+            Rectangle condition_input = input;
+            GuiLabel( setting, "Condition" );
+            setting.y += setting.height + GUI_GUTTER;
+
+            Rectangle button = setting;
+            button.width = (setting.width / 2.0) - (GUI_GUTTER / 2.0);
+            bool is_generate_pressed = GuiButton( button, "Generate" );
+            button.x += button.width + GUI_GUTTER;
+            bool is_cancel_pressed = GuiButton( button, "Cancel" );
+
+            if( GuiDropdownBox(
+                condition_input, level_condition_list, &gen->condition, gen->condition_edit
+            ) ) {
+                gen->condition_edit = !gen->condition_edit;
+            }
+            if( GuiDropdownBox( kind_input, generate_kind_list, &gen->kind, gen->kind_edit ) ) {
+                gen->kind_edit = !gen->kind_edit;
+            }
+
+            if( is_generate_pressed && !(gen->kind_edit || gen->condition_edit) ) {
+                gen->settings.kind      = (GenerateKind)gen->kind;
+                gen->settings.condition = (LevelCondition)gen->condition;
+                gen->settings.seed      = (uint32_t)gen->seed;
+
+                map_generate( &state.storage, &gen->settings );
+                set_mode( state, Mode::SELECT );
+
+                // NOTE(alicia): generated map shouldn't overwrite map it replaced.
+                free( state.path.buf );
+                state.path = {};
+                SetWindowTitle( "BIGMODE Game Jam 2025 - Editor" );
+
+                state.file_mode = FileMode::NONE;
+            } else if( is_cancel_pressed || is_closed ) {
+                state.file_mode = FileMode::NONE;
+            }
         }
 
         EndDrawing();
@@ -1209,20 +1353,44 @@ void save_map( State& state, const char* p ) {
 
     auto* st = &state.storage;
 
-    uint32_t size = sizeof(MapFileHeader) +
-        (sizeof(MapFileObject) * st->objects.len) +
-        (sizeof(MapFileSegment) * st->segments.len) +
-        (sizeof(Vector2) * st->vertexes.len);
-    MapFileHeader* header = (MapFileHeader*)calloc( 1, size );
+    // NOTE(alicia): segments are converted first so that
+    // acceleration data can be built before file is laid out.
+    MapFileSegment* file_segments = (MapFileSegment*)malloc(
+        sizeof(MapFileSegment) * (st->segments.len ? st->segments.len : 1) );
+    for( int i = 0; i < st->segments.len; ++i ) {
+        auto* s = st->segments.buf + i;
+        file_segments[i] = MapFileSegment{ (uint32_t)s->start, (uint32_t)s->end };
+    }
+
+    uint32_t accel_size = 0;
+    void*    accel      = map_accel_build(
+        st->vertexes.buf, st->vertexes.len,
+        file_segments, st->segments.len, &accel_size );
+
+    MapFileSection sections[] = {
+        { MapSectionType::OBJECTS,  (uint32_t)st->objects.len,  0, 0 },
+        { MapSectionType::VERTEXES, (uint32_t)st->vertexes.len, 0, 0 },
+        { MapSectionType::SEGMENTS, (uint32_t)st->segments.len, 0, 0 },
+        { MapSectionType::ACCEL,    accel_size,                 0, 0 },
+    };
+    uint32_t section_count = sizeof(sections) / sizeof(sections[0]);
+    if( !accel ) {
+        TraceLog( LOG_WARNING, "Failed to build acceleration data, game will rebuild it." );
+        section_count--;
+    }
+    uint32_t size = map_file_layout( section_count, sections );
+
+    uint8_t* bytes = (uint8_t*)calloc( 1, size );
+    MapFileHeader* header = (MapFileHeader*)bytes;
     memcpy( header, MAP_IDENTIFIER, 4 );
+    header->version       = MAP_VERSION;
     header->total_size    = size;
-    header->object_count  = st->objects.len;
-    header->vertex_count  = st->vertexes.len;
-    header->segment_count = st->segments.len;
+    header->section_count = section_count;
+    memcpy( header + 1, sections, sizeof(MapFileSection) * section_count );
 
-    MapFileObject*  obj  = (MapFileObject*)(header + 1);
-    Vector2*        vert = (Vector2*)(obj + header->object_count);
-    MapFileSegment* seg  = (MapFileSegment*)(vert + header->vertex_count);
+    MapFileObject*  obj  = (MapFileObject*)(bytes + sections[0].offset);
+    Vector2*        vert = (Vector2*)(bytes + sections[1].offset);
+    MapFileSegment* seg  = (MapFileSegment*)(bytes + sections[2].offset);
 
     for( int i = 0; i < st->objects.len; ++i ) {
         auto* o = st->objects.buf + i;
@@ -1245,35 +1413,41 @@ void save_map( State& state, const char* p ) {
     }
 
     memcpy( vert, st->vertexes.buf, sizeof(Vector2) * st->vertexes.len );
+    memcpy( seg, file_segments, sizeof(MapFileSegment) * st->segments.len );
+    free( file_segments );
 
-    for( int i = 0; i < st->segments.len; ++i ) {
-        auto* s = st->segments.buf + i;
-        seg[i] = MapFileSegment{ (uint16_t)s->start, (uint16_t)s->end };
+    if( accel ) {
+        memcpy( bytes + sections[3].offset, accel, accel_size );
+        free( accel );
     }
 
+    header->checksum = ComputeCRC32(
+        bytes + sizeof(*header), size - (int)sizeof(*header) );
+
     if( SaveFileData( file_path, header, size ) ) {
         TraceLog( LOG_INFO, "Saved %s!", file_path );
     } else {
         TraceLog( LOG_ERROR, "Failed to save %s!", file_path );
     }
 
-    free( header );
+    free( bytes );
 }
-void load_map( State& state, const char* path ) {
+bool load_map( State& state, const char* path ) {
     int size = 0;
     unsigned char* data = LoadFileData( path, &size );
     if( !data ) {
         TraceLog( LOG_ERROR, "Failed to load %s!", path );
     }
-    MapFileHeader* header = (MapFileHeader*)data;
-    if(
-        ( size < (int)sizeof(*header) ) ||
-        ( memcmp( header->identifier, MAP_IDENTIFIER, 4 ) != 0 ) ||
-        ( size != (int)header->total_size )
-    ) {
+    MapFileView view = {};
+    if( !map_file_parse( data, size, &view ) ) {
         TraceLog( LOG_ERROR, "%s is an invalid file!", path );
         UnloadFileData( data );
-        return;
+        return false;
+    }
+    if( view.version != MAP_VERSION ) {
+        TraceLog( LOG_INFO,
+            "%s is version %u, it will be saved as version %u.",
+            path, view.version, MAP_VERSION );
     }
 
     auto* st = &state.storage;
@@ -1281,24 +1455,25 @@ void load_map( State& state, const char* path ) {
     st->segments.len = 0;
     st->vertexes.len = 0;
 
-    MapFileObject*  obj  = (MapFileObject*)(header + 1);
-    Vector2*        vert = (Vector2*)(obj + header->object_count);
-    MapFileSegment* seg  = (MapFileSegment*)(vert + header->vertex_count);
+    MapFileObject* obj = view.objects;
 
-    if( st->objects.cap < header->object_count) {
+    if( st->objects.cap < (int)view.object_count ) {
         st->objects.buf = (EdObject*)realloc(
-            st->objects.buf, sizeof(EdObject) * header->object_count );
+            st->objects.buf, sizeof(EdObject) * view.object_count );
+        st->objects.cap = view.object_count;
     }
-    if( st->vertexes.cap < header->vertex_count ) {
+    if( st->vertexes.cap < (int)view.vertex_count ) {
         st->vertexes.buf = (Vector2*)realloc(
-            st->vertexes.buf, sizeof(Vector2) * header->vertex_count );
+            st->vertexes.buf, sizeof(Vector2) * view.vertex_count );
+        st->vertexes.cap = view.vertex_count;
     }
-    if( st->segments.cap < header->segment_count ) {
+    if( st->segments.cap < (int)view.segment_count ) {
         st->segments.buf = (EdSegment*)realloc(
-            st->segments.buf, sizeof(EdSegment) * header->segment_count );
+            st->segments.buf, sizeof(EdSegment) * view.segment_count );
+        st->segments.cap = view.segment_count;
     }
 
-    for( uint16_t i = 0; i < header->object_count; ++i ) {
+    for( uint32_t i = 0; i < view.object_count; ++i ) {
         EdObject o = {};
         o.position = obj[i].position;
         o.type     = obj[i].type;
@@ -1316,13 +1491,15 @@ void load_map( State& state, const char* path ) {
         buf_append( &st->objects, o );
     }
 
-    memcpy( st->vertexes.buf, vert, sizeof(Vector2) * header->vertex_count );
-    st->vertexes.len = header->vertex_count;
+    memcpy( st->vertexes.buf, view.vertexes, sizeof(Vector2) * view.vertex_count );
+    st->vertexes.len = view.vertex_count;
+
+    for( uint32_t i = 0; i < view.segment_count; ++i ) {
+        MapFileSegment file_segment = map_view_segment( &view, i );
 
-    for( uint16_t i = 0; i < header->segment_count; ++i ) {
         EdSegment s = {};
-        s.start = seg[i].start;
-        s.end   = seg[i].end;
+        s.start = file_segment.start;
+        s.end   = file_segment.end;
         s.tint  = WHITE;
         buf_append( &st->segments, s );
     }
@@ -1339,6 +1516,134 @@ void load_map( State& state, const char* path ) {
     state.path.dirty = true;
 
     TraceLog( LOG_INFO, "Loaded %s!", path );
+    return true;
+}
+int bake_maps( int count, char** paths ) {
+    if( !count ) {
+        fprintf( stderr, "usage: --bake <map>...\n" );
+        return 1;
+    }
+
+    State* state = (State*)calloc( 1, sizeof(State) );
+
+    int failed = 0;
+    for( int i = 0; i < count; ++i ) {
+        if( !load_map( *state, paths[i] ) ) {
+            failed++;
+            continue;
+        }
+        save_map( *state, paths[i] );
+    }
+
+    // NOTE(alicia): process is about to exit so state isn't freed.
+    return failed ? 1 : 0;
+}
+int optimize_maps( int count, char** paths ) {
+    float weld_distance = MAP_OPTIMIZE_DEFAULT_WELD_DISTANCE;
+    if( count && strncmp( paths[0], "--weld=", sizeof("--weld=") - 1 ) == 0 ) {
+        weld_distance = (float)atof( paths[0] + sizeof("--weld=") - 1 );
+        count--;
+        paths++;
+    }
+    if( !count || weld_distance < 0.0f ) {
+        fprintf( stderr, "usage: --optimize [--weld=<distance>] <map>...\n" );
+        return 1;
+    }
+
+    State* state = (State*)calloc( 1, sizeof(State) );
+
+    int failed = 0;
+    for( int i = 0; i < count; ++i ) {
+        if( !load_map( *state, paths[i] ) ) {
+            failed++;
+            continue;
+        }
+
+        MapOptimizeStats stats = map_optimize( &state->storage, weld_distance );
+        save_map( *state, paths[i] );
+
+        printf(
+            "%s: vertexes %i -> %i, segments %i -> %i "
+            "(welded %i, degenerate %i, duplicate %i, merged %i)\n",
+            paths[i],
+            stats.vertexes_before, stats.vertexes_after,
+            stats.segments_before, stats.segments_after,
+            stats.welded, stats.degenerate, stats.duplicate, stats.merged );
+    }
+
+    // NOTE(alicia): process is about to exit so state isn't freed.
+    return failed ? 1 : 0;
+}
+int generate_map( int argc, char** argv ) {
+    GenerateSettings settings = generate_default_settings();
+    const char*      path     = nullptr;
+
+    #define GENERATE_ARG( name ) (strncmp( arg, name, sizeof(name) - 1 ) == 0 ? arg + sizeof(name) - 1 : nullptr)
+
+    bool is_valid = true;
+    for( int i = 0; i < argc; ++i ) {
+        const char* arg   = argv[i];
+        const char* value = nullptr;
+        if( (value = GENERATE_ARG( "--kind=" )) ) {
+            if( strcmp( value, "maze" ) == 0 ) {
+                settings.kind = GenerateKind::MAZE;
+            } else if( strcmp( value, "arena" ) == 0 ) {
+                settings.kind = GenerateKind::ARENA;
+            } else {
+                is_valid = false;
+            }
+        } else if( (value = GENERATE_ARG( "--size=" )) ) {
+            if( sscanf( value, "%ix%i", &settings.width, &settings.height ) != 2 ) {
+                is_valid = false;
+            }
+        } else if( (value = GENERATE_ARG( "--cell=" )) ) {
+            settings.cell_size = (float)atof( value );
+        } else if( (value = GENERATE_ARG( "--enemies=" )) ) {
+            settings.enemy_count = atoi( value );
+        } else if( (value = GENERATE_ARG( "--batteries=" )) ) {
+            settings.battery_count = atoi( value );
+        } else if( (value = GENERATE_ARG( "--seed=" )) ) {
+            settings.seed = (uint32_t)strtoul( value, nullptr, 10 );
+        } else if( arg[0] != '-' && !path ) {
+            path = arg;
+        } else {
+            is_valid = false;
+        }
+    }
+
+    #undef GENERATE_ARG
+
+    if(
+        !is_valid || !path ||
+        settings.width  < MAP_GENERATE_MIN_CELLS || settings.width  > MAP_GENERATE_MAX_CELLS ||
+        settings.height < MAP_GENERATE_MIN_CELLS || settings.height > MAP_GENERATE_MAX_CELLS ||
+        settings.enemy_count < 0 || settings.battery_count < 0
+    ) {
+        fprintf( stderr,
+            "usage: --generate [--kind=maze|arena] [--size=<w>x<h>] [--cell=<size>]\n"
+            "                  [--enemies=<n>] [--batteries=<n>] [--seed=<n>] <map>\n" );
+        return 1;
+    }
+    if( settings.enemy_count == 0 && settings.battery_count == 0 ) {
+        settings.condition = LevelCondition::NONE;
+    } else if( settings.battery_count == 0 ) {
+        settings.condition = LevelCondition::DEFEAT_ENEMIES;
+    } else if( settings.enemy_count == 0 ) {
+        settings.condition = LevelCondition::COLLECT_BATTERIES;
+    }
+
+    State* state = (State*)calloc( 1, sizeof(State) );
+    map_generate( &state->storage, &settings );
+    save_map( *state, path );
+
+    printf(
+        "%s: %s %ix%i, %i vertexes, %i segments, %i objects\n",
+        path, to_string( settings.kind ), settings.width, settings.height,
+        state->storage.vertexes.len, state->storage.segments.len,
+        state->storage.objects.len );
+
+    // NOTE(alicia): process is about to exit so state isn't freed.
+    return 0;
 }
 void set_mode( State& state, Mode new_mode ) {
     state.mode = new_mode;
@@ -1502,6 +1807,28 @@ const char* collate_level_conditions() {
     buf_append( &result, 0 );
     return result.buf;
 }
+const char* collate_generate_kinds() {
+    struct {
+        char* buf;
+        int   len;
+        int   cap;
+    } result = {};
+
+    int count = (int)GenerateKind::COUNT;
+    for( int i = 0; i < count; ++i ) {
+        auto type = (GenerateKind)i;
+        const char* name = to_string( type );
+        while( *name ) {
+            buf_append( &result, *name++ );
+        }
+
+        if( i + 1 < count ) {
+            buf_append( &result, ';' );
+        }
+    }
+    buf_append( &result, 0 );
+    return result.buf;
+}
 
 const char* to_string( Mode mode ) {
     switch( mode ) {
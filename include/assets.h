@@ -0,0 +1,170 @@
+#if !defined(ASSETS_H)
+#define ASSETS_H
+/**
+ * @file   assets.h
+ * @brief  Asynchronous asset decoding.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 05, 2025
+*/
+#include "raylib.h"
+#include "jobs.h"
+#include "mapped_file.h"
+
+#define ASSETS_MAX_REQUESTS (128)
+#define ASSETS_MAX_CACHED   (128)
+#define ASSETS_MAX_PATH     (128)
+// NOTE(alicia): unreferenced assets stay resident until
+// resident size goes over budget.
+#define ASSETS_CACHE_BUDGET (64 * 1024 * 1024)
+
+enum class AssetType {
+    // NOTE(alicia): raw file bytes, served to raylib's LoadFileData.
+    FILE,
+    IMAGE,
+    WAVE,
+    ANIMATIONS,
+};
+enum class AssetStatus {
+    NONE,
+    QUEUED,
+    DECODED,
+    FAILED,
+};
+
+/// @brief Decode request.
+/// Workers only touch a request while it's QUEUED.
+struct AssetRequest {
+    AssetType   type;
+    AssetStatus status;
+    bool        mipmaps;
+    char        path[ASSETS_MAX_PATH];
+
+    JobCounter counter;
+
+    union {
+        struct {
+            unsigned char* data;
+            int            size;
+        } file;
+        Image image;
+        Wave  wave;
+        struct {
+            ModelAnimation* buf;
+            int             len;
+        } animations;
+    };
+};
+
+enum class CachedAssetType {
+    TEXTURE,
+    MODEL,
+    SOUND,
+    ANIMATIONS,
+};
+
+/// @brief Loaded asset shared across modes.
+struct CachedAsset {
+    CachedAssetType type;
+    bool            is_used;
+    bool            is_resident;
+    bool            mipmaps;
+    int             refcount;
+    // NOTE(alicia): decode request handle, -1 if none.
+    int             request;
+    unsigned        last_used;
+    size_t          size;
+    char            path[ASSETS_MAX_PATH];
+
+    union {
+        Texture texture;
+        Model   model;
+        Sound   sound;
+        struct {
+            ModelAnimation* buf;
+            int             len;
+        } animations;
+    };
+};
+
+struct AssetLoader {
+    // NOTE(alicia): resource pack, if it exists every file
+    // is looked up in it before falling back to loose files.
+    MappedFile pack;
+
+    AssetRequest requests[ASSETS_MAX_REQUESTS];
+    bool         lock;
+
+    CachedAsset cache[ASSETS_MAX_CACHED];
+    size_t      resident_size;
+    unsigned    use_counter;
+};
+
+/// @brief Map resource pack and install LoadFileData callback
+/// that serves prefetched and packed files.
+void assets_init( AssetLoader* loader );
+/// @brief Wait for pending requests, free decoded data,
+/// unload every cached asset and unmap resource pack.
+void assets_shutdown( AssetLoader* loader );
+
+/// @brief Check if file exists in resource pack or on disk.
+bool assets_file_exists( AssetLoader* loader, const char* path );
+/// @brief Get read-only view of file.
+/// Packed files point straight into pack, loose files are mapped.
+/// Safe to call from worker threads.
+bool assets_file_view( AssetLoader* loader, const char* path, MappedFile* out_file );
+/// @brief Open music stream, streamed from resource pack if it's packed.
+Music assets_load_music( AssetLoader* loader, const char* path );
+/// @brief Load texture outside of cache, from cooked data if there is any.
+/// Packs don't have sources of cooked textures so use this instead of LoadTexture.
+Texture assets_load_texture( AssetLoader* loader, const char* path, bool mipmaps = false );
+
+/// @brief Queue decode of path on worker threads.
+/// If the same request is already queued or decoded, its handle is returned.
+/// @return Handle, -1 if there are no free requests.
+int assets_request(
+    AssetLoader* loader, AssetType type, const char* path, bool mipmaps = false );
+
+/// @brief Check if request has finished decoding (successfully or not).
+bool assets_is_ready( AssetLoader* loader, int handle );
+/// @brief Block until request has finished decoding.
+void assets_wait( AssetLoader* loader, int handle );
+
+/// @brief Upload decoded image and release request.
+/// Falls back to synchronous load if decode failed.
+Texture assets_take_texture( AssetLoader* loader, int handle );
+/// @brief Create sound from decoded wave and release request.
+Sound assets_take_sound( AssetLoader* loader, int handle );
+/// @brief Take ownership of decoded animations and release request.
+ModelAnimation* assets_take_animations(
+    AssetLoader* loader, int handle, int* out_count );
+/// @brief Free decoded data and mark request as free.
+void assets_release( AssetLoader* loader, int handle );
+
+/// @brief Get handle to cached asset and increment its reference count.
+/// Nothing is loaded until first use or prefetch.
+/// @return Handle, -1 if cache is full.
+int assets_acquire(
+    AssetLoader* loader, CachedAssetType type, const char* path, bool mipmaps = false );
+/// @brief Decrement reference count.
+/// Asset stays resident until evicted.
+void assets_unref( AssetLoader* loader, int handle );
+/// @brief Queue decode on worker threads if asset isn't resident.
+void assets_prefetch( AssetLoader* loader, int handle );
+/// @brief Check if asset is resident or its prefetch has finished decoding.
+bool assets_prefetch_ready( AssetLoader* loader, int handle );
+/// @brief Free pending prefetch if caller holds the only reference.
+/// Call before releasing that reference with assets_unref.
+void assets_cancel_prefetch( AssetLoader* loader, int handle );
+
+/// @brief Get cached asset, loading it on first use.
+Texture assets_texture( AssetLoader* loader, int handle );
+Model assets_model( AssetLoader* loader, int handle );
+Sound assets_sound( AssetLoader* loader, int handle );
+ModelAnimation* assets_animations(
+    AssetLoader* loader, int handle, int* out_count );
+
+/// @brief Unload least recently used unreferenced assets
+/// until resident size is within budget.
+void assets_evict( AssetLoader* loader, size_t budget );
+
+#endif /* header guard */
@@ -0,0 +1,75 @@
+#if !defined(CULL_H)
+#define CULL_H
+/**
+ * @file   cull.h
+ * @brief  CPU frustum and fog distance culling.
+ * Doesn't touch GPU or window so it can run headless.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 10, 2025
+*/
+#include "raylib.h"
+#include "shared/object.h"
+#include "wall_batch.h"
+#include "pvs.h"
+
+// NOTE(alicia): must match fog density in shaders.
+#define FOG_DENSITY (0.05f)
+// NOTE(alicia): fog factor below this is indistinguishable from full fog.
+#define FOG_CULL_THRESHOLD (1.0f / 255.0f)
+// NOTE(alicia): same as rlgl's default near plane.
+#define CULL_NEAR_PLANE (0.01f)
+
+/// @brief Six planes facing into the frustum, xyz is normal and w is distance.
+/// Order is left, right, bottom, top, near, far.
+struct Frustum {
+    Vector4 planes[6];
+};
+
+struct CullStats {
+    int objects_drawn;
+    int objects_culled;
+    int walls_drawn;
+    int walls_culled;
+    // NOTE(alicia): walls are culled per chunk.
+    int chunks_drawn;
+    int chunks_culled;
+};
+
+/// @brief Compact list of indexes that survived culling, in ascending order.
+struct CullList {
+    int* buf;
+    int  len;
+    int  cap;
+};
+
+/// @brief Distance at which fog factor exp(-density * d) drops below threshold.
+float fog_cull_distance( float density, float threshold );
+
+/// @brief Build frustum for perspective camera.
+/// @param aspect Width over height of render target.
+Frustum frustum_from_camera( const Camera3D& camera, float aspect, float near, float far );
+bool frustum_test_sphere( const Frustum* frustum, Vector3 center, float radius );
+bool frustum_test_box( const Frustum* frustum, BoundingBox box );
+
+/// @brief Bounds of object's mesh relative to its position,
+/// loose enough to cover any rotation and animation.
+BoundingBox object_cull_bounds( ObjectType type );
+
+/// @brief Collect active objects that are inside frustum, closer than far
+/// and in a potentially visible cell.
+/// @param pvs Optional, skips cell test if null.
+void cull_objects(
+    const Frustum* frustum, const Pvs* pvs, Vector3 camera_position, float far,
+    const Object* objects, int object_count,
+    CullList* out_visible, CullStats* stats );
+/// @brief Collect wall chunks that are inside frustum, closer than far
+/// and bordering a potentially visible cell.
+/// @param pvs Optional, skips cell test if null.
+void cull_walls(
+    const Frustum* frustum, const Pvs* pvs, Vector3 camera_position, float far,
+    const WallChunk* chunks, int chunk_count,
+    CullList* out_visible, CullStats* stats );
+
+void cull_list_free( CullList* list );
+
+#endif /* header guard */
@@ -0,0 +1,52 @@
+#if !defined(DYNAMIC_RESOLUTION_H)
+#define DYNAMIC_RESOLUTION_H
+/**
+ * @file   dynamic_resolution.h
+ * @brief  Scale 3D resolution to keep frame time under budget.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "raylib.h"
+
+#define DYNAMIC_RESOLUTION_MIN_SCALE (0.5f)
+#define DYNAMIC_RESOLUTION_STEP      (0.1f)
+// NOTE(alicia): how much of each frame goes into smoothed frame time.
+#define DYNAMIC_RESOLUTION_SMOOTHING (0.1f)
+// NOTE(alicia): smoothed frame time over budget * OVER lowers scale,
+// under budget * UNDER counts towards raising it.
+// Anything in between leaves scale alone.
+#define DYNAMIC_RESOLUTION_OVER      (1.2f)
+#define DYNAMIC_RESOLUTION_UNDER     (1.05f)
+// NOTE(alicia): seconds over budget before scale is lowered.
+#define DYNAMIC_RESOLUTION_LOWER_TIME (0.3f)
+// NOTE(alicia): seconds under budget before scale is raised,
+// doubles every time a raise has to be taken back.
+#define DYNAMIC_RESOLUTION_RAISE_TIME     (2.0f)
+#define DYNAMIC_RESOLUTION_RAISE_TIME_MAX (32.0f)
+// NOTE(alicia): lowering this soon after a raise means the raise didn't hold.
+#define DYNAMIC_RESOLUTION_RAISE_HOLD_TIME (3.0f)
+// NOTE(alicia): frame times right after a change aren't counted.
+#define DYNAMIC_RESOLUTION_SETTLE_TIME (0.5f)
+
+struct DynamicResolution {
+    // NOTE(alicia): fraction of render target width and height used by 3D pass.
+    float scale;
+
+    float budget;
+    float frame_time;
+
+    float over_time;
+    float under_time;
+    float raise_time;
+    float since_change;
+    bool  is_last_change_raise;
+};
+
+/// @brief Update scale from last frame's time.
+/// @param is_enabled Scale goes back to full when disabled.
+void dynamic_resolution_update(
+    DynamicResolution* dr, float dt, bool is_enabled );
+/// @brief Part of target that 3D pass is drawn into, bottom left is origin.
+Rectangle dynamic_resolution_viewport( const DynamicResolution* dr, Texture target );
+
+#endif /* header guard */
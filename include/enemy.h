@@ -40,6 +40,20 @@ readonly() float E_ATTACK_PUSH  = 22.0;
 
 readonly() float E_POWER_BONUS = 20.0;
 
+// NOTE(alicia): animation LOD by distance from camera.
+// Enemies past E_ANIM_LOD_FROZEN_DISTANCE are mostly fog.
+readonly() float E_ANIM_LOD_REDUCED_DISTANCE = 20.0;
+readonly() float E_ANIM_LOD_FROZEN_DISTANCE  = 45.0;
+readonly() int   E_ANIM_LOD_REDUCED_STEP     = 2;
+
+enum class AnimationLOD {
+    FULL,
+    REDUCED,
+    FROZEN,
+
+    COUNT
+};
+
 enum class EnemyState {
     IDLE,
     SCAN,
@@ -103,6 +117,28 @@ struct Enemy {
 
 #undef readonly
 
+inline
+AnimationLOD animation_lod( float distance_sqr ) {
+    if( distance_sqr >= E_ANIM_LOD_FROZEN_DISTANCE * E_ANIM_LOD_FROZEN_DISTANCE ) {
+        return AnimationLOD::FROZEN;
+    }
+    if( distance_sqr >= E_ANIM_LOD_REDUCED_DISTANCE * E_ANIM_LOD_REDUCED_DISTANCE ) {
+        return AnimationLOD::REDUCED;
+    }
+    return AnimationLOD::FULL;
+}
+/// @brief Frames to advance per animation step, 0 if frozen.
+inline
+int animation_lod_step( AnimationLOD lod ) {
+    switch( lod ) {
+        case AnimationLOD::FULL:    return 1;
+        case AnimationLOD::REDUCED: return E_ANIM_LOD_REDUCED_STEP;
+        case AnimationLOD::FROZEN:
+        case AnimationLOD::COUNT:   break;
+    }
+    return 0;
+}
+
 inline
 const char* to_string( EnemyState state ) {
     switch( state ) {
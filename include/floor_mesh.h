@@ -0,0 +1,96 @@
+#if !defined(FLOOR_MESH_H)
+#define FLOOR_MESH_H
+/**
+ * @file   floor_mesh.h
+ * @brief  Floor and ceiling meshes triangulated from level outline.
+ * Segments are split where they touch or cross, dangling walls are
+ * pruned and every face enclosed by walls is ear clipped.
+ * Outline doesn't touch GPU so it can run headless.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "raylib.h"
+#include "shared/world.h"
+
+// NOTE(alicia): points closer than this are the same point.
+#define FLOOR_EPSILON (0.001f)
+// NOTE(alicia): faces and triangles with less area than this are dropped.
+#define FLOOR_MIN_AREA (0.000001f)
+// NOTE(alicia): raylib meshes use 16-bit indices.
+#define FLOOR_CHUNK_MAX_VERTEXES (65535)
+// NOTE(alicia): same tiling as scene_floor_ceiling.glb,
+// uv is position * scale + 0.5.
+#define FLOOR_TEXTURE_SCALE (0.1f)
+#define CEILING_HEIGHT      (10.0f)
+
+/// @brief Face enclosed by walls.
+struct FloorPolygon {
+    // NOTE(alicia): counter clockwise, may touch itself
+    // where a wall joins two loops.
+    int first_point;
+    int point_count;
+    // NOTE(alicia): counter clockwise triangles, indexes into outline points.
+    int first_index;
+    int index_count;
+    float area;
+};
+
+/// @brief Area enclosed by level segments.
+struct FloorOutline {
+    struct {
+        Vector2* buf;
+        int      len;
+        int      cap;
+    } points;
+    struct {
+        int* buf;
+        int  len;
+        int  cap;
+    } indexes;
+    struct {
+        FloorPolygon* buf;
+        int           len;
+        int           cap;
+    } polygons;
+
+    // NOTE(alicia): should match, if they don't something failed to clip.
+    float polygon_area;
+    float triangle_area;
+};
+
+/// @brief Find and triangulate faces enclosed by segments.
+/// Faces inside of another face are covered by it so they're skipped.
+/// Reuses memory from previous build.
+/// @return False if segments don't enclose anything.
+bool floor_outline_build(
+    FloorOutline* outline, const Vector2* vertexes,
+    const MapFileSegment* segments, int segment_count );
+void floor_outline_free( FloorOutline* outline );
+
+/// @brief Floor and ceiling for a group of polygons.
+/// Vertexes are in world space, draw with identity transform.
+struct FloorChunk {
+    Mesh        floor;
+    Mesh        ceiling;
+    BoundingBox bounds;
+};
+
+struct FloorMesh {
+    FloorChunk* buf;
+    int         len;
+    int         cap;
+
+    FloorOutline outline;
+};
+
+/// @brief Build and upload floor and ceiling for level geometry.
+/// Frees previous chunks. Must be called from render thread.
+/// @return False if level has no enclosed area, no chunks are built.
+bool floor_mesh_build(
+    FloorMesh* floor, const Vector2* vertexes,
+    const MapFileSegment* segments, int segment_count );
+/// @brief Unload chunk meshes, keeps buffers for reuse.
+void floor_mesh_clear( FloorMesh* floor );
+void floor_mesh_free( FloorMesh* floor );
+
+#endif /* header guard */
@@ -26,6 +26,9 @@ void  OptionVolumeSFX( float scale );
 bool OptionFXAA();
 void OptionFXAA( bool is_on );
 
+bool OptionDynamicResolution();
+void OptionDynamicResolution( bool is_on );
+
 bool OptionInverseX();
 void OptionInverseX( bool is_on );
 
@@ -0,0 +1,65 @@
+#if !defined(HUD_H)
+#define HUD_H
+/**
+ * @file   hud.h
+ * @brief  Retained HUD, text is laid out and drawn into
+ * render textures only when displayed values change.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "raylib.h"
+#include "shared/level.h"
+
+/// @brief Everything HUD textures are drawn from.
+// NOTE(alicia): only ints so that values can be compared with memcmp.
+struct HudValues {
+    int screen_width;
+    int screen_height;
+
+    int level;
+    int condition;
+    int is_using_gamepad;
+
+    int power;
+    int max_power;
+    // NOTE(alicia): width of power bar fill in pixels.
+    int power_fill;
+
+    int enemies_defeated;
+    int total_enemy_count;
+    int batteries_collected;
+    int total_battery_count;
+};
+
+struct HudStats {
+    int rebuilds;
+    int banner_rebuilds;
+};
+
+struct Hud {
+    bool      is_valid;
+    HudValues values;
+    // NOTE(alicia): power bar, counters and tutorial text.
+    RenderTexture rt;
+
+    // NOTE(alicia): level name and description, drawn
+    // separately so that it can fade out on its own.
+    bool          is_banner_valid;
+    RenderTexture banner;
+    Vector2       banner_position;
+
+    HudStats stats;
+};
+
+/// @brief Width of power bar fill for power.
+float hud_power_fill( float power, float max_power );
+
+/// @brief Redraw HUD textures if values changed since last call.
+/// Must be called outside of BeginTextureMode/EndTextureMode.
+void hud_update( Hud* hud, Font font, const HudValues& values );
+/// @brief Draw HUD textures.
+/// @param banner_alpha Opacity of level banner, banner is skipped if zero.
+void hud_draw( Hud* hud, float banner_alpha );
+void hud_free( Hud* hud );
+
+#endif /* header guard */
@@ -0,0 +1,41 @@
+#if !defined(JOBS_H)
+#define JOBS_H
+/**
+ * @file   jobs.h
+ * @brief  Minimal worker thread pool.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 04, 2025
+*/
+
+#define JOBS_MAX_THREADS (16)
+#define JOBS_QUEUE_SIZE  (1024)
+
+typedef void JobFn( void* params );
+
+/// @brief Counts jobs that are still in flight.
+/// Zero-initialize before first use.
+struct JobCounter {
+    int pending;
+};
+
+/// @brief Spawn worker threads.
+/// On platforms without threads (web), jobs run immediately on submit.
+bool jobs_init();
+void jobs_shutdown();
+
+/// @brief Number of worker threads (not including the calling thread).
+int jobs_thread_count();
+
+/// @brief Push a job onto the queue.
+/// If the queue is full, job is run on the calling thread.
+void jobs_submit( JobCounter* counter, JobFn* fn, void* params );
+
+/// @brief Check if all jobs tracked by counter have completed.
+bool jobs_done( JobCounter* counter );
+
+/// @brief Block until all jobs tracked by counter have completed.
+/// Calling thread helps by running queued jobs tracked by counter,
+/// other jobs are left for worker threads.
+void jobs_wait( JobCounter* counter );
+
+#endif /* header guard */
@@ -0,0 +1,32 @@
+#if !defined(MAPPED_FILE_H)
+#define MAPPED_FILE_H
+/**
+ * @file   mapped_file.h
+ * @brief  Read-only memory mapped files.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 07, 2025
+*/
+#include <stddef.h>
+
+/// @brief Read-only view of a file's contents.
+/// On web there's no mmap so file is read into heap memory instead.
+struct MappedFile {
+    void*  data;
+    size_t size;
+    bool   is_mapped;
+    // NOTE(alicia): points into memory owned by something else
+    // (like the resource pack) and isn't unmapped on close.
+    bool   is_view;
+#if defined(_WIN32)
+    void* file;
+    void* mapping;
+#endif
+};
+
+/// @brief Map file at path.
+/// Safe to call from worker threads.
+bool mapped_file_open( const char* path, MappedFile* out_file );
+/// @brief Unmap file. Does nothing if file isn't open.
+void mapped_file_close( MappedFile* file );
+
+#endif /* header guard */
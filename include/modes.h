@@ -8,6 +8,7 @@
 */
 
 struct GlobalState;
+struct GameAssetHandles;
 enum class Mode {
     INTRO,
     MAIN_MENU,
@@ -18,6 +19,15 @@ void mode_intro_load( GlobalState* state );
 void mode_main_menu_load( GlobalState* state );
 void mode_game_load( GlobalState* state );
 
+/// @brief Start decoding game assets in the background.
+/// Handles hold references until released with mode_game_prefetch_release.
+void mode_game_prefetch( GlobalState* state, GameAssetHandles* out_handles );
+/// @brief Release references taken by mode_game_prefetch.
+/// Decoded data is kept for game mode if is_entering_game is true,
+/// otherwise prefetches nothing else references are freed.
+void mode_game_prefetch_release(
+    GlobalState* state, GameAssetHandles* handles, bool is_entering_game );
+
 void mode_intro_update( GlobalState* state, float dt );
 void mode_main_menu_update( GlobalState* state, float dt );
 void mode_game_update( GlobalState* state, float dt );
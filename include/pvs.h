@@ -0,0 +1,124 @@
+#if !defined(PVS_H)
+#define PVS_H
+/**
+ * @file   pvs.h
+ * @brief  Cell and portal visibility built from map segments.
+ * Map is split into convex cells with a 2D BSP at level load,
+ * cells are joined by portals wherever a splitter isn't covered by a wall.
+ * Doesn't touch GPU or window so it can run headless.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include <stdint.h>
+#include "raylib.h"
+#include "shared/world.h"
+
+#define PVS_EPSILON (0.001f)
+// NOTE(alicia): gaps between walls smaller than this aren't portals.
+#define PVS_MIN_PORTAL_WIDTH (0.01f)
+// NOTE(alicia): camera this close to a portal sees through it at any angle.
+#define PVS_EYE_EPSILON (0.05f)
+// NOTE(alicia): root cell is map bounds grown by this much.
+#define PVS_BOUNDS_PADDING (8.0f)
+// NOTE(alicia): number of splitters scored per BSP node.
+#define PVS_SPLIT_CANDIDATES (16)
+// NOTE(alicia): traversal gives up and marks everything
+// visible after this many visits per cell.
+#define PVS_MAX_VISITS_PER_LEAF (8)
+
+struct PvsNode {
+    // NOTE(alicia): front is dot( normal, p ) >= dist.
+    Vector2 normal;
+    float   dist;
+    // NOTE(alicia): negative child is ~leaf index.
+    int front;
+    int back;
+};
+/// @brief Opening from one cell into another.
+struct PvsPortal {
+    Vector2 start;
+    Vector2 end;
+    // NOTE(alicia): cell on the other side.
+    int leaf;
+};
+/// @brief Convex cell.
+struct PvsLeaf {
+    int first_portal;
+    int portal_count;
+    // NOTE(alicia): wall chunks with walls on cell's boundary.
+    int first_chunk;
+    int chunk_count;
+};
+/// @brief Angular range seen through a chain of portals.
+struct PvsCone {
+    float start;
+    float span;
+};
+
+struct Pvs {
+    int root;
+    struct {
+        PvsNode* buf;
+        int      len;
+        int      cap;
+    } nodes;
+    struct {
+        PvsLeaf* buf;
+        int      len;
+        int      cap;
+    } leaves;
+    struct {
+        PvsPortal* buf;
+        int        len;
+        int        cap;
+    } portals;
+    struct {
+        int* buf;
+        int  len;
+        int  cap;
+    } leaf_chunks;
+    // NOTE(alicia): chunks with no walls on any cell's boundary.
+    struct {
+        int* buf;
+        int  len;
+        int  cap;
+    } orphan_chunks;
+    int chunk_count;
+
+    // NOTE(alicia): traversal state, leaf or chunk
+    // is visible when its stamp matches stamp.
+    uint32_t  stamp;
+    uint32_t* leaf_stamps;
+    uint32_t* chunk_stamps;
+    PvsCone*  leaf_cones;
+    uint8_t*  leaf_queued;
+    int*      queue;
+    int       state_cap;
+    int       state_chunk_cap;
+
+    int camera_leaf;
+    int visible_leaf_count;
+};
+
+/// @brief Build cells and portals for level geometry.
+/// Reuses memory from previous build.
+/// @param segment_chunk Wall chunk of each segment, -1 if segment has no chunk.
+void pvs_build(
+    Pvs* pvs, const Vector2* vertexes,
+    const MapFileSegment* segments, int segment_count,
+    const int* segment_chunk, int chunk_count );
+void pvs_free( Pvs* pvs );
+
+/// @brief Find cell that contains point.
+int pvs_locate( const Pvs* pvs, Vector2 point );
+/// @brief Walk portals out from camera's cell.
+/// @param far Portals further than this are not walked.
+void pvs_update( Pvs* pvs, Vector2 camera, float far );
+
+/// @brief Everything is visible until pvs is built and updated.
+bool pvs_leaf_visible( const Pvs* pvs, int leaf );
+bool pvs_chunk_visible( const Pvs* pvs, int chunk );
+/// @brief Check if any cell under box corners or center is visible.
+bool pvs_box_visible( const Pvs* pvs, Vector2 min, Vector2 max );
+
+#endif /* header guard */
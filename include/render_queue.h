@@ -0,0 +1,111 @@
+#if !defined(RENDER_QUEUE_H)
+#define RENDER_QUEUE_H
+/**
+ * @file   render_queue.h
+ * @brief  Sorted mesh draws with shader uniform tracking.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include <stdint.h>
+#include "raylib.h"
+
+#define RENDER_ITEM_MAX_UNIFORMS    (2)
+#define RENDER_UNIFORM_MAX_SIZE     (16)
+// NOTE(alicia): shader is top 8 bits of sort key.
+#define RENDER_QUEUE_MAX_SHADERS    (256)
+
+/// @brief Called right before item is drawn,
+/// for state that lives outside of material like skinned poses.
+typedef void RenderPrepareFN( void* user, int arg );
+
+struct RenderUniform {
+    int           loc;
+    int           type;
+    unsigned char data[RENDER_UNIFORM_MAX_SIZE];
+};
+
+/// @brief Single mesh draw or instanced draw if instance_count is not zero.
+struct RenderItem {
+    // NOTE(alicia): shader, texture, depth then submission order.
+    uint64_t key;
+
+    const Mesh*   mesh;
+    Material      material;
+    Matrix        transform;
+    const Matrix* instances;
+    int           instance_count;
+
+    RenderUniform uniforms[RENDER_ITEM_MAX_UNIFORMS];
+    int           uniform_count;
+
+    RenderPrepareFN* prepare;
+    void*            prepare_user;
+    int              prepare_arg;
+};
+
+struct RenderStats {
+    int items;
+    int draw_calls;
+    // NOTE(alicia): changes between consecutive draws after sorting.
+    int shader_changes;
+    int texture_changes;
+    int uniform_uploads;
+    int uniforms_skipped;
+};
+
+/// @brief Last value uploaded to a shader uniform this frame.
+struct RenderCachedUniform {
+    unsigned int  shader;
+    int           loc;
+    int           type;
+    unsigned char data[RENDER_UNIFORM_MAX_SIZE];
+};
+
+struct RenderQueue {
+    RenderItem* buf;
+    int         len;
+    int         cap;
+
+    struct {
+        RenderCachedUniform* buf;
+        int                  len;
+        int                  cap;
+    } uniforms;
+    struct {
+        unsigned int* buf;
+        int           len;
+        int           cap;
+    } shaders;
+
+    Vector3     eye;
+    RenderStats stats;
+};
+
+/// @brief Clear items, stats and uniform cache.
+/// @param eye Position items are sorted front to back from.
+void render_queue_begin( RenderQueue* queue, Vector3 eye );
+/// @brief Upload uniform now unless it already has value this frame.
+void render_queue_uniform(
+    RenderQueue* queue, Shader shader, int loc, const void* value, int type );
+
+/// @brief Add mesh draw, mesh must stay alive until flush.
+/// @return Item that uniforms and prepare callback can be added to,
+/// valid until next push.
+RenderItem* render_queue_mesh(
+    RenderQueue* queue, const Mesh* mesh, Material material, Matrix transform );
+/// @brief Add mesh draw sorted by sort_position instead of transform's translation.
+RenderItem* render_queue_mesh_at(
+    RenderQueue* queue, const Mesh* mesh, Material material,
+    Matrix transform, Vector3 sort_position );
+/// @brief Add instanced draw, mesh and instances must stay alive until flush.
+RenderItem* render_queue_instanced(
+    RenderQueue* queue, const Mesh* mesh, Material material,
+    const Matrix* instances, int instance_count );
+/// @brief Set uniform right before item is drawn.
+void render_item_uniform( RenderItem* item, int loc, const void* value, int type );
+
+/// @brief Sort and draw items.
+void render_queue_flush( RenderQueue* queue );
+void render_queue_free( RenderQueue* queue );
+
+#endif /* header guard */
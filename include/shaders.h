@@ -6,10 +6,27 @@
  * @author Alicia Amarilla (smushyaa@gmail.com)
  * @date   January 24, 2025
 */
+#include <stdint.h>
+#include "raylib.h"
+
+/// @brief Features compiled into a shader permutation.
+enum ShaderPermutation : uint32_t {
+    SHADER_PERMUTATION_NONE = 0,
+    // NOTE(alicia): per-instance transforms, for DrawMeshInstanced.
+    SHADER_PERMUTATION_INSTANCED    = (1 << 0),
+    // NOTE(alicia): battery spin and bob, requires INSTANCED.
+    SHADER_PERMUTATION_BOB          = (1 << 1),
+    // NOTE(alicia): exponential distance fog on top of fog fade.
+    SHADER_PERMUTATION_DISTANCE_FOG = (1 << 2),
+    // NOTE(alicia): wrap uv x, walls have segment length baked into uvs.
+    SHADER_PERMUTATION_WRAP_UV      = (1 << 3),
+};
 
 extern const char basic_shading_vert[];
 extern const char basic_shading_frag[];
-extern const char basic_shading_wall_frag[];
 extern const char post_process_frag[];
 
+/// @brief Compile vert and frag with a #define for each permutation flag.
+Shader shader_load_permutation( const char* vert, const char* frag, uint32_t flags );
+
 #endif /* header guard */
@@ -0,0 +1,96 @@
+#if !defined(SHARED_COOKED_H)
+#define SHARED_COOKED_H
+/**
+ * @file   cooked.h
+ * @brief  Cooked asset formats.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 08, 2025
+*/
+// NOTE(alicia): shared with cbuild so this has to stay valid C.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COOKED_DIR "resources/cooked"
+
+#define COOKED_TEXTURE_IDENTIFIER "BTEX"
+#define COOKED_TEXTURE_EXT        ".tex"
+#define COOKED_WAVE_IDENTIFIER    "BWAV"
+#define COOKED_WAVE_EXT           ".pcm"
+#define COOKED_VERSION            (1)
+// NOTE(alicia): music is streamed from its source file so it isn't cooked.
+#define COOKED_STREAMED_DIR       "resources/audio/music/"
+
+/// @brief Cooked texture header.
+/// Followed by full mip chain, largest first, same layout as raylib's Image.
+struct CookedTextureHeader {
+    uint8_t  identifier[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipmaps;
+    // NOTE(alicia): raylib PixelFormat.
+    uint32_t format;
+    uint32_t data_size;
+    uint32_t reserved;
+};
+#if defined(__cplusplus)
+static_assert(sizeof(struct CookedTextureHeader) == 32, "What?" );
+#endif
+
+/// @brief Cooked wave header.
+/// Followed by interleaved PCM samples.
+struct CookedWaveHeader {
+    uint8_t  identifier[4];
+    uint32_t version;
+    uint32_t frame_count;
+    uint32_t sample_rate;
+    uint32_t sample_size;
+    uint32_t channels;
+    uint32_t data_size;
+    uint32_t reserved;
+};
+#if defined(__cplusplus)
+static_assert(sizeof(struct CookedWaveHeader) == 32, "What?" );
+#endif
+
+/// @brief Path of cooked asset for source path.
+/// e.g. resources/textures/a.png -> resources/cooked/textures/a.png.tex
+/// @return False if source isn't under resources/ or buffer is too small.
+static inline
+bool cooked_path( const char* path, const char* ext, char* out_path, int out_cap ) {
+    const char* prefix     = "resources/";
+    int         prefix_len = (int)strlen( prefix );
+    if( strncmp( path, prefix, prefix_len ) != 0 ) {
+        return false;
+    }
+
+    int len = snprintf(
+        out_path, out_cap, COOKED_DIR "/%s%s", path + prefix_len, ext );
+    return len > 0 && len < out_cap;
+}
+/// @brief Extension of cooked asset for source path.
+/// @return NULL if source isn't cooked.
+static inline
+const char* cooked_ext( const char* path ) {
+    if(
+        strncmp( path, COOKED_DIR, sizeof(COOKED_DIR) - 1 ) == 0 ||
+        strncmp( path, COOKED_STREAMED_DIR, sizeof(COOKED_STREAMED_DIR) - 1 ) == 0
+    ) {
+        return NULL;
+    }
+    const char* ext = strrchr( path, '.' );
+    if( !ext ) {
+        return NULL;
+    }
+    if( strcmp( ext, ".png" ) == 0 || strcmp( ext, ".jpg" ) == 0 ) {
+        return COOKED_TEXTURE_EXT;
+    }
+    if( strcmp( ext, ".wav" ) == 0 ) {
+        return COOKED_WAVE_EXT;
+    }
+    return NULL;
+}
+
+#endif /* header guard */
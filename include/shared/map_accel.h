@@ -0,0 +1,315 @@
+#if !defined(SHARED_MAP_ACCEL_H)
+#define SHARED_MAP_ACCEL_H
+/**
+ * @file   map_accel.h
+ * @brief  Map collision acceleration data.
+ * Baked into MapSectionType::ACCEL when map is saved,
+ * rebuilt at load time if it's missing or stale.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 09, 2025
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "shared/world.h"
+
+#define MAP_ACCEL_VERSION   (1)
+#define MAP_ACCEL_CELL_SIZE (4.0f)
+#define MAP_ACCEL_MAX_CELLS (256)
+
+/// @brief Acceleration data header.
+/// Followed by segment normals, cell ranges and segment indices.
+struct MapAccelHeader {
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t segment_count;
+    // NOTE(alicia): CRC32 of geometry accel was built from.
+    uint32_t vertex_checksum;
+    uint32_t segment_checksum;
+
+    Vector2  origin;
+    float    cell_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t index_count;
+    uint32_t reserved;
+};
+static_assert(sizeof(MapAccelHeader) == 48, "What?" );
+
+/// @brief Validated view into acceleration data.
+struct MapAccelView {
+    bool is_valid;
+
+    Vector2  origin;
+    float    cell_size;
+    uint32_t width;
+    uint32_t height;
+
+    // NOTE(alicia): one per segment, points to the left of start -> end.
+    const Vector2*  normals;
+    // NOTE(alicia): width * height + 1 entries, cell i
+    // owns indices[cell_start[i]..cell_start[i + 1]].
+    const uint32_t* cell_start;
+    const uint32_t* indices;
+};
+
+inline
+uint32_t map_accel_vertex_checksum( const Vector2* vertexes, uint32_t vertex_count ) {
+    if( !vertex_count ) {
+        return 0;
+    }
+    return ComputeCRC32( (unsigned char*)vertexes, vertex_count * sizeof(Vector2) );
+}
+inline
+uint32_t map_accel_segment_checksum( const MapFileSegment* segments, uint32_t segment_count ) {
+    if( !segment_count ) {
+        return 0;
+    }
+    return ComputeCRC32( (unsigned char*)segments, segment_count * sizeof(MapFileSegment) );
+}
+
+inline
+void map_accel_cell_range(
+    const MapAccelHeader* header, Vector2 min, Vector2 max,
+    uint32_t* out_x0, uint32_t* out_y0, uint32_t* out_x1, uint32_t* out_y1
+) {
+    float x0 = floorf( (min.x - header->origin.x) / header->cell_size );
+    float y0 = floorf( (min.y - header->origin.y) / header->cell_size );
+    float x1 = floorf( (max.x - header->origin.x) / header->cell_size );
+    float y1 = floorf( (max.y - header->origin.y) / header->cell_size );
+
+    *out_x0 = (uint32_t)Clamp( x0, 0, header->width  - 1 );
+    *out_y0 = (uint32_t)Clamp( y0, 0, header->height - 1 );
+    *out_x1 = (uint32_t)Clamp( x1, 0, header->width  - 1 );
+    *out_y1 = (uint32_t)Clamp( y1, 0, header->height - 1 );
+}
+
+/// @brief Build acceleration data for geometry.
+/// Segments must have been validated against vertex count.
+/// @return Buffer allocated with malloc, nullptr if allocation failed.
+inline
+void* map_accel_build(
+    const Vector2* vertexes, uint32_t vertex_count,
+    const MapFileSegment* segments, uint32_t segment_count,
+    uint32_t* out_size
+) {
+    MapAccelHeader header = {};
+    header.version          = MAP_ACCEL_VERSION;
+    header.vertex_count     = vertex_count;
+    header.segment_count    = segment_count;
+    header.vertex_checksum  = map_accel_vertex_checksum( vertexes, vertex_count );
+    header.segment_checksum = map_accel_segment_checksum( segments, segment_count );
+
+    Vector2 min = {}, max = {};
+    for( uint32_t i = 0; i < vertex_count; ++i ) {
+        if( i == 0 ) {
+            min = max = vertexes[i];
+            continue;
+        }
+        min = Vector2Min( min, vertexes[i] );
+        max = Vector2Max( max, vertexes[i] );
+    }
+
+    float extent = fmaxf( max.x - min.x, max.y - min.y );
+    header.cell_size = fmaxf( MAP_ACCEL_CELL_SIZE, extent / (MAP_ACCEL_MAX_CELLS - 1) );
+    header.origin    = min;
+    header.width     = (uint32_t)((max.x - min.x) / header.cell_size) + 1;
+    header.height    = (uint32_t)((max.y - min.y) / header.cell_size) + 1;
+
+    uint32_t cell_count = header.width * header.height;
+
+    // NOTE(alicia): first pass counts, second pass fills.
+    uint32_t* counts = (uint32_t*)calloc( cell_count + 1, sizeof(uint32_t) );
+    if( !counts ) {
+        return nullptr;
+    }
+    for( int pass = 0; pass < 2; ++pass ) {
+        if( pass == 1 ) {
+            // NOTE(alicia): counts becomes cell_start.
+            uint32_t total = 0;
+            for( uint32_t i = 0; i < cell_count; ++i ) {
+                uint32_t count = counts[i];
+                counts[i] = total;
+                total    += count;
+            }
+            counts[cell_count] = total;
+            header.index_count = total;
+            break;
+        }
+
+        for( uint32_t s = 0; s < segment_count; ++s ) {
+            Vector2 start = vertexes[segments[s].start];
+            Vector2 end   = vertexes[segments[s].end];
+
+            uint32_t x0, y0, x1, y1;
+            map_accel_cell_range(
+                &header, Vector2Min( start, end ), Vector2Max( start, end ),
+                &x0, &y0, &x1, &y1 );
+            for( uint32_t y = y0; y <= y1; ++y ) {
+                for( uint32_t x = x0; x <= x1; ++x ) {
+                    counts[(y * header.width) + x]++;
+                }
+            }
+        }
+    }
+
+    uint32_t size =
+        sizeof(header) +
+        (sizeof(Vector2)  * segment_count) +
+        (sizeof(uint32_t) * (cell_count + 1)) +
+        (sizeof(uint32_t) * header.index_count);
+    uint8_t* result = (uint8_t*)malloc( size );
+    if( !result ) {
+        free( counts );
+        return nullptr;
+    }
+
+    memcpy( result, &header, sizeof(header) );
+    Vector2*  normals    = (Vector2*)(result + sizeof(header));
+    uint32_t* cell_start = (uint32_t*)(normals + segment_count);
+    uint32_t* indices    = cell_start + cell_count + 1;
+
+    memcpy( cell_start, counts, sizeof(uint32_t) * (cell_count + 1) );
+
+    for( uint32_t s = 0; s < segment_count; ++s ) {
+        Vector2 start = vertexes[segments[s].start];
+        Vector2 end   = vertexes[segments[s].end];
+
+        // NOTE(alicia): same normal game used to compute every frame.
+        normals[s] = Vector2Rotate( Vector2Normalize( start - end ), 90 * (PI / 180.0) );
+
+        uint32_t x0, y0, x1, y1;
+        map_accel_cell_range(
+            &header, Vector2Min( start, end ), Vector2Max( start, end ),
+            &x0, &y0, &x1, &y1 );
+        for( uint32_t y = y0; y <= y1; ++y ) {
+            for( uint32_t x = x0; x <= x1; ++x ) {
+                indices[counts[(y * header.width) + x]++] = s;
+            }
+        }
+    }
+
+    free( counts );
+    *out_size = size;
+    return result;
+}
+
+/// @brief Validate acceleration data against geometry it's used with.
+/// @return False if data is malformed, from an older version
+/// or was built from different geometry.
+inline
+bool map_accel_parse(
+    const void* data, uint32_t size,
+    const Vector2* vertexes, uint32_t vertex_count,
+    const MapFileSegment* segments, uint32_t segment_count,
+    MapAccelView* out_view
+) {
+    *out_view = {};
+
+    MapAccelHeader header;
+    if( !data || size < sizeof(header) ) {
+        return false;
+    }
+    memcpy( &header, data, sizeof(header) );
+
+    if(
+        header.version       != MAP_ACCEL_VERSION ||
+        header.vertex_count  != vertex_count      ||
+        header.segment_count != segment_count     ||
+        !header.width || !header.height           ||
+        header.width > MAP_ACCEL_MAX_CELLS        ||
+        header.height > MAP_ACCEL_MAX_CELLS       ||
+        !(header.cell_size > 0.0f)
+    ) {
+        return false;
+    }
+
+    uint64_t cell_count    = (uint64_t)header.width * header.height;
+    uint64_t expected_size =
+        sizeof(header) +
+        (sizeof(Vector2)  * (uint64_t)segment_count) +
+        (sizeof(uint32_t) * (cell_count + 1)) +
+        (sizeof(uint32_t) * (uint64_t)header.index_count);
+    if( expected_size != size ) {
+        return false;
+    }
+
+    if(
+        header.vertex_checksum  != map_accel_vertex_checksum( vertexes, vertex_count ) ||
+        header.segment_checksum != map_accel_segment_checksum( segments, segment_count )
+    ) {
+        return false;
+    }
+
+    const uint8_t*  bytes      = (const uint8_t*)data;
+    const Vector2*  normals    = (const Vector2*)(bytes + sizeof(header));
+    const uint32_t* cell_start = (const uint32_t*)(normals + segment_count);
+    const uint32_t* indices    = cell_start + cell_count + 1;
+
+    if( cell_start[0] != 0 || cell_start[cell_count] != header.index_count ) {
+        return false;
+    }
+    for( uint64_t i = 0; i < cell_count; ++i ) {
+        if( cell_start[i] > cell_start[i + 1] ) {
+            return false;
+        }
+    }
+    for( uint32_t i = 0; i < header.index_count; ++i ) {
+        if( indices[i] >= segment_count ) {
+            return false;
+        }
+    }
+
+    out_view->is_valid   = true;
+    out_view->origin     = header.origin;
+    out_view->cell_size  = header.cell_size;
+    out_view->width      = header.width;
+    out_view->height     = header.height;
+    out_view->normals    = normals;
+    out_view->cell_start = cell_start;
+    out_view->indices    = indices;
+    return true;
+}
+
+/// @brief Collect segments in cells overlapping box.
+/// Each segment is reported once, stamps must have one entry per segment
+/// and stamp must be different from any stamp used before.
+/// @return Number of segments written to out_segments.
+inline
+int map_accel_query(
+    const MapAccelView* view, Vector2 min, Vector2 max,
+    uint32_t* stamps, uint32_t stamp,
+    uint32_t* out_segments, int out_cap
+) {
+    MapAccelHeader header = {};
+    header.origin    = view->origin;
+    header.cell_size = view->cell_size;
+    header.width     = view->width;
+    header.height    = view->height;
+
+    uint32_t x0, y0, x1, y1;
+    map_accel_cell_range( &header, min, max, &x0, &y0, &x1, &y1 );
+
+    int count = 0;
+    for( uint32_t y = y0; y <= y1; ++y ) {
+        for( uint32_t x = x0; x <= x1; ++x ) {
+            uint32_t cell = (y * view->width) + x;
+            for( uint32_t i = view->cell_start[cell]; i < view->cell_start[cell + 1]; ++i ) {
+                uint32_t segment = view->indices[i];
+                if( stamps[segment] == stamp ) {
+                    continue;
+                }
+                stamps[segment] = stamp;
+
+                if( count < out_cap ) {
+                    out_segments[count++] = segment;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+#endif /* header guard */
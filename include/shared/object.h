@@ -36,7 +36,6 @@ struct Object {
 
         struct {
             float power;
-            float timer;
         } battery;
 
         struct {
@@ -0,0 +1,139 @@
+#if !defined(SHARED_PACK_H)
+#define SHARED_PACK_H
+/**
+ * @file   pack.h
+ * @brief  Resource pack file format.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 08, 2025
+*/
+// NOTE(alicia): shared with cbuild so this has to stay valid C.
+#include <stdint.h>
+#include <string.h>
+
+#define PACK_IDENTIFIER "BPAK"
+#define PACK_VERSION    (1)
+#define PACK_PATH       "resources.pack"
+#define PACK_ALIGN      (16)
+
+/// @brief Pack file header.
+/// Followed by entries sorted by hash, then entry names, then file data.
+struct PackHeader {
+    uint8_t  identifier[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t total_size;
+    // NOTE(alicia): offset from start of file.
+    uint64_t names_offset;
+};
+
+/// @brief Table of contents entry.
+struct PackEntry {
+    uint64_t hash;
+    // NOTE(alicia): offset from start of file, aligned to PACK_ALIGN.
+    uint64_t offset;
+    uint64_t size;
+    // NOTE(alicia): offset from names_offset, names are null terminated.
+    uint32_t name_offset;
+    uint32_t name_len;
+};
+
+#if defined(__cplusplus)
+static_assert(sizeof(PackHeader) == 32, "What?" );
+static_assert(sizeof(PackEntry) == 32, "What?" );
+#endif
+
+/// @brief Hash resource path (FNV-1a).
+/// Back slashes are hashed as forward slashes.
+static inline
+uint64_t pack_hash( const char* path, uint32_t len ) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for( uint32_t i = 0; i < len; ++i ) {
+        char c = path[i] == '\\' ? '/' : path[i];
+        hash  ^= (uint8_t)c;
+        hash  *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+static inline
+int pack_name_cmp( const char* a, const char* b, uint32_t len ) {
+    for( uint32_t i = 0; i < len; ++i ) {
+        char ca = a[i] == '\\' ? '/' : a[i];
+        char cb = b[i] == '\\' ? '/' : b[i];
+        if( ca != cb ) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/// @brief Validate pack header and table of contents.
+static inline
+int pack_is_valid( const void* data, uint64_t size ) {
+    const struct PackHeader* header = (const struct PackHeader*)data;
+    if(
+        !data || size < sizeof(*header) ||
+        memcmp( header->identifier, PACK_IDENTIFIER, 4 ) != 0 ||
+        header->version != PACK_VERSION ||
+        header->total_size != size
+    ) {
+        return 0;
+    }
+
+    uint64_t entries_end =
+        sizeof(*header) + (uint64_t)header->entry_count * sizeof(struct PackEntry);
+    if( entries_end > size || header->names_offset < entries_end || header->names_offset > size ) {
+        return 0;
+    }
+
+    const struct PackEntry* entries = (const struct PackEntry*)(header + 1);
+    uint64_t names_size = size - header->names_offset;
+    for( uint32_t i = 0; i < header->entry_count; ++i ) {
+        const struct PackEntry* entry = entries + i;
+        if(
+            (i && entries[i - 1].hash > entry->hash) ||
+            entry->offset > size || entry->size > size - entry->offset ||
+            (uint64_t)entry->name_offset + entry->name_len >= names_size
+        ) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// @brief Find entry by path with binary search on hash.
+/// Pack must have been validated with pack_is_valid().
+/// @return Entry, NULL if path isn't in pack.
+static inline
+const struct PackEntry* pack_find( const void* data, const char* path ) {
+    const struct PackHeader* header  = (const struct PackHeader*)data;
+    const struct PackEntry*  entries = (const struct PackEntry*)(header + 1);
+    const char* names = (const char*)data + header->names_offset;
+
+    uint32_t len  = (uint32_t)strlen( path );
+    uint64_t hash = pack_hash( path, len );
+
+    uint32_t lo = 0, hi = header->entry_count;
+    while( lo < hi ) {
+        uint32_t mid = lo + ((hi - lo) / 2);
+        if( entries[mid].hash < hash ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // NOTE(alicia): names are compared in case of hash collision.
+    for( uint32_t i = lo; i < header->entry_count && entries[i].hash == hash; ++i ) {
+        if(
+            entries[i].name_len == len &&
+            pack_name_cmp( names + entries[i].name_offset, path, len ) == 0
+        ) {
+            return entries + i;
+        }
+    }
+    return NULL;
+}
+
+#endif /* header guard */
@@ -7,14 +7,25 @@
  * @date   January 27, 2025
 */
 #include <stdint.h>
+#include <string.h>
 #include "raylib.h"
 #include "shared/object.h"
 #include "shared/level.h"
 
-#define MAP_IDENTIFIER "BM25"
-#define MAP_EXT        ".map"
+// NOTE(alicia): v1 files have no version field, they are
+// identified by MAP_IDENTIFIER_V1 instead.
+#define MAP_IDENTIFIER_V1 "BM25"
+#define MAP_IDENTIFIER    "BMAP"
+#define MAP_EXT           ".map"
 
-struct MapFileHeader {
+#define MAP_VERSION_1 (1)
+#define MAP_VERSION_2 (2)
+#define MAP_VERSION   MAP_VERSION_2
+
+#define MAP_SECTION_ALIGN (16)
+#define MAP_MAX_SECTIONS  (16)
+
+struct MapFileHeaderV1 {
     uint8_t  identifier[4];
     uint32_t total_size;
 
@@ -22,7 +33,45 @@ struct MapFileHeader {
     uint16_t vertex_count;
     uint16_t segment_count;
 };
-static_assert(sizeof(MapFileHeader) == 16, "What?" );
+static_assert(sizeof(MapFileHeaderV1) == 16, "What?" );
+
+struct MapFileSegmentV1 {
+    uint16_t start, end;
+};
+static_assert(sizeof(MapFileSegmentV1) == 4, "What?" );
+
+/// @brief Map file header.
+/// Followed by section table, sections start on MAP_SECTION_ALIGN.
+struct MapFileHeader {
+    uint8_t  identifier[4];
+    uint32_t version;
+    uint32_t total_size;
+    // NOTE(alicia): CRC32 of everything after header.
+    uint32_t checksum;
+    uint32_t section_count;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(MapFileHeader) == 32, "What?" );
+
+enum class MapSectionType : uint32_t {
+    OBJECTS,
+    VERTEXES,
+    SEGMENTS,
+    // NOTE(alicia): optional, see shared/map_accel.h.
+    // count is size in bytes.
+    ACCEL,
+
+    COUNT
+};
+
+struct MapFileSection {
+    MapSectionType type;
+    uint32_t       count;
+    // NOTE(alicia): offset from start of file.
+    uint32_t       offset;
+    uint32_t       size;
+};
+static_assert(sizeof(MapFileSection) == 16, "What?" );
 
 struct MapFileObject {
     Vector2    position;
@@ -37,8 +86,205 @@ struct MapFileObject {
 static_assert(sizeof(MapFileObject) == 16, "What?" );
 
 struct MapFileSegment {
-    uint16_t start, end;
+    uint32_t start, end;
 };
-static_assert(sizeof(MapFileSegment) == 4, "What?" );
+static_assert(sizeof(MapFileSegment) == 8, "What?" );
+
+/// @brief Validated view into map file data, any version.
+struct MapFileView {
+    uint32_t version;
+
+    uint32_t       object_count;
+    MapFileObject* objects;
+
+    uint32_t vertex_count;
+    Vector2* vertexes;
+
+    uint32_t segment_count;
+    // NOTE(alicia): one of these is set depending on version.
+    MapFileSegment*   segments;
+    MapFileSegmentV1* segments_v1;
+
+    // NOTE(alicia): null if map doesn't have baked acceleration data.
+    void*    accel;
+    uint32_t accel_size;
+};
+
+inline
+MapFileSegment map_view_segment( const MapFileView* view, uint32_t index ) {
+    if( view->segments ) {
+        return view->segments[index];
+    }
+    return MapFileSegment{ view->segments_v1[index].start, view->segments_v1[index].end };
+}
+
+inline
+uint32_t map_section_element_size( MapSectionType type ) {
+    switch( type ) {
+        case MapSectionType::OBJECTS:  return sizeof(MapFileObject);
+        case MapSectionType::VERTEXES: return sizeof(Vector2);
+        case MapSectionType::SEGMENTS: return sizeof(MapFileSegment);
+        case MapSectionType::ACCEL:    return 1;
+        case MapSectionType::COUNT:    break;
+    }
+    return 0;
+}
+inline
+uint32_t map_align( uint32_t value ) {
+    return (value + (MAP_SECTION_ALIGN - 1)) & ~(uint32_t)(MAP_SECTION_ALIGN - 1);
+}
+
+/// @brief Lay out v2 sections.
+/// @return Total file size.
+inline
+uint32_t map_file_layout(
+    uint32_t section_count, MapFileSection* in_out_sections
+) {
+    uint32_t offset = map_align(
+        sizeof(MapFileHeader) + (sizeof(MapFileSection) * section_count) );
+    for( uint32_t i = 0; i < section_count; ++i ) {
+        auto* section   = in_out_sections + i;
+        section->offset = offset;
+        if( !section->size ) {
+            section->size = section->count * map_section_element_size( section->type );
+        }
+        offset = map_align( offset + section->size );
+    }
+    return offset;
+}
+
+/// @brief Validate map file and fill out view.
+/// Every count, offset and index is bounds checked so
+/// view can be used without further validation.
+inline
+bool map_file_parse( void* data, int size, MapFileView* out_view ) {
+    *out_view = {};
+    if( !data || size < (int)sizeof(MapFileHeaderV1) ) {
+        return false;
+    }
+    uint8_t* bytes = (uint8_t*)data;
+
+    if( memcmp( bytes, MAP_IDENTIFIER_V1, 4 ) == 0 ) {
+        MapFileHeaderV1* header = (MapFileHeaderV1*)bytes;
+        uint64_t expected_size = sizeof(*header) +
+            (sizeof(MapFileObject) * (uint64_t)header->object_count) +
+            (sizeof(Vector2) * (uint64_t)header->vertex_count) +
+            (sizeof(MapFileSegmentV1) * (uint64_t)header->segment_count);
+        if(
+            header->total_size != (uint32_t)size ||
+            expected_size != (uint64_t)size
+        ) {
+            return false;
+        }
+
+        out_view->version       = MAP_VERSION_1;
+        out_view->object_count  = header->object_count;
+        out_view->vertex_count  = header->vertex_count;
+        out_view->segment_count = header->segment_count;
+        out_view->objects       = (MapFileObject*)(header + 1);
+        out_view->vertexes      = (Vector2*)(out_view->objects + header->object_count);
+        out_view->segments_v1   =
+            (MapFileSegmentV1*)(out_view->vertexes + header->vertex_count);
+    } else if( memcmp( bytes, MAP_IDENTIFIER, 4 ) == 0 ) {
+        if( size < (int)sizeof(MapFileHeader) ) {
+            return false;
+        }
+        MapFileHeader* header = (MapFileHeader*)bytes;
+        if(
+            header->version != MAP_VERSION_2   ||
+            header->total_size != (uint32_t)size ||
+            header->section_count > MAP_MAX_SECTIONS
+        ) {
+            return false;
+        }
+
+        uint32_t table_end =
+            sizeof(*header) + (sizeof(MapFileSection) * header->section_count);
+        if( table_end > (uint32_t)size ) {
+            return false;
+        }
+        uint32_t checksum = ComputeCRC32(
+            bytes + sizeof(*header), size - (int)sizeof(*header) );
+        if( checksum != header->checksum ) {
+            return false;
+        }
+
+        bool found[(int)MapSectionType::COUNT] = {};
+        MapFileSection* sections = (MapFileSection*)(header + 1);
+        for( uint32_t i = 0; i < header->section_count; ++i ) {
+            auto* section = sections + i;
+            if(
+                (section->offset % MAP_SECTION_ALIGN) != 0 ||
+                section->offset < table_end ||
+                section->size > (uint32_t)size ||
+                section->offset > (uint32_t)size - section->size
+            ) {
+                return false;
+            }
+
+            // NOTE(alicia): unknown sections are skipped so that
+            // newer optional sections don't break older readers.
+            if( (uint32_t)section->type >= (uint32_t)MapSectionType::COUNT ) {
+                continue;
+            }
+            if(
+                found[(int)section->type] ||
+                (uint64_t)section->count * map_section_element_size( section->type ) !=
+                section->size
+            ) {
+                return false;
+            }
+            found[(int)section->type] = true;
+
+            void* section_data = bytes + section->offset;
+            switch( section->type ) {
+                case MapSectionType::OBJECTS: {
+                    out_view->object_count = section->count;
+                    out_view->objects      = (MapFileObject*)section_data;
+                } break;
+                case MapSectionType::VERTEXES: {
+                    out_view->vertex_count = section->count;
+                    out_view->vertexes     = (Vector2*)section_data;
+                } break;
+                case MapSectionType::SEGMENTS: {
+                    out_view->segment_count = section->count;
+                    out_view->segments      = (MapFileSegment*)section_data;
+                } break;
+                case MapSectionType::ACCEL: {
+                    out_view->accel      = section_data;
+                    out_view->accel_size = section->size;
+                } break;
+                case MapSectionType::COUNT: break;
+            }
+        }
+        out_view->version = MAP_VERSION_2;
+    } else {
+        return false;
+    }
+
+    for( uint32_t i = 0; i < out_view->object_count; ++i ) {
+        auto* obj = out_view->objects + i;
+        if(
+            (uint32_t)obj->type >= (uint32_t)ObjectType::COUNT ||
+            (
+                obj->type == ObjectType::LEVEL_EXIT &&
+                (uint32_t)obj->level_exit.condition >= (uint32_t)LevelCondition::COUNT
+            )
+        ) {
+            return false;
+        }
+    }
+    for( uint32_t i = 0; i < out_view->segment_count; ++i ) {
+        MapFileSegment segment = map_view_segment( out_view, i );
+        if(
+            segment.start >= out_view->vertex_count ||
+            segment.end   >= out_view->vertex_count
+        ) {
+            return false;
+        }
+    }
+
+    return true;
+}
 
 #endif /* header guard */
@@ -0,0 +1,160 @@
+#if !defined(SKINNING_H)
+#define SKINNING_H
+/**
+ * @file   skinning.h
+ * @brief  CPU skinning split from raylib's UpdateModelAnimation.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 04, 2025
+*/
+#include <stdint.h>
+#include "raylib.h"
+#include "jobs.h"
+
+#define SKIN_MAX_BONES (128)
+
+/// @brief Skinned vertex and normal data for one mesh.
+struct SkinnedPose {
+    float* vertices;
+    float* normals;
+    int    vertex_count;
+};
+
+struct AnimBake;
+
+struct SkinRequest {
+    const Mesh*           mesh;
+    const Transform*      bind_pose;
+    const ModelAnimation* anim;
+    // NOTE(alicia): if set, frame is decoded from bake instead of skinned.
+    const AnimBake*       bake;
+    int                   animation;
+    int                   frame;
+    SkinnedPose*          out;
+};
+
+/// @brief Batch of skinning requests that run across worker threads.
+struct SkinBatch {
+    SkinRequest* buf;
+    int          len;
+    int          cap;
+
+    JobCounter counter;
+};
+
+/// @brief Allocate buffers for pose if they're not already allocated.
+void skin_pose_reserve( SkinnedPose* pose, int vertex_count );
+void skin_pose_free( SkinnedPose* pose );
+
+/// @brief Skin mesh for given animation frame into pose.
+/// Does not touch GPU so it's safe to call from any thread.
+void skin_mesh(
+    const Mesh& mesh, const Transform* bind_pose,
+    const ModelAnimation& anim, int frame, SkinnedPose* out_pose );
+
+/// @brief Upload skinned pose to mesh's vertex buffers.
+/// Must be called from render thread.
+void skin_upload( const Mesh& mesh, const SkinnedPose* pose );
+
+void skin_batch_clear( SkinBatch* batch );
+void skin_batch_push(
+    SkinBatch* batch, const Model& model,
+    const ModelAnimation& anim, int frame, SkinnedPose* out_pose );
+/// @brief Push decode of baked frame. Animation must be baked.
+void skin_batch_push_baked(
+    SkinBatch* batch, const AnimBake* bake,
+    int animation, int frame, SkinnedPose* out_pose );
+/// @brief Submit all requests in batch to job queue.
+void skin_batch_dispatch( SkinBatch* batch );
+/// @brief Wait for dispatched requests to complete.
+void skin_batch_wait( SkinBatch* batch );
+void skin_batch_free( SkinBatch* batch );
+
+struct AnimBakeFrame {
+    Vector3 min;
+    Vector3 scale;
+};
+/// @brief Every frame of selected animations skinned once at load.
+/// Positions are quantized to 16-bits against per-frame bounds
+/// and normals to 8-bits.
+struct AnimBake {
+    int16_t*      positions;
+    int8_t*       normals;
+    AnimBakeFrame* frames;
+    // NOTE(alicia): first baked frame of each animation, -1 if not baked.
+    int*          offsets;
+    int           animation_count;
+    int           frame_count;
+    int           vertex_count;
+
+    size_t memory;
+    double bake_time;
+};
+
+/// @brief Bake animations listed in indexes using worker threads.
+bool anim_bake(
+    AnimBake* out_bake, const Model& model,
+    const ModelAnimation* animations, int animation_count,
+    const int* indexes, int index_count );
+bool anim_bake_has( const AnimBake* bake, int animation );
+/// @brief Decode baked frame into pose. Animation must be baked.
+void anim_bake_decode(
+    const AnimBake* bake, int animation, int frame, SkinnedPose* out_pose );
+void anim_bake_free( AnimBake* bake );
+
+struct PoseCacheEntry {
+    int      animation;
+    int      frame;
+    unsigned last_used;
+    bool     is_dirty;
+
+    SkinnedPose pose;
+};
+struct PoseCacheStats {
+    int lookups;
+    int hits;
+    int skinned;
+    int decoded;
+    int uploads;
+
+    double time;
+};
+/// @brief Skinned poses keyed by (animation, frame).
+/// Entries keep their pose between frames until they're
+/// recycled for a key that wasn't resident.
+struct PoseCache {
+    PoseCacheEntry* buf;
+    int             len;
+    int             cap;
+
+    unsigned frame_stamp;
+    // NOTE(alicia): entry currently in mesh vertex buffer, -1 if none.
+    int uploaded;
+
+    PoseCacheStats stats;
+    PoseCacheStats total;
+};
+/// @brief Skinned draw that references a pose cache entry.
+struct PoseDraw {
+    Matrix transform;
+    int    slot;
+};
+
+void pose_cache_begin_frame( PoseCache* cache );
+/// @brief Get entry slot for key, marking it dirty if it must be skinned.
+/// Slots are only valid until the next call to pose_cache_begin_frame.
+int  pose_cache_acquire( PoseCache* cache, int animation, int frame, int vertex_count );
+/// @brief Resolve dirty entries. Baked animations are decoded and
+/// the rest are skinned, both pushed to batch and dispatched.
+/// Bake is optional.
+void pose_cache_dispatch(
+    PoseCache* cache, SkinBatch* batch, const AnimBake* bake,
+    const Model& model, const ModelAnimation* animations );
+/// @brief Upload entry to mesh if it isn't already resident.
+void pose_cache_upload( PoseCache* cache, const Mesh& mesh, int slot );
+void pose_cache_free( PoseCache* cache );
+float pose_cache_hit_rate( const PoseCacheStats& stats );
+
+/// @brief Sort draws so that draws sharing a pose are adjacent.
+void pose_draws_sort( PoseDraw* draws, int count );
+
+#endif /* header guard */
@@ -10,7 +10,18 @@
 #include "modes.h"
 #include "gui.h"
 #include "player.h"
+#include "skinning.h"
+#include "assets.h"
+#include "mapped_file.h"
+#include "wall_batch.h"
+#include "floor_mesh.h"
+#include "cull.h"
+#include "render_queue.h"
+#include "hud.h"
+#include "dynamic_resolution.h"
 #include "shared/object.h"
+#include "shared/world.h"
+#include "shared/map_accel.h"
 
 #define WINDOW_WIDTH  1280
 #define WINDOW_HEIGHT  720
@@ -28,29 +39,172 @@ struct SoundBuffer {
     int    cap;
 };
 
-struct Segment {
-    int start, end;
+// NOTE(alicia): same layout as on disk so segments
+// can be used straight out of a mapped map file.
+typedef MapFileSegment Segment;
+
+struct ObjectBuffer {
+    Object* buf;
+    int     len;
+    int     cap;
+};
+// NOTE(alicia): vertex and segment buffers with
+// zero capacity are views into a mapped map file.
+struct VertexBuffer {
+    Vector2* buf;
+    int      len;
+    int      cap;
+};
+struct SegmentBuffer {
+    Segment* buf;
+    int      len;
+    int      cap;
+};
+struct AccelBuffer {
+    uint8_t* buf;
+    int      len;
+    int      cap;
+};
+/// @brief Per-instance transforms for one instanced draw.
+struct InstanceBuffer {
+    Matrix* buf;
+    int     len;
+    int     cap;
+};
+
+/// @brief Scratch buffers for segment queries, sized to segment count.
+struct SegmentQuery {
+    // NOTE(alicia): last query that reported segment.
+    uint32_t* stamps;
+    uint32_t* results;
+    int       cap;
+    uint32_t  stamp;
+};
+
+/// @brief Map file decoded into runtime arrays.
+struct MapData {
+    bool is_valid;
+
+    // NOTE(alicia): backs vertexes and segments.
+    MappedFile file;
+
+    ObjectBuffer  objects;
+    VertexBuffer  vertexes;
+    SegmentBuffer segments;
+    // NOTE(alicia): baked into map file or rebuilt
+    // if it's missing or stale, accel points into it.
+    AccelBuffer   accel_data;
+    MapAccelView  accel;
+
+    Vector3        player_spawn;
+    int            enemy_count;
+    int            battery_count;
+    LevelCondition condition;
+};
+
+#define GAME_TEXTURE_COUNT   (8)
+#define GAME_MODEL_COUNT     (5)
+#define GAME_SOUND_SET_COUNT (9)
+#define GAME_SOUND_SET_MAX   (8)
+
+/// @brief Asset cache handles for game mode.
+/// Same order as textures, models and sounds in game state.
+struct GameAssetHandles {
+    int textures[GAME_TEXTURE_COUNT];
+    int models[GAME_MODEL_COUNT];
+    int animations;
+    int sounds[GAME_SOUND_SET_COUNT][GAME_SOUND_SET_MAX];
+    int sound_counts[GAME_SOUND_SET_COUNT];
+};
+/// @brief Level change requested by simulation,
+/// applied on main thread once simulation job is done.
+enum class GameTransition {
+    NONE,
+    RESET_LEVEL,
+    NEXT_MAP,
+};
+
+/// @brief Sound effect started by simulation.
+struct SfxEvent {
+    Sound   sound;
+    Vector2 src;
+    Vector2 listener;
+    float   volume;
+    bool    random_pitch;
+};
+struct SfxBuffer {
+    SfxEvent* buf;
+    int       len;
+    int       cap;
+};
+
+/// @brief Everything game_draw reads, written by simulation
+/// while the other packet is drawn.
+struct FramePacket {
+    Camera3D     camera;
+    Player       player;
+    ObjectBuffer objects;
+
+    float battery_time;
+    float level_timer;
+    float exit_stage_timer;
+    bool  is_exiting_stage;
+
+    int enemy_counter;
+    int total_enemy_count;
+    int battery_counter;
+    int total_battery_count;
+
+    // NOTE(alicia): raylib audio isn't safe to call from simulation job
+    // so sounds are played on main thread once frame has been simulated.
+    SfxBuffer sfx;
 };
+
 struct GlobalState {
     Mode          mode;
     float         timer;
     RenderTexture rt;
+    // NOTE(alicia): 3D pass only uses part of rt when scale is under 1.
+    DynamicResolution dynamic_resolution;
 
     Shader sh_post_process;
     int    sh_post_process_loc_resolution;
 
+    // NOTE(alicia): permutations of basic shading, see ShaderPermutation.
     Shader sh_basic_shading;
     int    sh_basic_shading_loc_camera_position;
+    int    sh_basic_shading_loc_fog_far;
 
+    // NOTE(alicia): distance fog and wrapped uvs.
     Shader sh_wall;
     int    sh_wall_loc_camera_position;
-    int    sh_wall_loc_dist;
-    int    sh_wall_loc_apply_dist;
     int    sh_wall_loc_clipping_planes;
+    int    sh_wall_loc_fog_far;
+
+    // NOTE(alicia): distance fog only.
+    Shader sh_floor;
+    int    sh_floor_loc_camera_position;
+    int    sh_floor_loc_fog_far;
+
+    // NOTE(alicia): basic shading with per-instance transforms.
+    Shader sh_instanced;
+    int    sh_instanced_loc_camera_position;
+    int    sh_instanced_loc_fog_far;
+
+    // NOTE(alicia): instanced with battery spin and bob.
+    Shader sh_instanced_bob;
+    int    sh_instanced_bob_loc_camera_position;
+    int    sh_instanced_bob_loc_bob_time;
+    int    sh_instanced_bob_loc_fog_far;
 
     struct {
         Font    font;
         Texture tex_main_menu;
+
+        // NOTE(alicia): persistent so that main menu can
+        // decode game assets while it's idle.
+        AssetLoader assets;
+        AnimBake    anim_bake;
     } persistent;
 
     union {
@@ -60,8 +214,16 @@ struct GlobalState {
             Music music;
             bool is_options_open;
             bool is_credits_open;
+
+            // NOTE(alicia): references to game assets decoding in the background.
+            bool             is_prefetching;
+            bool             is_starting_game;
+            GameAssetHandles prefetch;
         } main_menu;
         struct {
+            bool             is_loading;
+            GameAssetHandles assets;
+
             bool  is_paused;
             bool  is_exiting_stage;
             float exit_stage_timer;
@@ -72,6 +234,8 @@ struct GlobalState {
 
             int battery_counter;
             int total_battery_count;
+            // NOTE(alicia): drives battery spin and bob in instanced shader.
+            float battery_time;
 
             GuiPauseMenu pause_menu_state;
             Camera3D     camera;
@@ -86,7 +250,6 @@ struct GlobalState {
                 Model floor_ceiling;
             } models;
             struct {
-                Texture test;
                 Texture white;
                 Texture battery;
                 Texture floor;
@@ -120,6 +283,27 @@ struct GlobalState {
                 int             len;
             } animations;
 
+            PoseCache pose_cache;
+            int       anim_lod_counts[(int)AnimationLOD::COUNT];
+            SkinBatch skin_batch;
+            struct {
+                PoseDraw* buf;
+                int       len;
+                int       cap;
+            } pose_draws;
+            struct {
+                InstanceBuffer enemy;
+                InstanceBuffer battery;
+                InstanceBuffer level_exit;
+            } instances;
+            struct {
+                CullList objects;
+                CullList walls;
+            } visible;
+            CullStats cull_stats;
+            RenderQueue render_queue;
+            Hud         hud;
+
             struct {
                 SoundBuffer step;
                 SoundBuffer dash;
@@ -134,21 +318,41 @@ struct GlobalState {
 
             Music music;
 
+            ObjectBuffer  objects;
+            VertexBuffer  vertexes;
+            SegmentBuffer segments;
+            MappedFile    map_file;
+            AccelBuffer   accel_data;
+            MapAccelView  accel;
+            SegmentQuery  segment_query;
+            WallBatch     walls;
+            FloorMesh     floor;
+            Pvs           pvs;
+
+            // NOTE(alicia): objects and counters as they were when the
+            // level started, restored on death or reset without file I/O.
+            // Vertexes and segments don't change during play so they aren't copied.
+            MapData level_start;
+
+            // NOTE(alicia): next level, decoded on a worker thread
+            // while current level is played.
             struct {
-                Object* buf;
-                int     len;
-                int     cap;
-            } objects;
-            struct {
-                Vector2* buf;
-                int      len;
-                int      cap;
-            } vertexes;
-            struct {
-                Segment* buf;
-                int      len;
-                int      cap;
-            } segments;
+                MapData    map;
+                int        index;
+                char       path[128];
+                JobCounter counter;
+            } next_map;
+
+            // NOTE(alicia): simulation of next frame runs on a
+            // worker thread while frame_read is drawn.
+            FramePacket    frames[2];
+            int            frame_read;
+            JobCounter     sim_counter;
+            float          sim_dt;
+            GameTransition transition;
+            // NOTE(alicia): raylib's generator isn't safe to
+            // call from simulation job, simulation has its own.
+            uint32_t       sim_rng;
         } game;
     } transient;
 };
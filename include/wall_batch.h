@@ -0,0 +1,48 @@
+#if !defined(WALL_BATCH_H)
+#define WALL_BATCH_H
+/**
+ * @file   wall_batch.h
+ * @brief  Static wall meshes merged at level load.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 10, 2025
+*/
+#include "raylib.h"
+#include "shared/world.h"
+
+// NOTE(alicia): segments are grouped into square tiles of this size
+// so that chunks stay spatially compact.
+#define WALL_CHUNK_TILE_SIZE (32.0f)
+// NOTE(alicia): raylib meshes use 16-bit indices.
+#define WALL_CHUNK_MAX_VERTEXES (65535)
+// NOTE(alicia): texture repeats every 10 units along wall.
+#define WALL_TEXTURE_SCALE (0.1f)
+
+/// @brief Merged mesh for a group of wall segments.
+/// Vertexes are in world space, draw with identity transform.
+struct WallChunk {
+    Mesh        mesh;
+    BoundingBox bounds;
+    int         segment_count;
+};
+
+struct WallBatch {
+    WallChunk* buf;
+    int        len;
+    int        cap;
+
+    int segment_count;
+    // NOTE(alicia): chunk of each map segment, -1 for segments without a wall.
+    int* segment_chunk;
+};
+
+/// @brief Build and upload wall chunks for level geometry.
+/// Frees previous chunks. Must be called from render thread.
+/// @param wall Single wall mesh, same one walls used to be drawn with.
+void wall_batch_build(
+    WallBatch* batch, const Mesh& wall,
+    const Vector2* vertexes, const MapFileSegment* segments, int segment_count );
+/// @brief Unload chunk meshes, keeps chunk buffer for reuse.
+void wall_batch_clear( WallBatch* batch );
+void wall_batch_free( WallBatch* batch );
+
+#endif /* header guard */
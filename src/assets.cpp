@@ -0,0 +1,841 @@
+/**
+ * @file   assets.cpp
+ * @brief  Asynchronous asset decoding.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 05, 2025
+*/
+#include "assets.h"
+#include "shared/pack.h"
+#include "shared/cooked.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static AssetLoader* global_assets = nullptr;
+
+static void assets_lock( AssetLoader* loader ) {
+    while( __atomic_test_and_set( &loader->lock, __ATOMIC_ACQUIRE ) ) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+static void assets_unlock( AssetLoader* loader ) {
+    __atomic_clear( &loader->lock, __ATOMIC_RELEASE );
+}
+static AssetStatus assets_status( AssetRequest* request ) {
+    return (AssetStatus)__atomic_load_n( (int*)&request->status, __ATOMIC_ACQUIRE );
+}
+
+static bool pack_lookup(
+    AssetLoader* loader, const char* path,
+    const unsigned char** out_data, int* out_size
+) {
+    if( !loader || !loader->pack.data ) {
+        return false;
+    }
+    const PackEntry* entry = pack_find( loader->pack.data, path );
+    if( !entry || entry->size > INT32_MAX ) {
+        return false;
+    }
+
+    *out_data = (const unsigned char*)loader->pack.data + entry->offset;
+    *out_size = (int)entry->size;
+    return true;
+}
+
+// NOTE(alicia): allocated with malloc so that raylib can free it
+// with UnloadFileData.
+static unsigned char* read_file( const char* path, int* out_size ) {
+    const unsigned char* packed = nullptr;
+    int packed_size = 0;
+    if( pack_lookup( global_assets, path, &packed, &packed_size ) ) {
+        unsigned char* data = (unsigned char*)malloc( packed_size );
+        if( !data ) {
+            return nullptr;
+        }
+        memcpy( data, packed, packed_size );
+
+        *out_size = packed_size;
+        return data;
+    }
+
+    FILE* file = fopen( path, "rb" );
+    if( !file ) {
+        return nullptr;
+    }
+
+    fseek( file, 0, SEEK_END );
+    long size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+    if( size <= 0 ) {
+        fclose( file );
+        return nullptr;
+    }
+
+    unsigned char* data = (unsigned char*)malloc( size );
+    if( !data ) {
+        fclose( file );
+        return nullptr;
+    }
+    if( fread( data, 1, size, file ) != (size_t)size ) {
+        free( data );
+        fclose( file );
+        return nullptr;
+    }
+    fclose( file );
+
+    *out_size = (int)size;
+    return data;
+}
+
+struct CookedFile {
+    const unsigned char* data;
+    int                  size;
+    unsigned char*       owned;
+};
+static bool cooked_open( const char* path, const char* ext, CookedFile* out_file ) {
+    *out_file = {};
+
+    char cooked[ASSETS_MAX_PATH + 32];
+    if( !cooked_path( path, ext, cooked, sizeof(cooked) ) ) {
+        return false;
+    }
+    if( pack_lookup( global_assets, cooked, &out_file->data, &out_file->size ) ) {
+        return true;
+    }
+
+    out_file->owned = read_file( cooked, &out_file->size );
+    out_file->data  = out_file->owned;
+    return out_file->data != nullptr;
+}
+static void cooked_close( CookedFile* file ) {
+    if( file->owned ) {
+        free( file->owned );
+    }
+    *file = {};
+}
+// NOTE(alicia): cooked data is copied out so that images and waves
+// own their data, same as when they're decoded by raylib.
+static void* cooked_copy_data( CookedFile* file, int header_size, uint32_t data_size ) {
+    if( !data_size || data_size > (uint32_t)(file->size - header_size) ) {
+        return nullptr;
+    }
+    void* result = malloc( data_size );
+    if( result ) {
+        memcpy( result, file->data + header_size, data_size );
+    }
+    return result;
+}
+// NOTE(alicia): larger than any texture GPU takes, also keeps
+// pixel data size of a level from overflowing int.
+#define COOKED_TEXTURE_MAX_DIMENSION (16384)
+
+/// @brief Check that texture header describes exactly data_size bytes.
+static bool cooked_texture_is_valid( const CookedTextureHeader* header ) {
+    if(
+        !header->width || !header->height || !header->mipmaps ||
+        header->width  > COOKED_TEXTURE_MAX_DIMENSION ||
+        header->height > COOKED_TEXTURE_MAX_DIMENSION ||
+        header->format < PIXELFORMAT_UNCOMPRESSED_GRAYSCALE ||
+        header->format > PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA
+    ) {
+        return false;
+    }
+
+    // NOTE(alicia): same mip chain layout as ImageMipmaps.
+    uint64_t size   = 0;
+    int      width  = (int)header->width;
+    int      height = (int)header->height;
+    for( uint32_t i = 0; i < header->mipmaps; ++i ) {
+        if( i && width == 1 && height == 1 ) {
+            // NOTE(alicia): more levels than there are in a full chain.
+            return false;
+        }
+        size  += (uint64_t)GetPixelDataSize( width, height, (int)header->format );
+        width  = width  > 1 ? width  / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return size == header->data_size;
+}
+/// @brief Check that wave header describes exactly data_size bytes.
+static bool cooked_wave_is_valid( const CookedWaveHeader* header ) {
+    if(
+        !header->frame_count || !header->sample_rate || !header->channels ||
+        (header->sample_size != 8 && header->sample_size != 16 && header->sample_size != 32)
+    ) {
+        return false;
+    }
+    uint64_t size =
+        (uint64_t)header->frame_count * header->channels * (header->sample_size / 8);
+    return size == header->data_size;
+}
+
+static bool load_cooked_image( const char* path, bool mipmaps, Image* out_image ) {
+    CookedFile file;
+    if( !cooked_open( path, COOKED_TEXTURE_EXT, &file ) ) {
+        return false;
+    }
+
+    CookedTextureHeader header = {};
+    void* data = nullptr;
+    if( file.size >= (int)sizeof(header) ) {
+        memcpy( &header, file.data, sizeof(header) );
+        if(
+            memcmp( header.identifier, COOKED_TEXTURE_IDENTIFIER, 4 ) == 0 &&
+            header.version == COOKED_VERSION &&
+            cooked_texture_is_valid( &header )
+        ) {
+            data = cooked_copy_data( &file, sizeof(header), header.data_size );
+        }
+    }
+    cooked_close( &file );
+    if( !data ) {
+        TraceLog( LOG_WARNING, "ASSETS: cooked %s is invalid or stale!", path );
+        return false;
+    }
+
+    *out_image = {};
+    out_image->data    = data;
+    out_image->width   = header.width;
+    out_image->height  = header.height;
+    out_image->format  = header.format;
+    // NOTE(alicia): mip chain comes after base level so
+    // it can just be ignored if it isn't wanted.
+    out_image->mipmaps = mipmaps ? header.mipmaps : 1;
+    return true;
+}
+static bool load_cooked_wave( const char* path, Wave* out_wave ) {
+    CookedFile file;
+    if( !cooked_open( path, COOKED_WAVE_EXT, &file ) ) {
+        return false;
+    }
+
+    CookedWaveHeader header = {};
+    void* data = nullptr;
+    if( file.size >= (int)sizeof(header) ) {
+        memcpy( &header, file.data, sizeof(header) );
+        if(
+            memcmp( header.identifier, COOKED_WAVE_IDENTIFIER, 4 ) == 0 &&
+            header.version == COOKED_VERSION &&
+            cooked_wave_is_valid( &header )
+        ) {
+            data = cooked_copy_data( &file, sizeof(header), header.data_size );
+        }
+    }
+    cooked_close( &file );
+    if( !data ) {
+        TraceLog( LOG_WARNING, "ASSETS: cooked %s is invalid or stale!", path );
+        return false;
+    }
+
+    *out_wave = {};
+    out_wave->data       = data;
+    out_wave->frameCount = header.frame_count;
+    out_wave->sampleRate = header.sample_rate;
+    out_wave->sampleSize = header.sample_size;
+    out_wave->channels   = header.channels;
+    return true;
+}
+/// @brief Load texture, from cooked data if there is any.
+static Texture load_texture( const char* path, bool mipmaps ) {
+    Image image = {};
+    if( load_cooked_image( path, mipmaps, &image ) ) {
+        Texture result = LoadTextureFromImage( image );
+        UnloadImage( image );
+        return result;
+    }
+
+    Texture result = LoadTexture( path );
+    if( mipmaps ) {
+        GenTextureMipmaps( &result );
+    }
+    return result;
+}
+static Sound load_sound( const char* path ) {
+    Wave wave = {};
+    if( load_cooked_wave( path, &wave ) ) {
+        Sound result = LoadSoundFromWave( wave );
+        UnloadWave( wave );
+        return result;
+    }
+    return LoadSound( path );
+}
+
+// NOTE(alicia): called from any thread that uses LoadFileData,
+// including raylib's model loaders on worker threads.
+static unsigned char* assets_load_file_data( const char* path, int* out_size ) {
+    *out_size = 0;
+
+    auto* loader = global_assets;
+    if( loader ) {
+        unsigned char* result = nullptr;
+        assets_lock( loader );
+        for( int i = 0; i < ASSETS_MAX_REQUESTS; ++i ) {
+            auto* request = loader->requests + i;
+            if(
+                request->type != AssetType::FILE ||
+                assets_status( request ) != AssetStatus::DECODED ||
+                strcmp( request->path, path ) != 0
+            ) {
+                continue;
+            }
+
+            result = (unsigned char*)malloc( request->file.size );
+            if( result ) {
+                memcpy( result, request->file.data, request->file.size );
+                *out_size = request->file.size;
+            }
+            break;
+        }
+        assets_unlock( loader );
+
+        if( result ) {
+            return result;
+        }
+    }
+
+    return read_file( path, out_size );
+}
+
+static void asset_job( void* params ) {
+    auto* request = (AssetRequest*)params;
+
+    AssetStatus status = AssetStatus::FAILED;
+    switch( request->type ) {
+        case AssetType::FILE: {
+            request->file.data = read_file( request->path, &request->file.size );
+            if( request->file.data ) {
+                status = AssetStatus::DECODED;
+            }
+        } break;
+        case AssetType::IMAGE: {
+            if( load_cooked_image( request->path, request->mipmaps, &request->image ) ) {
+                status = AssetStatus::DECODED;
+                break;
+            }
+
+            // NOTE(alicia): packed files are decoded in place.
+            const unsigned char* packed = nullptr;
+            int size = 0;
+            if( pack_lookup( global_assets, request->path, &packed, &size ) ) {
+                request->image = LoadImageFromMemory(
+                    GetFileExtension( request->path ), packed, size );
+            } else {
+                unsigned char* bytes = read_file( request->path, &size );
+                if( !bytes ) {
+                    break;
+                }
+                request->image = LoadImageFromMemory(
+                    GetFileExtension( request->path ), bytes, size );
+                free( bytes );
+            }
+
+            if( request->image.data ) {
+                if( request->mipmaps ) {
+                    ImageMipmaps( &request->image );
+                }
+                status = AssetStatus::DECODED;
+            }
+        } break;
+        case AssetType::WAVE: {
+            if( load_cooked_wave( request->path, &request->wave ) ) {
+                status = AssetStatus::DECODED;
+                break;
+            }
+
+            const unsigned char* packed = nullptr;
+            int size = 0;
+            if( pack_lookup( global_assets, request->path, &packed, &size ) ) {
+                request->wave = LoadWaveFromMemory(
+                    GetFileExtension( request->path ), packed, size );
+            } else {
+                unsigned char* bytes = read_file( request->path, &size );
+                if( !bytes ) {
+                    break;
+                }
+                request->wave = LoadWaveFromMemory(
+                    GetFileExtension( request->path ), bytes, size );
+                free( bytes );
+            }
+
+            if( request->wave.data ) {
+                status = AssetStatus::DECODED;
+            }
+        } break;
+        case AssetType::ANIMATIONS: {
+            request->animations.buf = LoadModelAnimations(
+                request->path, &request->animations.len );
+            if( request->animations.buf ) {
+                status = AssetStatus::DECODED;
+            }
+        } break;
+    }
+
+    __atomic_store_n( (int*)&request->status, (int)status, __ATOMIC_RELEASE );
+}
+
+void assets_init( AssetLoader* loader ) {
+    if( mapped_file_open( PACK_PATH, &loader->pack ) ) {
+        if( !pack_is_valid( loader->pack.data, loader->pack.size ) ) {
+            TraceLog( LOG_ERROR, "%s is an invalid pack file!", PACK_PATH );
+            mapped_file_close( &loader->pack );
+        }
+    }
+
+    global_assets = loader;
+    SetLoadFileDataCallback( assets_load_file_data );
+}
+void assets_shutdown( AssetLoader* loader ) {
+    for( int i = 0; i < ASSETS_MAX_CACHED; ++i ) {
+        loader->cache[i].refcount = 0;
+    }
+    assets_evict( loader, 0 );
+
+    for( int i = 0; i < ASSETS_MAX_REQUESTS; ++i ) {
+        if( loader->requests[i].status != AssetStatus::NONE ) {
+            assets_release( loader, i );
+        }
+    }
+    SetLoadFileDataCallback( nullptr );
+    global_assets = nullptr;
+
+    // NOTE(alicia): music streamed from pack has to be
+    // unloaded before this.
+    mapped_file_close( &loader->pack );
+}
+
+bool assets_file_exists( AssetLoader* loader, const char* path ) {
+    if( loader->pack.data && pack_find( loader->pack.data, path ) ) {
+        return true;
+    }
+    return FileExists( path );
+}
+bool assets_file_view( AssetLoader* loader, const char* path, MappedFile* out_file ) {
+    const unsigned char* packed = nullptr;
+    int size = 0;
+    if( pack_lookup( loader, path, &packed, &size ) ) {
+        *out_file = {};
+        out_file->data    = (void*)packed;
+        out_file->size    = size;
+        out_file->is_view = true;
+        return true;
+    }
+    return mapped_file_open( path, out_file );
+}
+Music assets_load_music( AssetLoader* loader, const char* path ) {
+    const unsigned char* packed = nullptr;
+    int size = 0;
+    if( pack_lookup( loader, path, &packed, &size ) ) {
+        return LoadMusicStreamFromMemory( GetFileExtension( path ), packed, size );
+    }
+    return LoadMusicStream( path );
+}
+Texture assets_load_texture( AssetLoader* loader, const char* path, bool mipmaps ) {
+    // NOTE(alicia): cooked lookups go through global loader.
+    (void)loader;
+    return load_texture( path, mipmaps );
+}
+
+int assets_request(
+    AssetLoader* loader, AssetType type, const char* path, bool mipmaps
+) {
+    if( strlen( path ) >= ASSETS_MAX_PATH ) {
+        return -1;
+    }
+
+    assets_lock( loader );
+    int free_slot = -1;
+    for( int i = 0; i < ASSETS_MAX_REQUESTS; ++i ) {
+        auto* request = loader->requests + i;
+        if( request->status == AssetStatus::NONE ) {
+            if( free_slot < 0 ) {
+                free_slot = i;
+            }
+            continue;
+        }
+
+        if(
+            request->type == type && request->mipmaps == mipmaps &&
+            strcmp( request->path, path ) == 0
+        ) {
+            assets_unlock( loader );
+            return i;
+        }
+    }
+
+    if( free_slot < 0 ) {
+        assets_unlock( loader );
+        return -1;
+    }
+
+    auto* request = loader->requests + free_slot;
+    memset( request, 0, sizeof(*request) );
+    request->type    = type;
+    request->mipmaps = mipmaps;
+    request->status  = AssetStatus::QUEUED;
+    strcpy( request->path, path );
+    assets_unlock( loader );
+
+    jobs_submit( &request->counter, asset_job, request );
+    return free_slot;
+}
+
+bool assets_is_ready( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return true;
+    }
+    return assets_status( loader->requests + handle ) != AssetStatus::QUEUED;
+}
+void assets_wait( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return;
+    }
+    jobs_wait( &loader->requests[handle].counter );
+}
+
+Texture assets_take_texture( AssetLoader* loader, int handle ) {
+    Texture result = {};
+    if( handle < 0 ) {
+        return result;
+    }
+    assets_wait( loader, handle );
+
+    auto* request = loader->requests + handle;
+    if( request->status == AssetStatus::DECODED ) {
+        result = LoadTextureFromImage( request->image );
+    } else {
+        result = load_texture( request->path, request->mipmaps );
+    }
+
+    assets_release( loader, handle );
+    return result;
+}
+Sound assets_take_sound( AssetLoader* loader, int handle ) {
+    Sound result = {};
+    if( handle < 0 ) {
+        return result;
+    }
+    assets_wait( loader, handle );
+
+    auto* request = loader->requests + handle;
+    if( request->status == AssetStatus::DECODED ) {
+        result = LoadSoundFromWave( request->wave );
+    } else {
+        result = load_sound( request->path );
+    }
+
+    assets_release( loader, handle );
+    return result;
+}
+ModelAnimation* assets_take_animations(
+    AssetLoader* loader, int handle, int* out_count
+) {
+    *out_count = 0;
+    if( handle < 0 ) {
+        return nullptr;
+    }
+    assets_wait( loader, handle );
+
+    auto* request = loader->requests + handle;
+
+    ModelAnimation* result = nullptr;
+    if( request->status == AssetStatus::DECODED ) {
+        result     = request->animations.buf;
+        *out_count = request->animations.len;
+        request->animations.buf = nullptr;
+        request->animations.len = 0;
+    } else {
+        result = LoadModelAnimations( request->path, out_count );
+    }
+
+    assets_release( loader, handle );
+    return result;
+}
+void assets_release( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return;
+    }
+    assets_wait( loader, handle );
+
+    auto* request = loader->requests + handle;
+
+    assets_lock( loader );
+    if( request->status == AssetStatus::DECODED ) {
+        switch( request->type ) {
+            case AssetType::FILE: {
+                free( request->file.data );
+            } break;
+            case AssetType::IMAGE: {
+                UnloadImage( request->image );
+            } break;
+            case AssetType::WAVE: {
+                UnloadWave( request->wave );
+            } break;
+            case AssetType::ANIMATIONS: {
+                if( request->animations.buf ) {
+                    UnloadModelAnimations(
+                        request->animations.buf, request->animations.len );
+                }
+            } break;
+        }
+    }
+    request->status = AssetStatus::NONE;
+    assets_unlock( loader );
+}
+
+int assets_acquire(
+    AssetLoader* loader, CachedAssetType type, const char* path, bool mipmaps
+) {
+    if( strlen( path ) >= ASSETS_MAX_PATH ) {
+        return -1;
+    }
+
+    int free_slot = -1;
+    for( int i = 0; i < ASSETS_MAX_CACHED; ++i ) {
+        auto* entry = loader->cache + i;
+        if( !entry->is_used ) {
+            if( free_slot < 0 ) {
+                free_slot = i;
+            }
+            continue;
+        }
+        if(
+            entry->type == type && entry->mipmaps == mipmaps &&
+            strcmp( entry->path, path ) == 0
+        ) {
+            entry->refcount++;
+            return i;
+        }
+    }
+
+    if( free_slot < 0 ) {
+        return -1;
+    }
+
+    auto* entry = loader->cache + free_slot;
+    memset( entry, 0, sizeof(*entry) );
+    entry->type     = type;
+    entry->is_used  = true;
+    entry->mipmaps  = mipmaps;
+    entry->refcount = 1;
+    entry->request  = -1;
+    strcpy( entry->path, path );
+    return free_slot;
+}
+void assets_unref( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return;
+    }
+    auto* entry = loader->cache + handle;
+    if( entry->refcount > 0 ) {
+        entry->refcount--;
+    }
+}
+void assets_prefetch( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return;
+    }
+    auto* entry = loader->cache + handle;
+    if( entry->is_resident || entry->request >= 0 ) {
+        return;
+    }
+
+    AssetType type = AssetType::FILE;
+    switch( entry->type ) {
+        case CachedAssetType::TEXTURE: {
+            type = AssetType::IMAGE;
+        } break;
+        case CachedAssetType::MODEL: {
+            // NOTE(alicia): LoadModel uploads to GPU so only
+            // file data can be prefetched.
+            type = AssetType::FILE;
+        } break;
+        case CachedAssetType::SOUND: {
+            type = AssetType::WAVE;
+        } break;
+        case CachedAssetType::ANIMATIONS: {
+            type = AssetType::ANIMATIONS;
+        } break;
+    }
+    entry->request = assets_request( loader, type, entry->path, entry->mipmaps );
+}
+bool assets_prefetch_ready( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return true;
+    }
+    auto* entry = loader->cache + handle;
+    return entry->is_resident || assets_is_ready( loader, entry->request );
+}
+void assets_cancel_prefetch( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return;
+    }
+    auto* entry = loader->cache + handle;
+    if( entry->is_resident || entry->request < 0 || entry->refcount > 1 ) {
+        return;
+    }
+    assets_release( loader, entry->request );
+    entry->request = -1;
+}
+
+static CachedAsset* cache_touch( AssetLoader* loader, int handle ) {
+    auto* entry = loader->cache + handle;
+    entry->last_used = ++loader->use_counter;
+    return entry;
+}
+static void cache_resident( AssetLoader* loader, CachedAsset* entry, size_t size ) {
+    entry->request     = -1;
+    entry->is_resident = true;
+    entry->size        = size;
+    loader->resident_size += size;
+}
+
+Texture assets_texture( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return {};
+    }
+    auto* entry = cache_touch( loader, handle );
+    if( entry->is_resident ) {
+        return entry->texture;
+    }
+
+    if( entry->request >= 0 ) {
+        entry->texture = assets_take_texture( loader, entry->request );
+    } else {
+        entry->texture = load_texture( entry->path, entry->mipmaps );
+    }
+
+    size_t size = (size_t)entry->texture.width * entry->texture.height * 4;
+    if( entry->texture.mipmaps > 1 ) {
+        size += size / 3;
+    }
+    cache_resident( loader, entry, size );
+    return entry->texture;
+}
+Model assets_model( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return {};
+    }
+    auto* entry = cache_touch( loader, handle );
+    if( entry->is_resident ) {
+        return entry->model;
+    }
+
+    // NOTE(alicia): LoadModel reads prefetched file data
+    // through LoadFileData callback.
+    assets_wait( loader, entry->request );
+    entry->model = LoadModel( entry->path );
+    assets_release( loader, entry->request );
+
+    size_t size = 0;
+    for( int i = 0; i < entry->model.meshCount; ++i ) {
+        auto* mesh = entry->model.meshes + i;
+        // NOTE(alicia): positions, normals and texcoords, roughly.
+        size += (size_t)mesh->vertexCount * sizeof(float) * 8;
+        size += (size_t)mesh->triangleCount * 3 * sizeof(unsigned short);
+    }
+    cache_resident( loader, entry, size );
+    return entry->model;
+}
+Sound assets_sound( AssetLoader* loader, int handle ) {
+    if( handle < 0 ) {
+        return {};
+    }
+    auto* entry = cache_touch( loader, handle );
+    if( entry->is_resident ) {
+        return entry->sound;
+    }
+
+    if( entry->request >= 0 ) {
+        entry->sound = assets_take_sound( loader, entry->request );
+    } else {
+        entry->sound = load_sound( entry->path );
+    }
+
+    size_t size =
+        (size_t)entry->sound.frameCount *
+        entry->sound.stream.channels * (entry->sound.stream.sampleSize / 8);
+    cache_resident( loader, entry, size );
+    return entry->sound;
+}
+ModelAnimation* assets_animations(
+    AssetLoader* loader, int handle, int* out_count
+) {
+    *out_count = 0;
+    if( handle < 0 ) {
+        return nullptr;
+    }
+    auto* entry = cache_touch( loader, handle );
+    if( !entry->is_resident ) {
+        if( entry->request >= 0 ) {
+            entry->animations.buf = assets_take_animations(
+                loader, entry->request, &entry->animations.len );
+        } else {
+            entry->animations.buf = LoadModelAnimations(
+                entry->path, &entry->animations.len );
+        }
+
+        size_t size = 0;
+        for( int i = 0; i < entry->animations.len; ++i ) {
+            auto* anim = entry->animations.buf + i;
+            size += (size_t)anim->frameCount * anim->boneCount * sizeof(Transform);
+        }
+        cache_resident( loader, entry, size );
+    }
+
+    *out_count = entry->animations.len;
+    return entry->animations.buf;
+}
+
+static void cache_unload( AssetLoader* loader, CachedAsset* entry ) {
+    switch( entry->type ) {
+        case CachedAssetType::TEXTURE: {
+            UnloadTexture( entry->texture );
+        } break;
+        case CachedAssetType::MODEL: {
+            UnloadModel( entry->model );
+        } break;
+        case CachedAssetType::SOUND: {
+            UnloadSound( entry->sound );
+        } break;
+        case CachedAssetType::ANIMATIONS: {
+            if( entry->animations.buf ) {
+                UnloadModelAnimations( entry->animations.buf, entry->animations.len );
+            }
+        } break;
+    }
+    loader->resident_size -= entry->size;
+    entry->is_resident = false;
+    entry->size        = 0;
+}
+void assets_evict( AssetLoader* loader, size_t budget ) {
+    while( loader->resident_size > budget ) {
+        int oldest = -1;
+        for( int i = 0; i < ASSETS_MAX_CACHED; ++i ) {
+            auto* entry = loader->cache + i;
+            if( !entry->is_resident || entry->refcount ) {
+                continue;
+            }
+            if( oldest < 0 || entry->last_used < loader->cache[oldest].last_used ) {
+                oldest = i;
+            }
+        }
+        if( oldest < 0 ) {
+            break;
+        }
+        cache_unload( loader, loader->cache + oldest );
+    }
+
+    // NOTE(alicia): free slots that hold nothing and aren't referenced.
+    for( int i = 0; i < ASSETS_MAX_CACHED; ++i ) {
+        auto* entry = loader->cache + i;
+        if(
+            entry->is_used && !entry->is_resident &&
+            !entry->refcount && entry->request < 0
+        ) {
+            entry->is_used = false;
+        }
+    }
+}
+
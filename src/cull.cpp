@@ -0,0 +1,164 @@
+/**
+ * @file   cull.cpp
+ * @brief  CPU frustum and fog distance culling.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 10, 2025
+*/
+#include "cull.h"
+#include "raymath.h"
+#include "shared/buffer.h"
+#include <math.h>
+#include <stdlib.h>
+
+float fog_cull_distance( float density, float threshold ) {
+    return -logf( threshold ) / density;
+}
+
+static Vector4 plane_normalize( Vector4 plane ) {
+    float length = sqrtf( (plane.x * plane.x) + (plane.y * plane.y) + (plane.z * plane.z) );
+    if( length <= 0.0f ) {
+        return plane;
+    }
+    return Vector4{ plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+}
+
+Frustum frustum_from_camera( const Camera3D& camera, float aspect, float near, float far ) {
+    Matrix view       = MatrixLookAt( camera.position, camera.target, camera.up );
+    Matrix projection = MatrixPerspective( camera.fovy * DEG2RAD, aspect, near, far );
+    Matrix m          = MatrixMultiply( view, projection );
+
+    // NOTE(alicia): rows of clip matrix, planes are extracted
+    // as in Gribb and Hartmann's method.
+    Vector4 row0 = { m.m0, m.m4, m.m8,  m.m12 };
+    Vector4 row1 = { m.m1, m.m5, m.m9,  m.m13 };
+    Vector4 row2 = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 row3 = { m.m3, m.m7, m.m11, m.m15 };
+
+    Frustum result = {};
+    result.planes[0] = plane_normalize( row3 + row0 );
+    result.planes[1] = plane_normalize( row3 - row0 );
+    result.planes[2] = plane_normalize( row3 + row1 );
+    result.planes[3] = plane_normalize( row3 - row1 );
+    result.planes[4] = plane_normalize( row3 + row2 );
+    result.planes[5] = plane_normalize( row3 - row2 );
+    return result;
+}
+bool frustum_test_sphere( const Frustum* frustum, Vector3 center, float radius ) {
+    for( int i = 0; i < 6; ++i ) {
+        Vector4 p = frustum->planes[i];
+        if( (p.x * center.x) + (p.y * center.y) + (p.z * center.z) + p.w < -radius ) {
+            return false;
+        }
+    }
+    return true;
+}
+bool frustum_test_box( const Frustum* frustum, BoundingBox box ) {
+    for( int i = 0; i < 6; ++i ) {
+        Vector4 p = frustum->planes[i];
+
+        // NOTE(alicia): corner furthest along plane normal.
+        Vector3 corner = {
+            p.x >= 0.0f ? box.max.x : box.min.x,
+            p.y >= 0.0f ? box.max.y : box.min.y,
+            p.z >= 0.0f ? box.max.z : box.min.z,
+        };
+        if( (p.x * corner.x) + (p.y * corner.y) + (p.z * corner.z) + p.w < 0.0f ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool box_within_distance( BoundingBox box, Vector3 point, float distance ) {
+    Vector3 closest = Vector3Clamp( point, box.min, box.max );
+    return Vector3DistanceSqr( closest, point ) <= distance * distance;
+}
+
+BoundingBox object_cull_bounds( ObjectType type ) {
+    switch( type ) {
+        case ObjectType::ENEMY: {
+            // NOTE(alicia): bot mesh plus room for attack animations.
+            return BoundingBox{ { -1.5, 0.0, -1.5 }, { 1.5, 3.0, 1.5 } };
+        } break;
+        case ObjectType::BATTERY: {
+            // NOTE(alicia): spin and bob happen in vertex shader.
+            return BoundingBox{ { -1.0, -1.0, -1.0 }, { 1.0, 1.5, 1.0 } };
+        } break;
+        case ObjectType::LEVEL_EXIT: {
+            return BoundingBox{ { -1.5, 0.0, -1.5 }, { 1.5, 26.0, 1.5 } };
+        } break;
+        case ObjectType::NONE:
+        case ObjectType::PLAYER_SPAWN:
+        case ObjectType::COUNT: break;
+    }
+    return BoundingBox{};
+}
+
+void cull_objects(
+    const Frustum* frustum, const Pvs* pvs, Vector3 camera_position, float far,
+    const Object* objects, int object_count,
+    CullList* out_visible, CullStats* stats
+) {
+    out_visible->len = 0;
+    for( int i = 0; i < object_count; ++i ) {
+        const Object* obj = objects + i;
+        if( !obj->is_active ) {
+            continue;
+        }
+
+        switch( obj->type ) {
+            case ObjectType::ENEMY:
+            case ObjectType::BATTERY:
+            case ObjectType::LEVEL_EXIT: break;
+
+            case ObjectType::NONE:
+            case ObjectType::PLAYER_SPAWN:
+            case ObjectType::COUNT: continue;
+        }
+
+        BoundingBox bounds = object_cull_bounds( obj->type );
+        bounds.min += obj->position;
+        bounds.max += obj->position;
+
+        if(
+            box_within_distance( bounds, camera_position, far ) &&
+            frustum_test_box( frustum, bounds ) &&
+            (!pvs || pvs_box_visible(
+                pvs, { bounds.min.x, bounds.min.z }, { bounds.max.x, bounds.max.z } ))
+        ) {
+            buf_append( out_visible, i );
+            stats->objects_drawn++;
+        } else {
+            stats->objects_culled++;
+        }
+    }
+}
+void cull_walls(
+    const Frustum* frustum, const Pvs* pvs, Vector3 camera_position, float far,
+    const WallChunk* chunks, int chunk_count,
+    CullList* out_visible, CullStats* stats
+) {
+    out_visible->len = 0;
+    for( int i = 0; i < chunk_count; ++i ) {
+        const WallChunk* chunk = chunks + i;
+        if(
+            (!pvs || pvs_chunk_visible( pvs, i )) &&
+            box_within_distance( chunk->bounds, camera_position, far ) &&
+            frustum_test_box( frustum, chunk->bounds )
+        ) {
+            buf_append( out_visible, i );
+            stats->chunks_drawn++;
+            stats->walls_drawn += chunk->segment_count;
+        } else {
+            stats->chunks_culled++;
+            stats->walls_culled += chunk->segment_count;
+        }
+    }
+}
+
+void cull_list_free( CullList* list ) {
+    if( list->buf ) {
+        free( list->buf );
+    }
+    *list = {};
+}
@@ -0,0 +1,103 @@
+/**
+ * @file   dynamic_resolution.cpp
+ * @brief  Scale 3D resolution to keep frame time under budget.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "dynamic_resolution.h"
+#include "raymath.h"
+
+static float dynamic_resolution_budget() {
+    // NOTE(alicia): vsync is on so budget is one refresh.
+    int refresh_rate = GetMonitorRefreshRate( GetCurrentMonitor() );
+    if( refresh_rate <= 0 ) {
+        refresh_rate = 60;
+    }
+    return 1.0f / (float)refresh_rate;
+}
+
+static void dynamic_resolution_set(
+    DynamicResolution* dr, float scale, bool is_raise
+) {
+    // NOTE(alicia): snap to step so repeated steps don't drift.
+    scale = roundf( scale / DYNAMIC_RESOLUTION_STEP ) * DYNAMIC_RESOLUTION_STEP;
+    dr->scale                = Clamp( scale, DYNAMIC_RESOLUTION_MIN_SCALE, 1.0f );
+    dr->over_time            = 0.0f;
+    dr->under_time           = 0.0f;
+    dr->since_change         = 0.0f;
+    dr->is_last_change_raise = is_raise;
+}
+
+void dynamic_resolution_update(
+    DynamicResolution* dr, float dt, bool is_enabled
+) {
+    if( dr->budget <= 0.0f ) {
+        dr->budget     = dynamic_resolution_budget();
+        dr->frame_time = dr->budget;
+        dr->raise_time = DYNAMIC_RESOLUTION_RAISE_TIME;
+        dynamic_resolution_set( dr, 1.0f, false );
+    }
+    if( !is_enabled ) {
+        if( dr->scale < 1.0f ) {
+            dynamic_resolution_set( dr, 1.0f, false );
+        }
+        dr->raise_time = DYNAMIC_RESOLUTION_RAISE_TIME;
+        return;
+    }
+
+    // NOTE(alicia): long frames from loading aren't GPU load,
+    // clamp them so they don't drag smoothed time for seconds.
+    float sample   = fminf( dt, dr->budget * 4.0f );
+    dr->frame_time = Lerp( dr->frame_time, sample, DYNAMIC_RESOLUTION_SMOOTHING );
+
+    dr->since_change += dt;
+    if( dr->since_change < DYNAMIC_RESOLUTION_SETTLE_TIME ) {
+        return;
+    }
+
+    if( dr->frame_time > dr->budget * DYNAMIC_RESOLUTION_OVER ) {
+        dr->over_time += dt;
+        dr->under_time = 0.0f;
+    } else if( dr->frame_time < dr->budget * DYNAMIC_RESOLUTION_UNDER ) {
+        dr->under_time += dt;
+        dr->over_time   = 0.0f;
+    } else {
+        dr->over_time  = 0.0f;
+        dr->under_time = 0.0f;
+    }
+
+    if(
+        dr->is_last_change_raise &&
+        dr->since_change >= DYNAMIC_RESOLUTION_RAISE_HOLD_TIME
+    ) {
+        // NOTE(alicia): raise held, next one can come sooner.
+        dr->raise_time           = DYNAMIC_RESOLUTION_RAISE_TIME;
+        dr->is_last_change_raise = false;
+    }
+
+    if(
+        dr->over_time >= DYNAMIC_RESOLUTION_LOWER_TIME &&
+        dr->scale > DYNAMIC_RESOLUTION_MIN_SCALE
+    ) {
+        // NOTE(alicia): with vsync on frame time can't show
+        // how much headroom there is so raising scale is a guess.
+        // Back off every time a guess is wrong so scale doesn't
+        // flip between two steps.
+        if( dr->is_last_change_raise ) {
+            dr->raise_time = fminf(
+                dr->raise_time * 2.0f, DYNAMIC_RESOLUTION_RAISE_TIME_MAX );
+        }
+        dynamic_resolution_set( dr, dr->scale - DYNAMIC_RESOLUTION_STEP, false );
+    } else if( dr->under_time >= dr->raise_time && dr->scale < 1.0f ) {
+        dynamic_resolution_set( dr, dr->scale + DYNAMIC_RESOLUTION_STEP, true );
+    }
+}
+
+Rectangle dynamic_resolution_viewport( const DynamicResolution* dr, Texture target ) {
+    float scale = dr->scale > 0.0f ? dr->scale : 1.0f;
+    return {
+        0.0f, 0.0f,
+        fmaxf( roundf( (float)target.width  * scale ), 1.0f ),
+        fmaxf( roundf( (float)target.height * scale ), 1.0f )
+    };
+}
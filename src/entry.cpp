@@ -14,6 +14,8 @@
 #include "gui.h"
 #include "shaders.h"
 #include "globals.h"
+#include "jobs.h"
+#include "assets.h"
 
 #include <string.h>
 
@@ -40,19 +42,74 @@ bool initialize() {
     memset( global_state, 0, sizeof(*global_state) );
     auto* state = global_state;
 
-    state->sh_basic_shading = LoadShaderFromMemory( basic_shading_vert, basic_shading_frag );
+    if( !jobs_init() ) {
+        TraceLog( LOG_WARNING, "Failed to start worker threads, jobs will run on main thread." );
+    }
+    assets_init( &state->persistent.assets );
+
+    state->sh_basic_shading = shader_load_permutation(
+        basic_shading_vert, basic_shading_frag, SHADER_PERMUTATION_NONE );
     state->sh_basic_shading_loc_camera_position =
         GetShaderLocation( state->sh_basic_shading, "camera_position" );
+    state->sh_basic_shading_loc_fog_far =
+        GetShaderLocation( state->sh_basic_shading, "fog_far" );
 
-    state->sh_wall = LoadShaderFromMemory( basic_shading_vert, basic_shading_wall_frag );
+    state->sh_wall = shader_load_permutation(
+        basic_shading_vert, basic_shading_frag,
+        SHADER_PERMUTATION_DISTANCE_FOG | SHADER_PERMUTATION_WRAP_UV );
     state->sh_wall_loc_camera_position =
         GetShaderLocation( state->sh_wall, "camera_position" );
-    state->sh_wall_loc_dist =
-        GetShaderLocation( state->sh_wall, "dist" );
-    state->sh_wall_loc_apply_dist =
-        GetShaderLocation( state->sh_wall, "apply_dist" );
     state->sh_wall_loc_clipping_planes =
         GetShaderLocation( state->sh_wall, "clipping_planes" );
+    state->sh_wall_loc_fog_far =
+        GetShaderLocation( state->sh_wall, "fog_far" );
+
+    state->sh_floor = shader_load_permutation(
+        basic_shading_vert, basic_shading_frag, SHADER_PERMUTATION_DISTANCE_FOG );
+    state->sh_floor_loc_camera_position =
+        GetShaderLocation( state->sh_floor, "camera_position" );
+    state->sh_floor_loc_fog_far =
+        GetShaderLocation( state->sh_floor, "fog_far" );
+
+    state->sh_instanced = shader_load_permutation(
+        basic_shading_vert, basic_shading_frag, SHADER_PERMUTATION_INSTANCED );
+    state->sh_instanced_loc_camera_position =
+        GetShaderLocation( state->sh_instanced, "camera_position" );
+    state->sh_instanced_loc_fog_far =
+        GetShaderLocation( state->sh_instanced, "fog_far" );
+    // NOTE(alicia): DrawMeshInstanced binds instance transforms to model matrix location.
+    state->sh_instanced.locs[SHADER_LOC_MATRIX_MODEL] =
+        GetShaderLocationAttrib( state->sh_instanced, "instanceTransform" );
+
+    state->sh_instanced_bob = shader_load_permutation(
+        basic_shading_vert, basic_shading_frag,
+        SHADER_PERMUTATION_INSTANCED | SHADER_PERMUTATION_BOB );
+    state->sh_instanced_bob_loc_camera_position =
+        GetShaderLocation( state->sh_instanced_bob, "camera_position" );
+    state->sh_instanced_bob_loc_bob_time =
+        GetShaderLocation( state->sh_instanced_bob, "bob_time" );
+    state->sh_instanced_bob_loc_fog_far =
+        GetShaderLocation( state->sh_instanced_bob, "fog_far" );
+    state->sh_instanced_bob.locs[SHADER_LOC_MATRIX_MODEL] =
+        GetShaderLocationAttrib( state->sh_instanced_bob, "instanceTransform" );
+
+    // NOTE(alicia): cull distance, everything past it has faded out.
+    float fog_far = fog_cull_distance( FOG_DENSITY, FOG_CULL_THRESHOLD );
+    SetShaderValue(
+        state->sh_basic_shading, state->sh_basic_shading_loc_fog_far,
+        &fog_far, SHADER_UNIFORM_FLOAT );
+    SetShaderValue(
+        state->sh_wall, state->sh_wall_loc_fog_far,
+        &fog_far, SHADER_UNIFORM_FLOAT );
+    SetShaderValue(
+        state->sh_floor, state->sh_floor_loc_fog_far,
+        &fog_far, SHADER_UNIFORM_FLOAT );
+    SetShaderValue(
+        state->sh_instanced, state->sh_instanced_loc_fog_far,
+        &fog_far, SHADER_UNIFORM_FLOAT );
+    SetShaderValue(
+        state->sh_instanced_bob, state->sh_instanced_bob_loc_fog_far,
+        &fog_far, SHADER_UNIFORM_FLOAT );
 
     state->sh_post_process = LoadShaderFromMemory( 0, post_process_frag );
     state->sh_post_process_loc_resolution =
@@ -140,6 +197,7 @@ void mode_unload( GlobalState* state, Mode mode ) {
     }
 
     memset( &state->transient, 0, sizeof(state->transient) );
+    assets_evict( &state->persistent.assets, ASSETS_CACHE_BUDGET );
 
     TraceLog( LOG_INFO, "Unloaded mode %s.", to_string(mode) );
 }
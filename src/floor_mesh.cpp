@@ -0,0 +1,771 @@
+/**
+ * @file   floor_mesh.cpp
+ * @brief  Floor and ceiling meshes triangulated from level outline.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "floor_mesh.h"
+#include "raymath.h"
+#include "shared/buffer.h"
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct FloorEdge {
+    int a, b;
+};
+struct FloorSplit {
+    int     edge;
+    float   t;
+    Vector2 point;
+};
+struct FloorWeldItem {
+    long long x, y;
+    int       point;
+};
+struct FloorAngleItem {
+    float angle;
+    int   half;
+};
+struct FloorFace {
+    int   first;
+    int   count;
+    int   component;
+    float area;
+};
+
+static int floor_split_cmp( const void* a, const void* b ) {
+    auto* lhs = (const FloorSplit*)a;
+    auto* rhs = (const FloorSplit*)b;
+    if( lhs->edge != rhs->edge ) {
+        return lhs->edge - rhs->edge;
+    }
+    return lhs->t < rhs->t ? -1 : (lhs->t > rhs->t ? 1 : 0);
+}
+static int floor_weld_cmp( const void* a, const void* b ) {
+    auto* lhs = (const FloorWeldItem*)a;
+    auto* rhs = (const FloorWeldItem*)b;
+    if( lhs->x != rhs->x ) {
+        return lhs->x < rhs->x ? -1 : 1;
+    }
+    if( lhs->y != rhs->y ) {
+        return lhs->y < rhs->y ? -1 : 1;
+    }
+    return lhs->point - rhs->point;
+}
+static int floor_edge_cmp( const void* a, const void* b ) {
+    auto* lhs = (const FloorEdge*)a;
+    auto* rhs = (const FloorEdge*)b;
+    if( lhs->a != rhs->a ) {
+        return lhs->a - rhs->a;
+    }
+    return lhs->b - rhs->b;
+}
+static int floor_edge_min_x_cmp( const void* a, const void* b ) {
+    auto* lhs = (const Vector2*)a;
+    auto* rhs = (const Vector2*)b;
+    float lhs_x = fminf( lhs[0].x, lhs[1].x );
+    float rhs_x = fminf( rhs[0].x, rhs[1].x );
+    return lhs_x < rhs_x ? -1 : (lhs_x > rhs_x ? 1 : 0);
+}
+static int floor_angle_cmp( const void* a, const void* b ) {
+    auto* lhs = (const FloorAngleItem*)a;
+    auto* rhs = (const FloorAngleItem*)b;
+    if( lhs->angle != rhs->angle ) {
+        return lhs->angle < rhs->angle ? -1 : 1;
+    }
+    return lhs->half - rhs->half;
+}
+
+static float floor_cross( Vector2 a, Vector2 b ) {
+    return (a.x * b.y) - (a.y * b.x);
+}
+static float floor_signed_area( const Vector2* points, const int* ids, int count ) {
+    float area = 0.0f;
+    for( int i = 0; i < count; ++i ) {
+        Vector2 a = points[ids[i]];
+        Vector2 b = points[ids[(i + 1) % count]];
+        area += floor_cross( a, b );
+    }
+    return area * 0.5f;
+}
+static int floor_find( int* parent, int x ) {
+    while( parent[x] != x ) {
+        parent[x] = parent[parent[x]];
+        x         = parent[x];
+    }
+    return x;
+}
+static bool floor_point_in_polygon(
+    Vector2 p, const Vector2* points, const int* ids, int count
+) {
+    bool is_inside = false;
+    for( int i = 0, j = count - 1; i < count; j = i++ ) {
+        Vector2 a = points[ids[i]];
+        Vector2 b = points[ids[j]];
+        if(
+            ((a.y > p.y) != (b.y > p.y)) &&
+            (p.x < (((b.x - a.x) * (p.y - a.y)) / (b.y - a.y)) + a.x)
+        ) {
+            is_inside = !is_inside;
+        }
+    }
+    return is_inside;
+}
+static bool floor_point_in_triangle( Vector2 p, Vector2 a, Vector2 b, Vector2 c ) {
+    // NOTE(alicia): points on triangle edges count as inside
+    // so that clipped triangles never overlap the rest of polygon.
+    return
+        floor_cross( b - a, p - a ) >= -FLOOR_MIN_AREA &&
+        floor_cross( c - b, p - b ) >= -FLOOR_MIN_AREA &&
+        floor_cross( a - c, p - c ) >= -FLOOR_MIN_AREA;
+}
+
+/// @brief Collect points where edges touch or cross each other.
+static void floor_find_splits(
+    const Vector2* edges, int edge_count,
+    FloorSplit** out_splits, int* out_split_count
+) {
+    struct {
+        FloorSplit* buf;
+        int         len;
+        int         cap;
+    } splits = {};
+
+    // NOTE(alicia): edges are sorted by min x so only edges
+    // that start before this one ends have to be checked.
+    for( int i = 0; i < edge_count; ++i ) {
+        Vector2 p = edges[(i * 2) + 0];
+        Vector2 r = edges[(i * 2) + 1] - p;
+        float   r_len = Vector2Length( r );
+        float   max_x = fmaxf( edges[(i * 2) + 0].x, edges[(i * 2) + 1].x );
+        float   i_min_y = fminf( edges[(i * 2) + 0].y, edges[(i * 2) + 1].y );
+        float   i_max_y = fmaxf( edges[(i * 2) + 0].y, edges[(i * 2) + 1].y );
+
+        for( int j = i + 1; j < edge_count; ++j ) {
+            Vector2 q = edges[(j * 2) + 0];
+            Vector2 s = edges[(j * 2) + 1] - q;
+            if( fminf( q.x, q.x + s.x ) > max_x + FLOOR_EPSILON ) {
+                break;
+            }
+            if(
+                fminf( q.y, q.y + s.y ) > i_max_y + FLOOR_EPSILON ||
+                fmaxf( q.y, q.y + s.y ) < i_min_y - FLOOR_EPSILON
+            ) {
+                continue;
+            }
+            float s_len = Vector2Length( s );
+            float e_r   = FLOOR_EPSILON / r_len;
+            float e_s   = FLOOR_EPSILON / s_len;
+
+            float   denom = floor_cross( r, s );
+            Vector2 qp    = q - p;
+            if( fabsf( denom ) > FLOOR_MIN_AREA * r_len * s_len ) {
+                float t = floor_cross( qp, s ) / denom;
+                float u = floor_cross( qp, r ) / denom;
+                if( t < -e_r || t > 1.0f + e_r || u < -e_s || u > 1.0f + e_s ) {
+                    continue;
+                }
+                Vector2 point = p + (r * Clamp( t, 0.0f, 1.0f ));
+                if( t > e_r && t < 1.0f - e_r ) {
+                    buf_append( &splits, (FloorSplit{ i, t, point }) );
+                }
+                if( u > e_s && u < 1.0f - e_s ) {
+                    buf_append( &splits, (FloorSplit{ j, u, point }) );
+                }
+                continue;
+            }
+
+            // NOTE(alicia): parallel, only overlapping collinear edges split.
+            if( fabsf( floor_cross( qp, r ) ) > FLOOR_EPSILON * r_len ) {
+                continue;
+            }
+            for( int k = 0; k < 2; ++k ) {
+                Vector2 point = edges[(j * 2) + k];
+                float   t     = Vector2DotProduct( point - p, r ) / (r_len * r_len);
+                if( t > e_r && t < 1.0f - e_r ) {
+                    buf_append( &splits, (FloorSplit{ i, t, point }) );
+                }
+                point   = edges[(i * 2) + k];
+                float u = Vector2DotProduct( point - q, s ) / (s_len * s_len);
+                if( u > e_s && u < 1.0f - e_s ) {
+                    buf_append( &splits, (FloorSplit{ j, u, point }) );
+                }
+            }
+        }
+    }
+
+    if( splits.len ) {
+        qsort( splits.buf, splits.len, sizeof(FloorSplit), floor_split_cmp );
+    }
+    *out_splits      = splits.buf;
+    *out_split_count = splits.len;
+}
+
+/// @brief Ear clip counter clockwise polygon.
+/// @param ids Welded point of each polygon point, points in
+/// same place are never treated as inside of an ear.
+/// @return Area of emitted triangles.
+static float floor_ear_clip(
+    FloorOutline* outline, int first, int count, const int* ids
+) {
+    const Vector2* points = outline->points.buf + first;
+
+    int* prev = (int*)malloc( sizeof(int) * count * 2 );
+    int* next = prev + count;
+    for( int i = 0; i < count; ++i ) {
+        prev[i] = (i + count - 1) % count;
+        next[i] = (i + 1) % count;
+    }
+
+    float area      = 0.0f;
+    int   remaining = count;
+    int   i         = 0;
+    int   stall     = 0;
+    bool  is_forced = false;
+
+    #define drop_point( index ) do {\
+        next[prev[index]] = next[index];\
+        prev[next[index]] = prev[index];\
+        remaining--;\
+        stall = 0;\
+    } while(0)
+
+    #define emit_triangle( a, b, c ) do {\
+        buf_append( &outline->indexes, first + (a) );\
+        buf_append( &outline->indexes, first + (b) );\
+        buf_append( &outline->indexes, first + (c) );\
+        area += floor_cross( points[b] - points[a], points[c] - points[a] ) * 0.5f;\
+    } while(0)
+
+    while( remaining > 2 ) {
+        int a = prev[i];
+        int c = next[i];
+
+        float cross = floor_cross( points[i] - points[a], points[c] - points[i] );
+        // NOTE(alicia): collinear points and walls that join
+        // two loops have no area, drop them without a triangle.
+        if( fabsf( cross ) <= FLOOR_MIN_AREA || ids[a] == ids[i] || ids[i] == ids[c] ) {
+            drop_point( i );
+            i = a;
+            continue;
+        }
+
+        if( cross > 0.0f ) {
+            bool is_ear = true;
+            for( int p = next[c]; p != a; p = next[p] ) {
+                if( ids[p] == ids[a] || ids[p] == ids[i] || ids[p] == ids[c] ) {
+                    continue;
+                }
+                if( floor_point_in_triangle( points[p], points[a], points[i], points[c] ) ) {
+                    is_ear = false;
+                    break;
+                }
+            }
+            if( is_ear ) {
+                emit_triangle( a, i, c );
+                drop_point( i );
+                i = c;
+                continue;
+            }
+        }
+
+        i = c;
+        if( ++stall <= remaining ) {
+            continue;
+        }
+
+        // NOTE(alicia): went around without finding an ear, polygon
+        // must be touching itself somewhere. Clip any convex corner
+        // so that floor at least has no holes.
+        int convex = -1;
+        for( int j = 0, p = i; j < remaining; ++j, p = next[p] ) {
+            if( floor_cross( points[p] - points[prev[p]], points[next[p]] - points[p] ) > 0.0f ) {
+                convex = p;
+                break;
+            }
+        }
+        if( convex < 0 ) {
+            TraceLog( LOG_WARNING, "FLOOR: failed to clip polygon, %i points left", remaining );
+            break;
+        }
+        if( !is_forced ) {
+            TraceLog( LOG_WARNING, "FLOOR: polygon has no ears, forcing clip" );
+            is_forced = true;
+        }
+        a = prev[convex];
+        c = next[convex];
+        emit_triangle( a, convex, c );
+        drop_point( convex );
+        i = c;
+    }
+
+    #undef drop_point
+    #undef emit_triangle
+
+    free( prev );
+    return area;
+}
+
+bool floor_outline_build(
+    FloorOutline* outline, const Vector2* vertexes,
+    const MapFileSegment* segments, int segment_count
+) {
+    outline->points.len    = 0;
+    outline->indexes.len   = 0;
+    outline->polygons.len  = 0;
+    outline->polygon_area  = 0.0f;
+    outline->triangle_area = 0.0f;
+    if( !segment_count ) {
+        return false;
+    }
+
+    /* Collect Edges */
+    // NOTE(alicia): two points per edge.
+    Vector2* edges = (Vector2*)malloc( sizeof(Vector2) * 2 * segment_count );
+    int edge_count = 0;
+    for( int i = 0; i < segment_count; ++i ) {
+        Vector2 start = vertexes[segments[i].start];
+        Vector2 end   = vertexes[segments[i].end];
+        if( Vector2Distance( start, end ) <= FLOOR_EPSILON ) {
+            continue;
+        }
+        edges[(edge_count * 2) + 0] = start;
+        edges[(edge_count * 2) + 1] = end;
+        edge_count++;
+    }
+    qsort( edges, edge_count, sizeof(Vector2) * 2, floor_edge_min_x_cmp );
+
+    FloorSplit* splits      = nullptr;
+    int         split_count = 0;
+    floor_find_splits( edges, edge_count, &splits, &split_count );
+
+    /* Weld Points */
+    // NOTE(alicia): each edge is its start, its splits in order then its end.
+    int raw_count = (edge_count * 2) + split_count;
+    Vector2*       raw   = (Vector2*)malloc( sizeof(Vector2) * raw_count );
+    int*           weld  = (int*)malloc( sizeof(int) * raw_count );
+    FloorWeldItem* items = (FloorWeldItem*)malloc( sizeof(FloorWeldItem) * raw_count );
+    int* edge_first = (int*)malloc( sizeof(int) * (edge_count + 1) );
+
+    int raw_len = 0;
+    for( int i = 0, s = 0; i < edge_count; ++i ) {
+        edge_first[i] = raw_len;
+        raw[raw_len++] = edges[(i * 2) + 0];
+        for( ; s < split_count && splits[s].edge == i; ++s ) {
+            raw[raw_len++] = splits[s].point;
+        }
+        raw[raw_len++] = edges[(i * 2) + 1];
+    }
+    edge_first[edge_count] = raw_len;
+
+    for( int i = 0; i < raw_len; ++i ) {
+        items[i].x     = (long long)llroundf( raw[i].x / FLOOR_EPSILON );
+        items[i].y     = (long long)llroundf( raw[i].y / FLOOR_EPSILON );
+        items[i].point = i;
+    }
+    qsort( items, raw_len, sizeof(FloorWeldItem), floor_weld_cmp );
+
+    struct {
+        Vector2* buf;
+        int      len;
+        int      cap;
+    } positions = {};
+    for( int i = 0; i < raw_len; ++i ) {
+        if( !i || items[i].x != items[i - 1].x || items[i].y != items[i - 1].y ) {
+            buf_append( &positions, raw[items[i].point] );
+        }
+        weld[items[i].point] = positions.len - 1;
+    }
+
+    /* Unique Edges */
+    struct {
+        FloorEdge* buf;
+        int        len;
+        int        cap;
+    } unique = {};
+    for( int i = 0; i < edge_count; ++i ) {
+        for( int p = edge_first[i]; p + 1 < edge_first[i + 1]; ++p ) {
+            int a = weld[p];
+            int b = weld[p + 1];
+            if( a == b ) {
+                continue;
+            }
+            buf_append( &unique, (FloorEdge{ a < b ? a : b, a < b ? b : a }) );
+        }
+    }
+    if( unique.len ) {
+        qsort( unique.buf, unique.len, sizeof(FloorEdge), floor_edge_cmp );
+        int len = 1;
+        for( int i = 1; i < unique.len; ++i ) {
+            if( floor_edge_cmp( unique.buf + i, unique.buf + (len - 1) ) ) {
+                unique.buf[len++] = unique.buf[i];
+            }
+        }
+        unique.len = len;
+    }
+
+    free( edges );
+    free( splits );
+    free( raw );
+    free( weld );
+    free( items );
+    free( edge_first );
+
+    int point_count = positions.len;
+    int half_count  = unique.len * 2;
+
+    /* Prune Dangling Walls */
+    // NOTE(alicia): half edge h goes from origin to origin of h ^ 1.
+    int* origin  = (int*)malloc( sizeof(int) * (half_count + 1) );
+    int* degree  = (int*)calloc( point_count + 1, sizeof(int) );
+    int* offset  = (int*)calloc( point_count + 1, sizeof(int) );
+    int* out     = (int*)malloc( sizeof(int) * (half_count + 1) );
+    int* slot    = (int*)malloc( sizeof(int) * (half_count + 1) );
+    int* stack   = (int*)malloc( sizeof(int) * (point_count + 1) );
+    bool* is_alive   = (bool*)malloc( sizeof(bool) * (unique.len + 1) );
+    bool* is_visited = (bool*)calloc( half_count + 1, sizeof(bool) );
+
+    for( int e = 0; e < unique.len; ++e ) {
+        origin[(e * 2) + 0] = unique.buf[e].a;
+        origin[(e * 2) + 1] = unique.buf[e].b;
+        degree[unique.buf[e].a]++;
+        degree[unique.buf[e].b]++;
+        is_alive[e] = true;
+    }
+    for( int v = 0; v < point_count; ++v ) {
+        offset[v + 1] = offset[v] + degree[v];
+    }
+    {
+        int* fill = (int*)calloc( point_count + 1, sizeof(int) );
+        for( int h = 0; h < half_count; ++h ) {
+            int v = origin[h];
+            out[offset[v] + fill[v]++] = h;
+        }
+        free( fill );
+    }
+
+    // NOTE(alicia): dead ends enclose nothing, removing them
+    // can leave another dead end behind so keep going.
+    int stack_len = 0;
+    for( int v = 0; v < point_count; ++v ) {
+        if( degree[v] == 1 ) {
+            stack[stack_len++] = v;
+        }
+    }
+    while( stack_len ) {
+        int v = stack[--stack_len];
+        if( degree[v] != 1 ) {
+            continue;
+        }
+        for( int k = offset[v]; k < offset[v + 1]; ++k ) {
+            int e = out[k] / 2;
+            if( !is_alive[e] ) {
+                continue;
+            }
+            is_alive[e] = false;
+            degree[v]--;
+            int other = origin[out[k] ^ 1];
+            if( --degree[other] == 1 ) {
+                stack[stack_len++] = other;
+            }
+            break;
+        }
+    }
+
+    /* Sort Half Edges Around Points */
+    {
+        FloorAngleItem* angles = (FloorAngleItem*)malloc(
+            sizeof(FloorAngleItem) * (half_count + 1) );
+        for( int v = 0; v < point_count; ++v ) {
+            int len = 0;
+            for( int k = offset[v]; k < offset[v + 1]; ++k ) {
+                int h = out[k];
+                if( !is_alive[h / 2] ) {
+                    continue;
+                }
+                Vector2 d = positions.buf[origin[h ^ 1]] - positions.buf[v];
+                angles[len++] = FloorAngleItem{ atan2f( d.y, d.x ), h };
+            }
+            qsort( angles, len, sizeof(FloorAngleItem), floor_angle_cmp );
+            // NOTE(alicia): degree is now count of live half edges.
+            degree[v] = len;
+            for( int k = 0; k < len; ++k ) {
+                out[offset[v] + k] = angles[k].half;
+                slot[angles[k].half] = k;
+            }
+        }
+        free( angles );
+    }
+
+    /* Components */
+    // NOTE(alicia): union find, stack is reused as parent.
+    int* parent = stack;
+    for( int v = 0; v < point_count; ++v ) {
+        parent[v] = v;
+    }
+    for( int e = 0; e < unique.len; ++e ) {
+        if( !is_alive[e] ) {
+            continue;
+        }
+        int a = floor_find( parent, unique.buf[e].a );
+        int b = floor_find( parent, unique.buf[e].b );
+        if( a != b ) {
+            parent[a] = b;
+        }
+    }
+
+    /* Trace Faces */
+    // NOTE(alicia): next half edge turns as far right as it can,
+    // that walks bounded faces counter clockwise and outer
+    // boundary of each component clockwise.
+    struct {
+        int* buf;
+        int  len;
+        int  cap;
+    } face_points = {};
+    struct {
+        FloorFace* buf;
+        int        len;
+        int        cap;
+    } faces = {};
+
+    for( int start = 0; start < half_count; ++start ) {
+        if( !is_alive[start / 2] || is_visited[start] ) {
+            continue;
+        }
+        int first = face_points.len;
+        int h     = start;
+        do {
+            is_visited[h] = true;
+            buf_append( &face_points, origin[h] );
+
+            int v     = origin[h ^ 1];
+            int count = degree[v];
+            h = out[offset[v] + ((slot[h ^ 1] + count - 1) % count)];
+        } while( h != start && face_points.len - first <= half_count );
+
+        int   count = face_points.len - first;
+        float area  = floor_signed_area( positions.buf, face_points.buf + first, count );
+        if( area <= FLOOR_MIN_AREA ) {
+            face_points.len = first;
+            continue;
+        }
+        buf_append( &faces, (FloorFace{ first, count, floor_find( parent, origin[start] ), area }) );
+    }
+
+    /* Skip Nested Components */
+    // NOTE(alicia): pillars and rooms inside of rooms are already
+    // covered by face that they're in.
+    for( int f = 0; f < faces.len; ++f ) {
+        FloorFace* face = faces.buf + f;
+        Vector2 sample  = positions.buf[face_points.buf[face->first]];
+
+        bool is_nested = false;
+        for( int g = 0; g < faces.len; ++g ) {
+            FloorFace* other = faces.buf + g;
+            if( other->component == face->component ) {
+                continue;
+            }
+            if( floor_point_in_polygon(
+                sample, positions.buf, face_points.buf + other->first, other->count
+            ) ) {
+                is_nested = true;
+                break;
+            }
+        }
+        if( is_nested ) {
+            continue;
+        }
+
+        FloorPolygon polygon = {};
+        polygon.first_point = outline->points.len;
+        polygon.point_count = face->count;
+        polygon.first_index = outline->indexes.len;
+        polygon.area        = face->area;
+        for( int i = 0; i < face->count; ++i ) {
+            buf_append( &outline->points, positions.buf[face_points.buf[face->first + i]] );
+        }
+
+        float area = floor_ear_clip(
+            outline, polygon.first_point, polygon.point_count,
+            face_points.buf + face->first );
+        polygon.index_count = outline->indexes.len - polygon.first_index;
+
+        outline->polygon_area  += polygon.area;
+        outline->triangle_area += area;
+        buf_append( &outline->polygons, polygon );
+    }
+
+    free( origin );
+    free( degree );
+    free( offset );
+    free( out );
+    free( slot );
+    free( stack );
+    free( is_alive );
+    free( is_visited );
+    free( positions.buf );
+    free( unique.buf );
+    free( face_points.buf );
+    free( faces.buf );
+
+    return outline->indexes.len > 0;
+}
+void floor_outline_free( FloorOutline* outline ) {
+    if( outline->points.buf ) {
+        free( outline->points.buf );
+    }
+    if( outline->indexes.buf ) {
+        free( outline->indexes.buf );
+    }
+    if( outline->polygons.buf ) {
+        free( outline->polygons.buf );
+    }
+    *outline = {};
+}
+
+static Mesh floor_chunk_mesh(
+    const FloorOutline* outline, int first_polygon, int polygon_count,
+    int vertex_count, int index_count, bool is_ceiling
+) {
+    Mesh mesh = {};
+    mesh.vertexCount   = vertex_count;
+    mesh.triangleCount = index_count / 3;
+    // NOTE(alicia): UnloadMesh frees these with RL_FREE.
+    mesh.vertices  = (float*)MemAlloc( sizeof(float) * 3 * mesh.vertexCount );
+    mesh.normals   = (float*)MemAlloc( sizeof(float) * 3 * mesh.vertexCount );
+    mesh.texcoords = (float*)MemAlloc( sizeof(float) * 2 * mesh.vertexCount );
+    mesh.indices   = (unsigned short*)MemAlloc( sizeof(unsigned short) * index_count );
+
+    // NOTE(alicia): ceiling used to be floor rotated around x
+    // so its texture is mirrored along z.
+    float   height = is_ceiling ? CEILING_HEIGHT : 0.0f;
+    float   v_sign = is_ceiling ? -1.0f : 1.0f;
+    Vector3 normal = { 0.0f, is_ceiling ? -1.0f : 1.0f, 0.0f };
+
+    int vertex = 0;
+    int index  = 0;
+    for( int p = first_polygon; p < first_polygon + polygon_count; ++p ) {
+        const FloorPolygon* polygon = outline->polygons.buf + p;
+        int base = vertex;
+        for( int i = 0; i < polygon->point_count; ++i ) {
+            Vector2 point = outline->points.buf[polygon->first_point + i];
+
+            *(Vector3*)(mesh.vertices + (vertex * 3)) = { point.x, height, point.y };
+            *(Vector3*)(mesh.normals  + (vertex * 3)) = normal;
+            mesh.texcoords[(vertex * 2) + 0] =
+                (point.x * FLOOR_TEXTURE_SCALE) + 0.5f;
+            mesh.texcoords[(vertex * 2) + 1] =
+                (point.y * FLOOR_TEXTURE_SCALE * v_sign) + 0.5f;
+            vertex++;
+        }
+
+        // NOTE(alicia): triangles are counter clockwise looking down
+        // from above, that faces down so floor is flipped.
+        const int* indexes = outline->indexes.buf + polygon->first_index;
+        for( int i = 0; i < polygon->index_count; i += 3 ) {
+            int a = indexes[i + 0] - polygon->first_point;
+            int b = indexes[i + 1] - polygon->first_point;
+            int c = indexes[i + 2] - polygon->first_point;
+            if( !is_ceiling ) {
+                int tmp = b;
+                b = c;
+                c = tmp;
+            }
+            mesh.indices[index++] = (unsigned short)(base + a);
+            mesh.indices[index++] = (unsigned short)(base + b);
+            mesh.indices[index++] = (unsigned short)(base + c);
+        }
+    }
+
+    UploadMesh( &mesh, false );
+    return mesh;
+}
+
+static void floor_chunk_build(
+    FloorChunk* chunk, const FloorOutline* outline,
+    int first_polygon, int polygon_count
+) {
+    int vertex_count = 0;
+    int index_count  = 0;
+
+    Vector3 min = { FLT_MAX, 0.0f, FLT_MAX };
+    Vector3 max = { -FLT_MAX, CEILING_HEIGHT, -FLT_MAX };
+    for( int p = first_polygon; p < first_polygon + polygon_count; ++p ) {
+        const FloorPolygon* polygon = outline->polygons.buf + p;
+        vertex_count += polygon->point_count;
+        index_count  += polygon->index_count;
+        for( int i = 0; i < polygon->point_count; ++i ) {
+            Vector2 point = outline->points.buf[polygon->first_point + i];
+            min.x = fminf( min.x, point.x );
+            min.z = fminf( min.z, point.y );
+            max.x = fmaxf( max.x, point.x );
+            max.z = fmaxf( max.z, point.y );
+        }
+    }
+
+    chunk->floor = floor_chunk_mesh(
+        outline, first_polygon, polygon_count, vertex_count, index_count, false );
+    chunk->ceiling = floor_chunk_mesh(
+        outline, first_polygon, polygon_count, vertex_count, index_count, true );
+    chunk->bounds = BoundingBox{ min, max };
+}
+
+static void floor_mesh_push( FloorMesh* floor, int first_polygon, int polygon_count ) {
+    if( !polygon_count ) {
+        return;
+    }
+    FloorChunk chunk = {};
+    floor_chunk_build( &chunk, &floor->outline, first_polygon, polygon_count );
+    buf_append( floor, chunk );
+}
+
+bool floor_mesh_build(
+    FloorMesh* floor, const Vector2* vertexes,
+    const MapFileSegment* segments, int segment_count
+) {
+    floor_mesh_clear( floor );
+    if( !floor_outline_build( &floor->outline, vertexes, segments, segment_count ) ) {
+        return false;
+    }
+
+    FloorOutline* outline = &floor->outline;
+    int first        = 0;
+    int vertex_count = 0;
+    for( int p = 0; p < outline->polygons.len; ++p ) {
+        int count = outline->polygons.buf[p].point_count;
+        if( count > FLOOR_CHUNK_MAX_VERTEXES ) {
+            TraceLog( LOG_WARNING,
+                "FLOOR: polygon with %i points is too big for one mesh", count );
+            floor_mesh_push( floor, first, p - first );
+            first        = p + 1;
+            vertex_count = 0;
+            continue;
+        }
+        if( vertex_count + count > FLOOR_CHUNK_MAX_VERTEXES ) {
+            floor_mesh_push( floor, first, p - first );
+            first        = p;
+            vertex_count = 0;
+        }
+        vertex_count += count;
+    }
+    floor_mesh_push( floor, first, outline->polygons.len - first );
+
+    return floor->len > 0;
+}
+void floor_mesh_clear( FloorMesh* floor ) {
+    for( int i = 0; i < floor->len; ++i ) {
+        UnloadMesh( floor->buf[i].floor );
+        UnloadMesh( floor->buf[i].ceiling );
+    }
+    floor->len = 0;
+}
+void floor_mesh_free( FloorMesh* floor ) {
+    floor_mesh_clear( floor );
+    if( floor->buf ) {
+        free( floor->buf );
+    }
+    floor_outline_free( &floor->outline );
+    *floor = {};
+}
@@ -16,6 +16,7 @@
 #include "globals.h"
 
 #include "enemy.h"
+#include "skinning.h"
 
 #include "shared/buffer.h"
 #include "shared/world.h"
@@ -46,6 +47,15 @@
 void DrawPlane( Material mat, Vector2 texture_tile, Vector3 centerPos, Vector2 size, Color color );
 void DrawPlaneInv( Material mat, Vector2 texture_tile, Vector3 centerPos, Vector2 size, Color color );
 
+/// @brief Queue mesh to be drawn once for every transform in instances.
+/// Web builds don't have instancing so they queue instances one at a time.
+/// @param pose_slot Pose cache slot to upload before drawing, -1 if mesh isn't skinned.
+void submit_instances(
+    GlobalState* state, const Mesh& mesh, Material material,
+    const Matrix* instances, int instance_count, bool apply_bob, int pose_slot );
+/// @brief Render queue prepare callback, uploads bot pose in slot.
+void render_prepare_pose( void* user, int slot );
+
 Vector2 world_collision_check(
     int segment_count, Segment* segments, Vector2* vertexes,
     Vector2 position, Vector2 velocity, float radius = 1.0 );
@@ -53,10 +63,63 @@ Vector2 world_collision_check(
 void spawn_enemy(
     GlobalState* state, Vector3 position,
     float rotation, float radius = E_DEFAULT_RADIUS, float power = 50.0f );
-void load_sound_set( SoundBuffer* buf, const char* name );
 
 void load_map( GlobalState* state, const char* path );
 void load_next_map( GlobalState* state );
+void reset_level( GlobalState* state );
+bool map_decode( AssetLoader* assets, MapData* out_map, const char* path );
+void map_free( MapData* map );
+
+// NOTE(alicia): buffers with zero capacity point into a mapped file.
+#define map_buf_is_owned( _buf ) ( (_buf)->cap != 0 )
+#define map_buf_reset( _buf ) do { \
+    if( !map_buf_is_owned( _buf ) ) { \
+        (_buf)->buf = nullptr; \
+    } \
+    (_buf)->len = 0; \
+} while(0)
+#define map_buf_view( _buf, data, count ) do { \
+    if( map_buf_is_owned( _buf ) ) { \
+        free( (_buf)->buf ); \
+    } \
+    (_buf)->buf = (data); \
+    (_buf)->len = (count); \
+    (_buf)->cap = 0; \
+} while(0)
+// NOTE(alicia): mapped memory is never passed to realloc,
+// a view is copied into heap memory the first time it has to grow.
+#define map_buf_reserve( _buf, count ) do { \
+    int _count = (count); \
+    if( !map_buf_is_owned( _buf ) ) { \
+        if( _count ) { \
+            void* _heap = malloc( sizeof(*(_buf)->buf) * _count ); \
+            if( (_buf)->len ) { \
+                memcpy( _heap, (_buf)->buf, \
+                    sizeof(*(_buf)->buf) * Min( (_buf)->len, _count ) ); \
+            } \
+            (_buf)->buf = (decltype((_buf)->buf))_heap; \
+            (_buf)->len = Min( (_buf)->len, _count ); \
+            (_buf)->cap = _count; \
+        } \
+    } else if( (_buf)->cap < _count ) { \
+        (_buf)->buf = (decltype((_buf)->buf))realloc( \
+            (_buf)->buf, sizeof(*(_buf)->buf) * _count ); \
+        (_buf)->cap = _count; \
+    } \
+} while(0)
+#define map_buf_free( _buf ) do { \
+    if( map_buf_is_owned( _buf ) ) { \
+        free( (_buf)->buf ); \
+    } \
+    *(_buf) = {}; \
+} while(0)
+
+/// @brief Collect segments that might overlap box into game->segment_query.results.
+/// @return Number of segments.
+int segments_near( GlobalState* state, Vector2 min, Vector2 max );
+/// @brief Normal of segment, from acceleration data if there is any.
+Vector2 segment_normal( GlobalState* state, uint32_t index );
+
 
 void player_init( Player* player ) {
     player->state              = PlayerState::DEFAULT;
@@ -107,53 +170,193 @@ const char* ANIMATION_NAMES[] = {
 };
 int ANIMATION_INDEXES[(int)Animation::COUNT] = {};
 
+#define PLAYER_MODEL_PATH "resources/meshes/obj_bot.glb"
+
+struct GameTextureAsset {
+    const char* path;
+    // NOTE(alicia): mipmapped, repeating and anisotropic.
+    bool        is_tiled;
+};
+// NOTE(alicia): same order as game->textures, white is generated.
+GameTextureAsset GAME_TEXTURE_ASSETS[GAME_TEXTURE_COUNT] = {
+    { nullptr,                                     false },
+    { "resources/textures/battery_base_color.png", false },
+    { "resources/textures/floor_base_color.png",   true },
+    { "resources/textures/wall_base_color.png",    true },
+    { "resources/textures/wall2_base_color.png",   true },
+    { "resources/textures/wall3_base_color.png",   true },
+    { "resources/textures/wall4_base_color.png",   true },
+    { "resources/textures/ceiling_base_color.png", true },
+};
+// NOTE(alicia): same order as game->models.
+const char* GAME_MODEL_PATHS[GAME_MODEL_COUNT] = {
+    PLAYER_MODEL_PATH,
+    "resources/meshes/scene_wall.glb",
+    "resources/meshes/obj_battery.glb",
+    "resources/meshes/obj_level_exit.glb",
+    "resources/meshes/scene_floor_ceiling.glb",
+};
+// NOTE(alicia): same order as game->sounds.
+const char* GAME_SOUND_SETS[GAME_SOUND_SET_COUNT] = {
+    "herostep",
+    "steamherodash",
+    "whiff",
+    "punch",
+    "death",
+    "powerup",
+    "fallapart",
+    "takedamage",
+    "nextlevel",
+};
+
+void game_assets_acquire( GlobalState* state, GameAssetHandles* out_handles ) {
+    auto* assets = &state->persistent.assets;
+
+    for( int i = 0; i < GAME_TEXTURE_COUNT; ++i ) {
+        auto* asset = GAME_TEXTURE_ASSETS + i;
+        out_handles->textures[i] = -1;
+        if( asset->path ) {
+            out_handles->textures[i] = assets_acquire(
+                assets, CachedAssetType::TEXTURE, asset->path, asset->is_tiled );
+        }
+    }
+    for( int i = 0; i < GAME_MODEL_COUNT; ++i ) {
+        out_handles->models[i] =
+            assets_acquire( assets, CachedAssetType::MODEL, GAME_MODEL_PATHS[i] );
+    }
+    out_handles->animations =
+        assets_acquire( assets, CachedAssetType::ANIMATIONS, PLAYER_MODEL_PATH );
+
+    for( int i = 0; i < GAME_SOUND_SET_COUNT; ++i ) {
+        int count = 0;
+        for( ; count < GAME_SOUND_SET_MAX; ++count ) {
+            const char* path = TextFormat(
+                "resources/audio/sfx/%s_%i.wav", GAME_SOUND_SETS[i], count );
+            if( !assets_file_exists( assets, path ) ) {
+                break;
+            }
+            out_handles->sounds[i][count] =
+                assets_acquire( assets, CachedAssetType::SOUND, path );
+        }
+        out_handles->sound_counts[i] = count;
+
+        if( !count ) {
+            TraceLog( LOG_ERROR, "No sound effects exist with name %s!", GAME_SOUND_SETS[i] );
+        }
+    }
+}
+void game_assets_unref( GlobalState* state, GameAssetHandles* handles ) {
+    auto* assets = &state->persistent.assets;
+
+    for( int i = 0; i < GAME_TEXTURE_COUNT; ++i ) {
+        assets_unref( assets, handles->textures[i] );
+    }
+    for( int i = 0; i < GAME_MODEL_COUNT; ++i ) {
+        assets_unref( assets, handles->models[i] );
+    }
+    assets_unref( assets, handles->animations );
+    for( int i = 0; i < GAME_SOUND_SET_COUNT; ++i ) {
+        for( int j = 0; j < handles->sound_counts[i]; ++j ) {
+            assets_unref( assets, handles->sounds[i][j] );
+        }
+    }
+}
+static void game_asset_prefetch(
+    AssetLoader* assets, int handle, int* total, int* ready
+) {
+    assets_prefetch( assets, handle );
+    *total += 1;
+    *ready += assets_prefetch_ready( assets, handle );
+}
+/// @brief Prefetch every asset that isn't already resident.
+/// @return Fraction of assets that are ready to use.
+float game_assets_prefetch( GlobalState* state, GameAssetHandles* handles ) {
+    auto* assets = &state->persistent.assets;
+
+    int total = 0;
+    int ready = 0;
+    for( int i = 0; i < GAME_TEXTURE_COUNT; ++i ) {
+        game_asset_prefetch( assets, handles->textures[i], &total, &ready );
+    }
+    for( int i = 0; i < GAME_MODEL_COUNT; ++i ) {
+        game_asset_prefetch( assets, handles->models[i], &total, &ready );
+    }
+    game_asset_prefetch( assets, handles->animations, &total, &ready );
+    for( int i = 0; i < GAME_SOUND_SET_COUNT; ++i ) {
+        for( int j = 0; j < handles->sound_counts[i]; ++j ) {
+            game_asset_prefetch( assets, handles->sounds[i][j], &total, &ready );
+        }
+    }
+
+    return (float)ready / (float)total;
+}
+
+void mode_game_prefetch( GlobalState* state, GameAssetHandles* out_handles ) {
+    game_assets_acquire( state, out_handles );
+    game_assets_prefetch( state, out_handles );
+}
+void mode_game_prefetch_release(
+    GlobalState* state, GameAssetHandles* handles, bool is_entering_game
+) {
+    // NOTE(alicia): game mode acquires the same assets and takes
+    // their requests, anything else would keep decoded data until shutdown.
+    if( !is_entering_game ) {
+        auto* assets = &state->persistent.assets;
+        for( int i = 0; i < GAME_TEXTURE_COUNT; ++i ) {
+            assets_cancel_prefetch( assets, handles->textures[i] );
+        }
+        for( int i = 0; i < GAME_MODEL_COUNT; ++i ) {
+            assets_cancel_prefetch( assets, handles->models[i] );
+        }
+        assets_cancel_prefetch( assets, handles->animations );
+        for( int i = 0; i < GAME_SOUND_SET_COUNT; ++i ) {
+            for( int j = 0; j < handles->sound_counts[i]; ++j ) {
+                assets_cancel_prefetch( assets, handles->sounds[i][j] );
+            }
+        }
+    }
+    game_assets_unref( state, handles );
+}
+
 int running_map_counter = 0;
 extern const char* INITIAL_MAP;
 void mode_game_load( GlobalState* state ) {
     auto* game = &state->transient.game;
     running_map_counter = 0;
 
-    game->music = LoadMusicStream( "resources/audio/music/music_game.wav");
+    // NOTE(alicia): assets still resident from a previous
+    // game session are ready immediately.
+    game_assets_acquire( state, &game->assets );
+    game->is_loading = true;
+    game->sim_rng    = (uint32_t)GetRandomValue( 1, INT32_MAX );
+}
+void game_finish_load( GlobalState* state ) {
+    auto* game    = &state->transient.game;
+    auto* assets  = &state->persistent.assets;
+    auto* handles = &game->assets;
+
+    game->music = assets_load_music( assets, "resources/audio/music/music_game.wav");
     PlayMusicStream( game->music );
 
-    game->textures.test = LoadTexture( "resources/textures/test.jpg" );
-
-    game->textures.battery = LoadTexture( "resources/textures/battery_base_color.png" );
-    game->textures.floor   = LoadTexture( "resources/textures/floor_base_color.png" );
-    GenTextureMipmaps( &game->textures.floor );
-    SetTextureWrap( game->textures.floor, TEXTURE_WRAP_REPEAT );
-    SetTextureFilter( game->textures.floor, TEXTURE_FILTER_ANISOTROPIC_16X );
-    game->textures.ceiling = LoadTexture( "resources/textures/ceiling_base_color.png" );
-    SetTextureWrap( game->textures.ceiling, TEXTURE_WRAP_REPEAT );
-    GenTextureMipmaps( &game->textures.ceiling );
-    SetTextureFilter( game->textures.ceiling, TEXTURE_FILTER_ANISOTROPIC_16X );
-    game->textures.wall    = LoadTexture( "resources/textures/wall_base_color.png" );
-    GenTextureMipmaps( &game->textures.wall );
-    SetTextureWrap( game->textures.wall, TEXTURE_WRAP_REPEAT );
-    SetTextureFilter( game->textures.wall, TEXTURE_FILTER_ANISOTROPIC_16X );
-    game->textures.wall2   = LoadTexture( "resources/textures/wall2_base_color.png" );
-    GenTextureMipmaps( &game->textures.wall2 );
-    SetTextureWrap( game->textures.wall2, TEXTURE_WRAP_REPEAT );
-    SetTextureFilter( game->textures.wall2, TEXTURE_FILTER_ANISOTROPIC_16X );
-    game->textures.wall3   = LoadTexture( "resources/textures/wall3_base_color.png" );
-    GenTextureMipmaps( &game->textures.wall3 );
-    SetTextureWrap( game->textures.wall3, TEXTURE_WRAP_REPEAT );
-    SetTextureFilter( game->textures.wall3, TEXTURE_FILTER_ANISOTROPIC_16X );
-    game->textures.wall4   = LoadTexture( "resources/textures/wall4_base_color.png" );
-    GenTextureMipmaps( &game->textures.wall4 );
-    SetTextureWrap( game->textures.wall4, TEXTURE_WRAP_REPEAT );
-    SetTextureFilter( game->textures.wall4, TEXTURE_FILTER_ANISOTROPIC_16X );
-
-    #define PLAYER_MODEL_PATH "resources/meshes/obj_bot.glb"
-
-    game->models.bot = LoadModel( PLAYER_MODEL_PATH );
-    game->animations.buf = LoadModelAnimations(
-        PLAYER_MODEL_PATH, &game->animations.len );
-
-    game->models.wall          = LoadModel( "resources/meshes/scene_wall.glb" );
-    game->models.battery       = LoadModel( "resources/meshes/obj_battery.glb" );
-    game->models.level_exit    = LoadModel( "resources/meshes/obj_level_exit.glb" );
-    game->models.floor_ceiling = LoadModel( "resources/meshes/scene_floor_ceiling.glb" );
+    for( int i = 0; i < GAME_TEXTURE_COUNT; ++i ) {
+        auto* asset = GAME_TEXTURE_ASSETS + i;
+        if( !asset->path ) {
+            continue;
+        }
+        Texture* texture = (Texture*)(&game->textures) + i;
+        *texture = assets_texture( assets, handles->textures[i] );
+        if( asset->is_tiled ) {
+            SetTextureWrap( *texture, TEXTURE_WRAP_REPEAT );
+            SetTextureFilter( *texture, TEXTURE_FILTER_ANISOTROPIC_16X );
+        }
+    }
+
+    for( int i = 0; i < GAME_MODEL_COUNT; ++i ) {
+        Model* model = (Model*)(&game->models) + i;
+        *model = assets_model( assets, handles->models[i] );
+    }
+    game->animations.buf = assets_animations(
+        assets, handles->animations, &game->animations.len );
 
     /* Animations */ {
         TraceLog( LOG_INFO, "Animations: ");
@@ -178,6 +381,19 @@ void mode_game_load( GlobalState* state ) {
         }
     }
 
+    // NOTE(alicia): bake only depends on the bot's mesh and animations
+    // which are the same every session so it's baked once.
+    // If bake fails, poses are skinned at runtime instead.
+    if( !state->persistent.anim_bake.positions ) {
+        if( !anim_bake(
+            &state->persistent.anim_bake, game->models.bot,
+            game->animations.buf, game->animations.len,
+            ANIMATION_INDEXES, (int)Animation::COUNT
+        ) ) {
+            TraceLog( LOG_WARNING, "failed to bake animations!" );
+        }
+    }
+
     /* White texture */ {
         Color white = {255, 255, 255, 255};
         Image img;
@@ -189,15 +405,14 @@ void mode_game_load( GlobalState* state ) {
 
         game->textures.white = LoadTextureFromImage( img );
     }
-    load_sound_set( &game->sounds.step,  "herostep" );
-    load_sound_set( &game->sounds.dash,  "steamherodash" );
-    load_sound_set( &game->sounds.whiff, "whiff" );
-    load_sound_set( &game->sounds.punch, "punch" );
-    load_sound_set( &game->sounds.death, "death" );
-    load_sound_set( &game->sounds.powerup, "powerup" );
-    load_sound_set( &game->sounds.fallapart, "fallapart" );
-    load_sound_set( &game->sounds.takedamage, "takedamage" );
-    load_sound_set( &game->sounds.nextlevel, "nextlevel" );
+
+    for( int i = 0; i < GAME_SOUND_SET_COUNT; ++i ) {
+        SoundBuffer* buf = (SoundBuffer*)(&game->sounds) + i;
+        for( int j = 0; j < handles->sound_counts[i]; ++j ) {
+            Sound sound = assets_sound( assets, handles->sounds[i][j] );
+            buf_append( buf, sound );
+        }
+    }
 
     game->materials.bot.shader        = state->sh_basic_shading;
     game->materials.bot.maps          = &game->material_maps.bot;
@@ -220,13 +435,13 @@ void mode_game_load( GlobalState* state ) {
     game->materials.level_exit.maps->texture = game->textures.wall;
 
     // game->materials.floor.shader        = state->sh_basic_shading;
-    game->materials.floor.shader        = state->sh_wall;
+    game->materials.floor.shader        = state->sh_floor;
     game->materials.floor.maps          = &game->material_maps.floor;
     game->materials.floor.maps->color   = WHITE;
     game->materials.floor.maps->texture = game->textures.floor;
 
     // game->materials.ceiling.shader        = state->sh_basic_shading;
-    game->materials.ceiling.shader        = state->sh_wall;
+    game->materials.ceiling.shader        = state->sh_floor;
     game->materials.ceiling.maps          = &game->material_maps.ceiling;
     game->materials.ceiling.maps->color   = WHITE;
     game->materials.ceiling.maps->texture = game->textures.ceiling;
@@ -236,11 +451,9 @@ void mode_game_load( GlobalState* state ) {
     game->materials.battery.maps->color   = WHITE;
     game->materials.battery.maps->texture = game->textures.battery;
 
-    DisableCursor();
-
     Vector2 clipping_planes = { 0.01, 1000.0 };
     SetShaderValue(
-        state->sh_wall, state->sh_wall_loc_dist,
+        state->sh_wall, state->sh_wall_loc_clipping_planes,
         &clipping_planes, SHADER_UNIFORM_VEC2 );
 
     if( INITIAL_MAP ) {
@@ -278,9 +491,53 @@ void player_damage(
 }
 
 void player_update( GlobalState* state, float dt );
+void draw_loading_screen( GlobalState* state, float progress );
+
+/// @brief Simulate one frame and write it to the packet that isn't being drawn.
+void game_simulate( GlobalState* state, float dt );
+static void game_simulate_job( void* params );
+/// @brief Advance player and enemy animation timers.
+void game_animate( GlobalState* state, float dt );
+/// @brief Copy everything game_draw reads out of game state.
+void frame_packet_capture( GlobalState* state, FramePacket* out_packet );
+/// @brief Play sounds simulation queued into packet and clear them.
+/// Must be called from main thread.
+void frame_packet_play_sfx( FramePacket* packet );
+
+/// @brief Random value in [min, max] from simulation's generator.
+int game_random( GlobalState* state, int min, int max );
+/// @brief Queue sound to play once this frame has been simulated.
+void game_sfx(
+    GlobalState* state, Vector2 src, Vector2 listener,
+    Sound sound, float volume = 1.0, bool random_pitch = true );
+/// @brief Queue random sound out of buf.
+/// @return Index of sound that was picked.
+int game_sfx_random(
+    GlobalState* state, Vector2 src, Vector2 listener,
+    Sound* buf, int len, float volume = 1.0, bool random_pitch = true );
+
+/// @brief Index into animations of animation player is playing.
+int player_animation( const Player* player, float* out_speed = nullptr );
+/// @brief Index into animations of animation enemy is playing.
+int enemy_animation( const Object* obj, float* out_speed = nullptr );
 void mode_game_update( GlobalState* state, float dt ) {
     auto* game = &state->transient.game;
 
+    if( game->is_loading ) {
+        float progress = game_assets_prefetch( state, &game->assets );
+        if( progress < 1.0f ) {
+            draw_loading_screen( state, progress );
+            return;
+        }
+        game_finish_load( state );
+        // NOTE(alicia): invalid map switches back to main menu,
+        // game state is unloaded at that point.
+        if( state->mode != Mode::GAME ) {
+            return;
+        }
+        game->is_loading = false;
+    }
+
     SetMusicVolume( game->music, OptionVolume() * OptionVolumeMusic() );
     UpdateMusicStream( game->music );
 
@@ -290,9 +547,55 @@ void mode_game_update( GlobalState* state, float dt ) {
         set_pause( state, !game->is_paused );
     }
 
+    // NOTE(alicia): this frame is simulated on a worker while last
+    // frame's packet is drawn, GL and window calls stay on this thread.
+    // Pause menu changes game state from draw so paused frames don't overlap.
+    game->transition = GameTransition::NONE;
+    game->sim_dt     = dt;
+    if( game->is_paused ) {
+        game_simulate( state, dt );
+    } else {
+        jobs_submit( &game->sim_counter, game_simulate_job, state );
+    }
+
+    game_draw( state, dt );
+    jobs_wait( &game->sim_counter );
+    if( state->mode != Mode::GAME ) {
+        return;
+    }
+
+    game->frame_read ^= 1;
+    frame_packet_play_sfx( game->frames + game->frame_read );
+
+    switch( game->transition ) {
+        case GameTransition::NONE: break;
+        case GameTransition::RESET_LEVEL: {
+            reset_level( state );
+        } break;
+        case GameTransition::NEXT_MAP: {
+            load_next_map( state );
+        } break;
+    }
+    if( state->mode != Mode::GAME ) {
+        return;
+    }
+
+    if( game->pause_menu_state.reset_level ) {
+        game->is_paused = false;
+        DisableCursor();
+        reset_level( state );
+    }
+}
+/// @brief Advance game by dt, sets transition instead of
+/// changing level since that needs GL.
+static void game_simulate_step( GlobalState* state, float dt ) {
+    auto* game = &state->transient.game;
+
     if( !game->is_paused && !game->is_exiting_stage ) {
         player_update( state, dt );
-        
+
+        game->battery_time += dt * 1.2;
+
         for( int i = 0; i < game->objects.len; ++i ) {
             auto* obj = game->objects.buf + i;
             if( !obj->is_active ) {
@@ -329,7 +632,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                                 int lo  = 0;
                                 int hi  = 1000;
 
-                                int chance = GetRandomValue( lo, hi );
+                                int chance = game_random( state, lo, hi );
                                 (void)chance;
 
                                 if( chance > 250 ) {
@@ -359,7 +662,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                             if( obj->enemy.timer >= E_SCAN_TIME ) {
                                 int lo = 0;
                                 int hi = 1000;
-                                int chance = GetRandomValue( lo, hi );
+                                int chance = game_random( state, lo, hi );
 
                                 if( chance > 250 ) {
                                     obj->enemy.state = EnemyState::WANDER;
@@ -379,7 +682,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                             if( obj->enemy.first_frame_state ) {
 
                                 float rotation =
-                                    (float)GetRandomValue( 0, 360 ) * (M_PI / 180.0);
+                                    (float)game_random( state, 0, 360 ) * (M_PI / 180.0);
                                 Vector3 to_target =
                                     Vector3RotateByAxisAngle(
                                         obj->enemy.facing_direction, Vector3UnitY, rotation );
@@ -415,8 +718,8 @@ void mode_game_update( GlobalState* state, float dt ) {
                             obj->enemy.sfx_timer += dt;
                             if( obj->enemy.sfx_timer >= E_SFX_WALK_TIME ) {
                                 obj->enemy.sfx_timer = 0.0;
-                                play_sfx_random(
-                                    { game->player.position.x, game->player.position.z },
+                                game_sfx_random(
+                                    state, { game->player.position.x, game->player.position.z },
                                     { obj->position.x, obj->position.z },
                                     game->sounds.step.buf, game->sounds.step.len, 0.25 );
                             }
@@ -445,8 +748,8 @@ void mode_game_update( GlobalState* state, float dt ) {
                                 PLAYER_COLLISION_RADIUS_2
                             ) {
                                 obj->enemy.state = EnemyState::ATTACKING;
-                                play_sfx_random(
-                                    { game->player.position.x, game->player.position.z },
+                                game_sfx_random(
+                                    state, { game->player.position.x, game->player.position.z },
                                     { obj->position.x, obj->position.z },
                                     game->sounds.whiff.buf, game->sounds.whiff.len );
                             }
@@ -454,8 +757,8 @@ void mode_game_update( GlobalState* state, float dt ) {
                             obj->enemy.sfx_timer += dt;
                             if( obj->enemy.sfx_timer >= E_SFX_RUN_TIME ) {
                                 obj->enemy.sfx_timer = 0.0;
-                                play_sfx_random(
-                                    { game->player.position.x, game->player.position.z },
+                                game_sfx_random(
+                                    state, { game->player.position.x, game->player.position.z },
                                     { obj->position.x, obj->position.z },
                                     game->sounds.step.buf, game->sounds.step.len, 0.25 );
                             }
@@ -499,10 +802,10 @@ void mode_game_update( GlobalState* state, float dt ) {
                                     obj->enemy.facing_direction * E_ATTACK_PUSH;
 
                                 game->player.state = PlayerState::TAKING_DAMAGE;
-                                play_sfx( {}, {}, game->sounds.takedamage.buf[0], 0.5 );
+                                game_sfx( state, {}, {}, game->sounds.takedamage.buf[0], 0.5 );
 
-                                play_sfx_random(
-                                    { game->camera.position.x, game->camera.position.z },
+                                game_sfx_random(
+                                    state, { game->camera.position.x, game->camera.position.z },
                                     { obj->position.x, obj->position.z },
                                     game->sounds.punch.buf,
                                     game->sounds.punch.len, 0.5 );
@@ -521,7 +824,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                                 if( distance < E_RETURN_HOME_DISTANCE ) {
                                     obj->enemy.state = EnemyState::IDLE;
                                 } else {
-                                    int chance = GetRandomValue( 0, 1000 );
+                                    int chance = game_random( state, 0, 1000 );
                                     if( chance < 400 ) {
                                         obj->enemy.state = EnemyState::IDLE;
                                     }
@@ -534,8 +837,8 @@ void mode_game_update( GlobalState* state, float dt ) {
                             obj->enemy.sfx_timer += dt;
                             if( obj->enemy.sfx_timer >= E_SFX_WALK_TIME ) {
                                 obj->enemy.sfx_timer = 0.0;
-                                play_sfx_random(
-                                    { game->player.position.x, game->player.position.z },
+                                game_sfx_random(
+                                    state, { game->player.position.x, game->player.position.z },
                                     { obj->position.x, obj->position.z },
                                     game->sounds.step.buf, game->sounds.step.len, 0.25 );
                             }
@@ -634,15 +937,15 @@ void mode_game_update( GlobalState* state, float dt ) {
                                     if( obj->enemy.power < 0.0 ) {
                                         obj->enemy.state = EnemyState::DYING;
                                         game->player.power_target += E_POWER_BONUS;
-                                        play_sfx( {}, {}, game->sounds.powerup.buf[0] );
-                                        play_sfx(
-                                            { obj->position.x, obj->position.z }, 
+                                        game_sfx( state, {}, {}, game->sounds.powerup.buf[0] );
+                                        game_sfx(
+                                            state, { obj->position.x, obj->position.z }, 
                                             { game->camera.position.x, game->camera.position.z },
                                             game->sounds.fallapart.buf[0] );
                                     }
 
-                                    play_sfx_random(
-                                        { game->camera.position.x, game->camera.position.z },
+                                    game_sfx_random(
+                                        state, { game->camera.position.x, game->camera.position.z },
                                         { obj->position.x, obj->position.z },
                                         game->sounds.punch.buf,
                                         game->sounds.punch.len );
@@ -667,7 +970,10 @@ void mode_game_update( GlobalState* state, float dt ) {
                         obj->enemy.velocity.z = lateral_velocity.y;
                     }
 
-                    Vector2 sight_start, sight_end;
+                    // NOTE(alicia): states that don't look around
+                    // get a zero length sight line.
+                    Vector2 sight_start = { obj->position.x, obj->position.z };
+                    Vector2 sight_end   = sight_start;
                     switch( obj->enemy.state ) {
                         case EnemyState::SCAN: {
                             sight_start = { obj->position.x, obj->position.z };
@@ -694,8 +1000,13 @@ void mode_game_update( GlobalState* state, float dt ) {
                     Vector3 velocity = obj->enemy.velocity;
                     float speed = Vector3Length( velocity ); {
                         Vector2 position = { obj->position.x, obj->position.z };
+                        Vector2 radius   = Vector2{ PLAYER_COLLISION_RADIUS, PLAYER_COLLISION_RADIUS };
 
-                        for( int j = 0; j < game->segments.len; ++j ) {
+                        int near_count = segments_near( state,
+                            Vector2Min( Vector2Min( position - radius, sight_start ), sight_end ),
+                            Vector2Max( Vector2Max( position + radius, sight_start ), sight_end ) );
+                        for( int k = 0; k < near_count; ++k ) {
+                            uint32_t j   = game->segment_query.results[k];
                             Segment* seg = game->segments.buf + j;
                             Vector2  start, end;
 
@@ -703,8 +1014,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                             end   = game->vertexes.buf[seg->end];
 
                             if( CheckCollisionCircleLine( position, PLAYER_COLLISION_RADIUS, start, end ) ) {
-                                Vector2 normal = Vector2Rotate(
-                                    Vector2Normalize( start - end ), 90 * (M_PI / 180.0) );
+                                Vector2 normal = segment_normal( state, j );
 
                                 Vector2 center    = Vector2Lerp( start, end, 0.5 );
                                 Vector2 to_object = Vector2Normalize( position - center );
@@ -829,11 +1139,6 @@ void mode_game_update( GlobalState* state, float dt ) {
                     obj->position.y = 0.0;
                 } break;
                 case ObjectType::BATTERY: {
-                    obj->position.y = Lerp(
-                        1.0 - 0.1, 1.0 + 0.2, (sin( obj->battery.timer ) + 1.0) / 2.0 );
-
-                    obj->battery.timer += dt * 1.2;
-
                     if( CheckCollisionCircles(
                         { obj->position.x, obj->position.z }, 1.0,
                         { game->player.position.x, game->player.position.z },
@@ -843,7 +1148,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                         game->battery_counter--;
                         obj->is_active = false;
 
-                        play_sfx( {}, {}, game->sounds.powerup.buf[0] );
+                        game_sfx( state, {}, {}, game->sounds.powerup.buf[0] );
                     }
                 } break;
                 case ObjectType::LEVEL_EXIT: {
@@ -867,7 +1172,7 @@ void mode_game_update( GlobalState* state, float dt ) {
                         PLAYER_COLLISION_RADIUS
                     ) ) {
                         game->is_exiting_stage = true;
-                        play_sfx( {}, {}, game->sounds.nextlevel.buf[0], 0.8, false );
+                        game_sfx( state, {}, {}, game->sounds.nextlevel.buf[0], 0.8, false );
                         return;
                     }
                 } break;
@@ -882,8 +1187,7 @@ void mode_game_update( GlobalState* state, float dt ) {
 
     if( game->player.state == PlayerState::IS_DEAD ) {
         if( game->player.inv_time >= DEATH_TIME ) {
-            running_map_counter--;
-            load_next_map( state );
+            game->transition = GameTransition::RESET_LEVEL;
             return;
         }
     }
@@ -894,66 +1198,299 @@ void mode_game_update( GlobalState* state, float dt ) {
         game->player.state     = PlayerState::DEFAULT;
 
         if( game->exit_stage_timer >= LEVEL_EXIT_TIME ) {
-            load_next_map( state );
+            game->transition = GameTransition::NEXT_MAP;
             return;
         }
         game->exit_stage_timer += dt;
     } else {
         game->level_timer += dt;
     }
+}
+void game_simulate( GlobalState* state, float dt ) {
+    auto* game = &state->transient.game;
 
-    game_draw( state, dt );
+    game_simulate_step( state, dt );
+    game_animate( state, dt );
 
-    if( game->pause_menu_state.reset_level ) {
-        game->is_paused = false;
-        DisableCursor();
-        running_map_counter--;
-        load_next_map( state );
+    frame_packet_capture( state, game->frames + (game->frame_read ^ 1) );
+}
+static void game_simulate_job( void* params ) {
+    auto* state = (GlobalState*)params;
+    game_simulate( state, state->transient.game.sim_dt );
+}
+int player_animation( const Player* player, float* out_speed ) {
+    float     speed = 1.0;
+    Animation anim  = Animation::IDLE;
+    switch( player->state ) {
+        case PlayerState::DEFAULT: {
+            anim = Animation::IDLE;
+        } break;
+        case PlayerState::IS_MOVING: {
+            anim = Animation::RUN;
+        } break;
+        case PlayerState::ATTACK: {
+            anim  = player->which_attack ? Animation::PUNCH01 : Animation::KICK01;
+            speed = 2.1;
+        } break;
+        case PlayerState::DODGE: {
+            anim  = Animation::DODGE_DIVE;
+            speed = 1.9;
+        } break;
+        case PlayerState::TAKING_DAMAGE: {
+            anim = Animation::DAMAGED;
+        } break;
+        case PlayerState::IS_DEAD: {
+            anim = Animation::DEATH;
+        } break;
     }
+    if( out_speed ) {
+        *out_speed = speed;
+    }
+    return ANIMATION_INDEXES[(int)anim];
 }
-void mode_game_unload( GlobalState* state ) {
+int enemy_animation( const Object* obj, float* out_speed ) {
+    float     speed = 1.0;
+    Animation anim  = Animation::IDLE;
+    switch( obj->enemy.state ) {
+        case EnemyState::IDLE: {
+            anim = Animation::IDLE;
+        } break;
+        case EnemyState::SCAN: {
+            anim = Animation::IDLE;
+        } break;
+        case EnemyState::WANDER: {
+            anim = Animation::WALK;
+        } break;
+        case EnemyState::ALERT: {
+            anim = Animation::IDLE;
+        } break;
+        case EnemyState::CHASING: {
+            anim = Animation::RUN;
+        } break;
+        case EnemyState::ATTACKING: {
+            anim  = Animation::PUNCH02;
+            speed = 0.7;
+        } break;
+        case EnemyState::RETURN_HOME: {
+            anim = Animation::WALK;
+        } break;
+        case EnemyState::TAKING_DAMAGE: {
+            anim = Animation::DAMAGED;
+        } break;
+        case EnemyState::DYING: {
+            anim = Animation::DEATH;
+        } break;
+    }
+    if( out_speed ) {
+        *out_speed = speed;
+    }
+    return ANIMATION_INDEXES[(int)anim];
+}
+void game_animate( GlobalState* state, float dt ) {
+    auto* game   = &state->transient.game;
+    auto* player = &game->player;
+
+    float animation_speed = 1.0;
+    ModelAnimation* anim  =
+        game->animations.buf + player_animation( player, &animation_speed );
+
+    if( player->animation_timer >= ANIMATION_TIME ) {
+        if( !(
+            player->state == PlayerState::IS_DEAD &&
+            player->animation_frame >= anim->frameCount - 1
+        ) ) {
+            player->animation_frame++;
+            player->animation_timer = 0.0;
+        }
+    }
+    player->animation_timer += dt * animation_speed;
+
+    for( int i = 0; i < game->objects.len; ++i ) {
+        auto* obj = game->objects.buf + i;
+        if( !obj->is_active || obj->type != ObjectType::ENEMY ) {
+            continue;
+        }
+
+        float anim_speed = 1.0;
+        anim = game->animations.buf + enemy_animation( obj, &anim_speed );
+
+        int step = animation_lod_step( animation_lod(
+            Vector3DistanceSqr( obj->position, game->camera.position ) ) );
+        if( !step ) {
+            continue;
+        }
+        if( obj->enemy.animation_timer >= ANIMATION_TIME * step ) {
+            if( !(
+                obj->enemy.state == EnemyState::DYING &&
+                obj->enemy.animation_frame >= anim->frameCount - 1
+            ) ) {
+                obj->enemy.animation_frame += step;
+                obj->enemy.animation_timer = 0.0;
+                // NOTE(alicia): don't let a step wrap the death pose.
+                if(
+                    obj->enemy.state == EnemyState::DYING &&
+                    obj->enemy.animation_frame > anim->frameCount - 1
+                ) {
+                    obj->enemy.animation_frame = anim->frameCount - 1;
+                }
+            }
+        }
+        obj->enemy.animation_timer += dt * anim_speed;
+    }
+}
+void frame_packet_capture( GlobalState* state, FramePacket* out_packet ) {
     auto* game = &state->transient.game;
 
-    UnloadMusicStream( game->music );
+    out_packet->camera = game->camera;
+    out_packet->player = game->player;
 
-    if( game->objects.buf ) {
-        free( game->objects.buf );
+    if( out_packet->objects.cap < game->objects.len ) {
+        out_packet->objects.buf = (Object*)realloc(
+            out_packet->objects.buf, sizeof(Object) * game->objects.len );
+        out_packet->objects.cap = game->objects.len;
     }
-    if( game->vertexes.buf ) {
-        free( game->vertexes.buf );
+    if( game->objects.len ) {
+        memcpy(
+            out_packet->objects.buf, game->objects.buf,
+            sizeof(Object) * game->objects.len );
     }
-    if( game->segments.buf ) {
-        free( game->segments.buf );
+    out_packet->objects.len = game->objects.len;
+
+    out_packet->battery_time        = game->battery_time;
+    out_packet->level_timer         = game->level_timer;
+    out_packet->exit_stage_timer    = game->exit_stage_timer;
+    out_packet->is_exiting_stage    = game->is_exiting_stage;
+    out_packet->enemy_counter       = game->enemy_counter;
+    out_packet->total_enemy_count   = game->total_enemy_count;
+    out_packet->battery_counter     = game->battery_counter;
+    out_packet->total_battery_count = game->total_battery_count;
+}
+void frame_packet_play_sfx( FramePacket* packet ) {
+    for( int i = 0; i < packet->sfx.len; ++i ) {
+        SfxEvent* event = packet->sfx.buf + i;
+        play_sfx(
+            event->src, event->listener, event->sound,
+            event->volume, event->random_pitch );
+    }
+    packet->sfx.len = 0;
+}
+int game_random( GlobalState* state, int min, int max ) {
+    auto* game = &state->transient.game;
+    if( min > max ) {
+        int tmp = min;
+        min = max;
+        max = tmp;
     }
 
-    int texture_count = sizeof(game->textures) / sizeof(Texture);
-    for( int i = 0; i < texture_count; ++i ) {
-        Texture* texture = (Texture*)(&game->textures) + i;
-        UnloadTexture( *texture );
+    // NOTE(alicia): xorshift32, state can't be zero.
+    uint32_t x = game->sim_rng ? game->sim_rng : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    game->sim_rng = x;
+
+    uint32_t range = (uint32_t)((int64_t)max - (int64_t)min + 1);
+    return min + (int)(range ? x % range : x);
+}
+void game_sfx(
+    GlobalState* state, Vector2 src, Vector2 listener,
+    Sound sound, float volume, bool random_pitch
+) {
+    auto* game = &state->transient.game;
+    // NOTE(alicia): simulation always writes packet that isn't being drawn.
+    auto* packet = game->frames + (game->frame_read ^ 1);
+
+    SfxEvent event = {};
+    event.sound        = sound;
+    event.src          = src;
+    event.listener     = listener;
+    event.volume       = volume;
+    event.random_pitch = random_pitch;
+    buf_append( &packet->sfx, event );
+}
+int game_sfx_random(
+    GlobalState* state, Vector2 src, Vector2 listener,
+    Sound* buf, int len, float volume, bool random_pitch
+) {
+    if( !buf || !len ) {
+        return 0;
     }
+    int idx = game_random( state, 0, 100000 ) % len;
 
-    UnloadModelAnimations( game->animations.buf, game->animations.len );
-    game->animations.len = 0;
-    
-    int model_count = sizeof(game->models) / sizeof(Model);
-    for( int i = 0; i < model_count; ++i ) {
-        Model* model = (Model*)(&game->models) + i;
-        UnloadModel( *model );
+    game_sfx( state, src, listener, buf[idx], volume, random_pitch );
+    return idx;
+}
+void mode_game_unload( GlobalState* state ) {
+    auto* game = &state->transient.game;
+
+    // NOTE(alicia): music isn't opened until loading screen finishes.
+    if( IsMusicValid( game->music ) ) {
+        UnloadMusicStream( game->music );
+    }
+
+    jobs_wait( &game->next_map.counter );
+    map_free( &game->next_map.map );
+    map_free( &game->level_start );
+
+    if( game->objects.buf ) {
+        free( game->objects.buf );
+    }
+    map_buf_free( &game->vertexes );
+    map_buf_free( &game->segments );
+    map_buf_free( &game->accel_data );
+    mapped_file_close( &game->map_file );
+    if( game->segment_query.stamps ) {
+        free( game->segment_query.stamps );
+        free( game->segment_query.results );
+    }
+    game->segment_query = {};
+    wall_batch_free( &game->walls );
+    floor_mesh_free( &game->floor );
+    pvs_free( &game->pvs );
+    render_queue_free( &game->render_queue );
+    hud_free( &game->hud );
+    for( int i = 0; i < 2; ++i ) {
+        if( game->frames[i].objects.buf ) {
+            free( game->frames[i].objects.buf );
+        }
+        if( game->frames[i].sfx.buf ) {
+            free( game->frames[i].sfx.buf );
+        }
+        game->frames[i] = {};
     }
 
+    // NOTE(alicia): everything else is owned by the asset cache.
+    UnloadTexture( game->textures.white );
+    game_assets_unref( state, &game->assets );
+
     int sound_buffer_count = sizeof(game->sounds) / sizeof(SoundBuffer);
     for( int i = 0; i < sound_buffer_count; ++i ) {
         SoundBuffer& buffer = ((SoundBuffer*)&game->sounds)[i];
-        if( !buffer.buf ) {
-            continue;
+        if( buffer.buf ) {
+            free( buffer.buf );
         }
-        for( int j = 0; j < buffer.len; ++j ) {
-            UnloadSound( buffer.buf[j] );
-        }
-        free( buffer.buf );
     }
     memset( &game->sounds, 0, sizeof(game->sounds) );
 
+    pose_cache_free( &game->pose_cache );
+    skin_batch_free( &game->skin_batch );
+    if( game->pose_draws.buf ) {
+        free( game->pose_draws.buf );
+    }
+    memset( &game->pose_draws, 0, sizeof(game->pose_draws) );
+
+    int instance_buffer_count = sizeof(game->instances) / sizeof(InstanceBuffer);
+    for( int i = 0; i < instance_buffer_count; ++i ) {
+        InstanceBuffer& buffer = ((InstanceBuffer*)&game->instances)[i];
+        if( buffer.buf ) {
+            free( buffer.buf );
+        }
+    }
+    memset( &game->instances, 0, sizeof(game->instances) );
+
+    cull_list_free( &game->visible.objects );
+    cull_list_free( &game->visible.walls );
+
     (void)(game);
 }
 void player_update( GlobalState* state, float dt ) {
@@ -1051,8 +1588,8 @@ void player_update( GlobalState* state, float dt ) {
                 Vector3 direction_target   = Vector3Normalize( movement );
                 player->movement_direction = direction_target;
 
-                play_sfx_random( 
-                    {}, {},
+                game_sfx_random(
+                    state, {}, {},
                     game->sounds.dash.buf, game->sounds.dash.len );
 
             } else if( player->input.is_punch_press ) {
@@ -1062,8 +1599,8 @@ void player_update( GlobalState* state, float dt ) {
 
                 player->which_attack = !player->which_attack;
 
-                play_sfx_random(
-                    {}, {},
+                game_sfx_random(
+                    state, {}, {},
                     game->sounds.whiff.buf,
                     game->sounds.whiff.len );
             }
@@ -1080,7 +1617,7 @@ void player_update( GlobalState* state, float dt ) {
         player->state    = PlayerState::IS_DEAD;
         player->velocity = {};
 
-        play_sfx( {}, {}, game->sounds.death.buf[0] );
+        game_sfx( state, {}, {}, game->sounds.death.buf[0] );
     }
 
     player->power_target = fmin( player->power_target, player->max_power );
@@ -1119,8 +1656,8 @@ void player_update( GlobalState* state, float dt ) {
 
             player->sfx_walk_timer += dt;
             if( player->sfx_walk_timer >= player->sfx_walk_time ) {
-                int idx = play_sfx_random(
-                    {}, {},
+                int idx = game_sfx_random(
+                    state, {}, {},
                     game->sounds.step.buf, game->sounds.step.len, 0.25 );
 
                 player->sfx_walk_time  = sound_length( game->sounds.step.buf[idx] );
@@ -1205,8 +1742,15 @@ void player_update( GlobalState* state, float dt ) {
         auto* segments = game->segments.buf;
         auto* vertexes = game->vertexes.buf;
 
+        // NOTE(alicia): camera is pulled in front of walls
+        // between it and player so query covers both.
+        Vector2 radius     = Vector2{ PLAYER_COLLISION_RADIUS, PLAYER_COLLISION_RADIUS };
+        int     near_count = segments_near( state,
+            Vector2Min( p2 - radius, c2 ), Vector2Max( p2 + radius, c2 ) );
+
         float speed = Vector2Length( v2 );
-        for( int i = 0; i < game->segments.len; ++i ) {
+        for( int k = 0; k < near_count; ++k ) {
+            uint32_t i   = game->segment_query.results[k];
             Segment* seg = segments + i;
             Vector2  start, end;
 
@@ -1214,8 +1758,7 @@ void player_update( GlobalState* state, float dt ) {
             end   = vertexes[seg->end];
 
             if( CheckCollisionCircleLine( p2, PLAYER_COLLISION_RADIUS, start, end ) ) {
-                Vector2 normal = Vector2Rotate(
-                    Vector2Normalize( start - end ), 90 * (M_PI / 180.0) );
+                Vector2 normal = segment_normal( state, i );
 
                 Vector2 center    = Vector2Lerp( start, end, 0.5 );
                 Vector2 to_object = Vector2Normalize( p2 - center );
@@ -1389,26 +1932,52 @@ void read_input( GlobalState* state, float dt ) {
 }
 void game_draw( GlobalState* state, float dt ) {
     auto* game   = &state->transient.game;
-    auto* player = &game->player;
+    auto* frame  = game->frames + game->frame_read;
+    auto* player = &frame->player;
+
+    auto* dr = &state->dynamic_resolution;
+    dynamic_resolution_update( dr, dt, OptionDynamicResolution() );
+    bool is_offscreen = OptionFXAA() || dr->scale < 1.0f;
 
     BeginDrawing();
 
-    if( OptionFXAA() ) {
+    if( is_offscreen ) {
         BeginTextureMode( state->rt );
+
+        // NOTE(alicia): viewport shrinks instead of target
+        // so that scale changes don't reallocate.
+        Rectangle viewport = dynamic_resolution_viewport( dr, state->rt.texture );
+        rlViewport( 0, 0, (int)viewport.width, (int)viewport.height );
     }
 
     /* 3D */ {
 
-        BeginMode3D( game->camera );
+        BeginMode3D( frame->camera );
         ClearBackground( BLACK );
 
-        BeginShaderMode( state->sh_basic_shading );
-        // NOTE(alicia): BEGIN SHADER
+        auto* queue = &game->render_queue;
+        render_queue_begin( queue, frame->camera.position );
 
-        SetShaderValue(
-            state->sh_basic_shading,
+        render_queue_uniform(
+            queue, state->sh_basic_shading,
             state->sh_basic_shading_loc_camera_position,
-            &game->camera.position, SHADER_UNIFORM_VEC3 );
+            &frame->camera.position, SHADER_UNIFORM_VEC3 );
+        render_queue_uniform(
+            queue, state->sh_instanced,
+            state->sh_instanced_loc_camera_position,
+            &frame->camera.position, SHADER_UNIFORM_VEC3 );
+        render_queue_uniform(
+            queue, state->sh_instanced_bob,
+            state->sh_instanced_bob_loc_camera_position,
+            &frame->camera.position, SHADER_UNIFORM_VEC3 );
+        render_queue_uniform(
+            queue, state->sh_wall,
+            state->sh_wall_loc_camera_position,
+            &frame->camera.position, SHADER_UNIFORM_VEC3 );
+        render_queue_uniform(
+            queue, state->sh_floor,
+            state->sh_floor_loc_camera_position,
+            &frame->camera.position, SHADER_UNIFORM_VEC3 );
 
         Matrix transform; {
             Quaternion rot =
@@ -1418,209 +1987,194 @@ void game_draw( GlobalState* state, float dt ) {
                 MatrixTranslate( player->position.x, player->position.y, player->position.z );
         }
 
-        float animation_speed = 1.0;
-        ModelAnimation* anim = 0;
-        switch( player->state ) {
-            case PlayerState::DEFAULT: {
-                anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::IDLE];
-            } break;
-            case PlayerState::IS_MOVING: {
-                anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::RUN];
-            } break;
-            case PlayerState::ATTACK: {
-                int which = (int)(player->which_attack ? Animation::PUNCH01 : Animation::KICK01);
-                anim = game->animations.buf + ANIMATION_INDEXES[which];
-                animation_speed = 2.1;
-            } break;
-            case PlayerState::DODGE: {
-                anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::DODGE_DIVE];
-                animation_speed = 1.9;
-            } break;
-            case PlayerState::TAKING_DAMAGE: {
-                anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::DAMAGED];
-            } break;
-            case PlayerState::IS_DEAD: {
-                anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::DEATH];
-            } break;
+        ModelAnimation* anim = game->animations.buf + player_animation( player );
+
+        /* Cull */ {
+            Vector2 screen  = get_screen();
+            float   far     = fog_cull_distance( FOG_DENSITY, FOG_CULL_THRESHOLD );
+            Frustum frustum = frustum_from_camera(
+                frame->camera, screen.x / screen.y, CULL_NEAR_PLANE, far );
+
+            pvs_update(
+                &game->pvs, { frame->camera.position.x, frame->camera.position.z }, far );
+
+            game->cull_stats = {};
+            cull_objects(
+                &frustum, &game->pvs, frame->camera.position, far,
+                frame->objects.buf, frame->objects.len,
+                &game->visible.objects, &game->cull_stats );
+            cull_walls(
+                &frustum, &game->pvs, frame->camera.position, far,
+                game->walls.buf, game->walls.len,
+                &game->visible.walls, &game->cull_stats );
         }
 
-        UpdateModelAnimation(
-            game->models.bot, *anim, player->animation_frame % anim->frameCount );
-        if( player->animation_timer >= ANIMATION_TIME ) {
-            if( !(
-                player->state == PlayerState::IS_DEAD &&
-                player->animation_frame >= anim->frameCount - 1
-            ) ) {
-                player->animation_frame++;
-                player->animation_timer = 0.0;
+        pose_cache_begin_frame( &game->pose_cache );
+        game->pose_draws.len = 0;
+        memset( game->anim_lod_counts, 0, sizeof(game->anim_lod_counts) );
+
+        int bot_vertex_count = game->models.bot.meshes[0].vertexCount;
+        int player_slot      = pose_cache_acquire(
+            &game->pose_cache, anim - game->animations.buf,
+            player->animation_frame % anim->frameCount, bot_vertex_count );
+
+        // NOTE(alicia): pick enemy poses first so that skinning
+        // runs on worker threads while nothing else touches the mesh.
+        // Enemies that share (animation, frame) share a cached pose.
+        for( int i = 0; i < game->visible.objects.len; ++i ) {
+            auto* obj = frame->objects.buf + game->visible.objects.buf[i];
+            if( obj->type != ObjectType::ENEMY ) {
+                continue;
             }
-        }
-        player->animation_timer += dt * animation_speed;
+            anim = game->animations.buf + enemy_animation( obj );
 
-        DrawMesh(
-            game->models.bot.meshes[0], game->materials.bot, transform );
+            AnimationLOD lod = animation_lod(
+                Vector3DistanceSqr( obj->position, frame->camera.position ) );
+            int step = animation_lod_step( lod );
 
-        for( int i = 0; i < game->objects.len; ++i ) {
-            auto* obj = game->objects.buf + i;
-            if( !obj->is_active ) {
-                continue;
-            }
+            Quaternion rot =
+                QuaternionFromVector3ToVector3(
+                    { 0.0, 0.0, -1.0 }, obj->enemy.facing_direction );
 
-            switch( obj->type ) {
-                case ObjectType::ENEMY: {
-                    Quaternion rot =
-                        QuaternionFromVector3ToVector3(
-                            { 0.0, 0.0, -1.0 }, obj->enemy.facing_direction );
-                    transform =
-                        QuaternionToMatrix( rot ) *
-                        MatrixTranslate( obj->position.x, obj->position.y, obj->position.z );
-
-                    float anim_speed = 1.0;
-                    switch( obj->enemy.state ) {
-                        case EnemyState::IDLE: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::IDLE];
-                        } break;
-                        case EnemyState::SCAN: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::IDLE];
-                        } break;
-                        case EnemyState::WANDER: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::WALK];
-                        } break;
-                        case EnemyState::ALERT: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::IDLE];
-                        } break;
-                        case EnemyState::CHASING: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::RUN];
-                        } break;
-                        case EnemyState::ATTACKING: {
-                            anim_speed = 0.7;
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::PUNCH02];
-                        } break;
-                        case EnemyState::RETURN_HOME: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::WALK];
-                        } break;
-                        case EnemyState::TAKING_DAMAGE: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::DAMAGED];
-                        } break;
-                        case EnemyState::DYING: {
-                            anim = game->animations.buf + ANIMATION_INDEXES[(int)Animation::DEATH];
-                        } break;
-                    }
+            PoseDraw draw;
+            draw.transform =
+                QuaternionToMatrix( rot ) *
+                MatrixTranslate( obj->position.x, obj->position.y, obj->position.z );
 
-                    UpdateModelAnimation(
-                        game->models.bot, *anim,
-                        obj->enemy.animation_frame % anim->frameCount );
+            game->anim_lod_counts[(int)lod]++;
 
-                    if( obj->enemy.animation_timer >= ANIMATION_TIME ) {
-                        if( !(
-                            obj->enemy.state == EnemyState::DYING &&
-                            obj->enemy.animation_frame >= anim->frameCount - 1
-                        ) ) {
-                            obj->enemy.animation_frame++;
-                            obj->enemy.animation_timer = 0.0;
-                        }
-                    }
-                    obj->enemy.animation_timer += dt * anim_speed;
+            // NOTE(alicia): snap reduced rate frames to step so that
+            // enemies in the same animation land on the same cached pose.
+            int frame_index = obj->enemy.animation_frame % anim->frameCount;
+            if( step > 1 ) {
+                frame_index -= frame_index % step;
+            }
+            draw.slot = pose_cache_acquire(
+                &game->pose_cache, anim - game->animations.buf,
+                frame_index, bot_vertex_count );
+            buf_append( &game->pose_draws, draw );
+        }
 
-                    DrawMesh( game->models.bot.meshes[0], game->materials.enemy, transform );
-                } break;
+        double resolve_start = GetTime();
+        pose_cache_dispatch(
+            &game->pose_cache, &game->skin_batch, &state->persistent.anim_bake,
+            game->models.bot, game->animations.buf );
+        skin_batch_wait( &game->skin_batch );
+        game->pose_cache.stats.time = GetTime() - resolve_start;
+
+        RenderItem* player_item = render_queue_mesh(
+            queue, &game->models.bot.meshes[0], game->materials.bot, transform );
+        player_item->prepare      = render_prepare_pose;
+        player_item->prepare_user = state;
+        player_item->prepare_arg  = player_slot;
+
+        // NOTE(alicia): draws that share a pose are adjacent
+        // so the pose is only uploaded once and drawn in one call.
+        // Transforms are collected first so that instance
+        // pointers stay put until queue is flushed.
+        pose_draws_sort( game->pose_draws.buf, game->pose_draws.len );
+        game->instances.enemy.len = 0;
+        for( int i = 0; i < game->pose_draws.len; ++i ) {
+            buf_append( &game->instances.enemy, game->pose_draws.buf[i].transform );
+        }
+        for( int i = 0; i < game->pose_draws.len; ) {
+            int slot  = game->pose_draws.buf[i].slot;
+            int first = i;
+            while( i < game->pose_draws.len && game->pose_draws.buf[i].slot == slot ) {
+                i++;
+            }
+
+            submit_instances(
+                state, game->models.bot.meshes[0], game->materials.enemy,
+                game->instances.enemy.buf + first, i - first, false, slot );
+        }
+
+        game->instances.battery.len    = 0;
+        game->instances.level_exit.len = 0;
+        for( int i = 0; i < game->visible.objects.len; ++i ) {
+            auto* obj = frame->objects.buf + game->visible.objects.buf[i];
 
+            switch( obj->type ) {
                 case ObjectType::BATTERY: {
-                    transform =
-                        MatrixRotateXYZ( Vector3{ 0.2, obj->battery.timer, 0.2 } ) *
-                        MatrixTranslate( obj->position.x, obj->position.y, obj->position.z );
-                    DrawMesh(
-                        game->models.battery.meshes[0],
-                        game->materials.battery, transform );
+                    // NOTE(alicia): spin and bob are applied by instanced shader.
+                    buf_append(
+                        &game->instances.battery,
+                        MatrixTranslate( obj->position.x, 0.0, obj->position.z ) );
                 } break;
                 case ObjectType::LEVEL_EXIT: {
                     bool can_draw = true;
                     switch( obj->level_exit.condition ) {
                         case LevelCondition::DEFEAT_ENEMIES: {
-                            can_draw = !game->enemy_counter;
+                            can_draw = !frame->enemy_counter;
                         } break;
                         case LevelCondition::COLLECT_BATTERIES: {
-                            can_draw = !game->battery_counter;
+                            can_draw = !frame->battery_counter;
                         } break;
                         case LevelCondition::DEFEAT_ENEMIES_AND_COLLECT_BATTERIES: {
-                            can_draw = !game->enemy_counter && !game->battery_counter;
+                            can_draw = !frame->enemy_counter && !frame->battery_counter;
                         } break;
                         case LevelCondition::NONE: 
                         case LevelCondition::COUNT: break;
                     }
                     if( can_draw ) {
-                        transform =
-                            MatrixTranslate( obj->position.x, obj->position.y, obj->position.z );
-                        DrawMesh(
-                            game->models.level_exit.meshes[0],
-                            game->materials.level_exit, transform );
+                        buf_append(
+                            &game->instances.level_exit,
+                            MatrixTranslate( obj->position.x, obj->position.y, obj->position.z ) );
                     }
                 } break;
+                case ObjectType::ENEMY:
                 case ObjectType::PLAYER_SPAWN:
                 case ObjectType::NONE:
                 case ObjectType::COUNT: break;
             }
         }
 
+        submit_instances(
+            state, game->models.battery.meshes[0], game->materials.battery,
+            game->instances.battery.buf, game->instances.battery.len, true, -1 );
+        submit_instances(
+            state, game->models.level_exit.meshes[0], game->materials.level_exit,
+            game->instances.level_exit.buf, game->instances.level_exit.len, false, -1 );
+
         // DrawPlaneInv( game->materials.ceiling, {1000, 1000}, { 0.0,  10.1, 0.0 }, { 10000.0, 10000.0 }, WHITE );
         // DrawPlane   ( game->materials.floor, {1000, 1000}, { 0.0,  -0.1, 0.0 }, { 10000.0, 10000.0 }, WHITE );
-        // NOTE(alicia): END SHADER
-        EndShaderMode();
 
-        BeginShaderMode( state->sh_wall );
-
-        int apply_dist = 0;
-        SetShaderValue(
-            state->sh_wall,
-            state->sh_wall_loc_camera_position,
-            &game->camera.position, SHADER_UNIFORM_VEC3 );
-
-        /* Draw Floor/Ceiling */ {
-            SetShaderValue(
-                state->sh_wall,
-                state->sh_wall_loc_apply_dist,
-                &apply_dist, SHADER_UNIFORM_INT );
-            DrawMesh(
-                game->models.floor_ceiling.meshes[0],
+        /* Draw Floor/Ceiling */ if( game->floor.len ) {
+            // NOTE(alicia): only covers area enclosed by walls.
+            for( int i = 0; i < game->floor.len; ++i ) {
+                auto*   chunk  = game->floor.buf + i;
+                Vector3 center = Vector3Lerp( chunk->bounds.min, chunk->bounds.max, 0.5f );
+                render_queue_mesh_at(
+                    queue, &chunk->floor, game->materials.floor,
+                    MatrixIdentity(), center );
+                render_queue_mesh_at(
+                    queue, &chunk->ceiling, game->materials.ceiling,
+                    MatrixIdentity(), center );
+            }
+        } else {
+            // NOTE(alicia): walls don't enclose anything, fall back to full plane.
+            render_queue_mesh(
+                queue, &game->models.floor_ceiling.meshes[0],
                 game->materials.floor, MatrixIdentity() );
-            DrawMesh(
-                game->models.floor_ceiling.meshes[0],
+            render_queue_mesh(
+                queue, &game->models.floor_ceiling.meshes[0],
                 game->materials.ceiling,
                 MatrixRotateX( M_PI ) * MatrixTranslate( 0.0, 10.0, 0.0 ) );
         }
 
-        apply_dist = 1;
-        SetShaderValue(
-            state->sh_wall,
-            state->sh_wall_loc_apply_dist,
-            &apply_dist, SHADER_UNIFORM_INT );
-
         /* Draw Walls */ {
-            auto* vert = &game->vertexes;
-            auto* seg  = &game->segments;
-
-            for( int s = 0; s < seg->len; ++s ) {
-                Vector2 start, end;
-                start = vert->buf[seg->buf[s].start];
-                end   = vert->buf[seg->buf[s].end];
-
-                float angle = Vector2Angle( start - end, Vector2{ 0.0, 1.0 });
-                float dist  = Vector2Distance( start, end );
-
-                SetShaderValue(
-                    state->sh_wall,
-                    state->sh_wall_loc_dist,
-                    &dist, SHADER_UNIFORM_FLOAT );
-
-                Matrix transform =
-                    MatrixScale( 0.1, 10.0, dist ) *
-                    MatrixRotateY( angle ) *
-                    MatrixTranslate( start.x, 0.0, start.y );
-                DrawMesh( game->models.wall.meshes[0], game->materials.wall, transform );
+            for( int i = 0; i < game->visible.walls.len; ++i ) {
+                auto* chunk = game->walls.buf + game->visible.walls.buf[i];
+
+                // NOTE(alicia): chunk vertexes are in world space
+                // so sort by bounds center instead.
+                render_queue_mesh_at(
+                    queue, &chunk->mesh, game->materials.wall, MatrixIdentity(),
+                    Vector3Lerp( chunk->bounds.min, chunk->bounds.max, 0.5f ) );
             }
         }
 
-        EndShaderMode();
+        render_queue_flush( queue );
 
 // NOTE(alicia): DEBUG DRAWING
 #if !defined(RELEASE)
@@ -1636,8 +2190,8 @@ void game_draw( GlobalState* state, float dt ) {
         }
 
 
-        for( int i = 0; i < game->objects.len; ++i ) {
-            auto* obj = game->objects.buf + i;
+        for( int i = 0; i < frame->objects.len; ++i ) {
+            auto* obj = frame->objects.buf + i;
             if( !obj->is_active ) {
                 continue;
             }
@@ -1727,12 +2281,12 @@ void game_draw( GlobalState* state, float dt ) {
         EndMode3D();
     }
 
-    if( OptionFXAA() ) {
+    if( is_offscreen ) {
         EndTextureMode();
     }
 
     /* Draw GUI */ {
-        if( OptionFXAA() ) {
+        if( is_offscreen ) {
             blit_texture( state );
         }
 
@@ -1741,153 +2295,34 @@ void game_draw( GlobalState* state, float dt ) {
             (float)GetScreenHeight()
         };
 
-        float font_size = 36;
+        float banner_alpha = 0.0f;
         if( state->timer < LEVEL_NAME_TIME ) {
-            float t;
             if( state->timer < LEVEL_NAME_BEGIN_FADE ) {
-                t = 1.0;
+                banner_alpha = 1.0;
             } else {
-                t = 1.0 - ((state->timer - LEVEL_NAME_BEGIN_FADE) / (LEVEL_NAME_TIME - LEVEL_NAME_BEGIN_FADE));
+                banner_alpha = 1.0 - ((state->timer - LEVEL_NAME_BEGIN_FADE) / (LEVEL_NAME_TIME - LEVEL_NAME_BEGIN_FADE));
             }
-
-            const char* text  = TextFormat( "LEVEL %02i", running_map_counter );
-            Vector2 text_size = MeasureTextEx( state->persistent.font, text, font_size, 1.0 );
-            Vector2 position  = Vector2{screen.x / 2.0f, screen.y / 4.0f} - (text_size / 2.0f);
-
-            DrawTextEx(
-                state->persistent.font, text,
-                position, font_size, 1.0, ColorAlpha( RAYWHITE, t ));
-
-            position.y += text_size.y + 0.4;
-            text      = TextFormat( "%s", get_description( game->condition ) );
-            text_size = MeasureTextEx( state->persistent.font, text, font_size, 1.0 );
-            position.x = (screen.x / 2.0f) - (text_size.x / 2.0f);
-
-            DrawTextEx(
-                state->persistent.font, text,
-                position, font_size, 1.0, ColorAlpha( RAYWHITE, t ));
-
-        }
-        const char* tutorial_text = nullptr;
-        switch( running_map_counter ) {
-            case 1: {
-                if( game->player.input.is_using_gamepad ) {
-                    tutorial_text = "Use the Left Stick to move.\nPress the X button to attack and the A button to dodge.\nAll actions consume battery.";
-                } else {
-                    tutorial_text = "Press the WASD keys to move.\nPress the Left Mouse Button to attack and the Space bar to dodge.\nAll actions consume battery.";
-                }
-            } break;
-        }
-
-        if( tutorial_text ) {
-            Vector2 text_size = MeasureTextEx(
-                state->persistent.font, tutorial_text, font_size, 1.0 );
-            Vector2 position = {
-                5.0f,
-                screen.y - (text_size.y + 5.0f)
-            };
-            DrawTextEx( state->persistent.font, tutorial_text, position, font_size, 1.0, WHITE );
-        }
-
-        float power_box_label_font_size = 24;
-        const char* power_box_label  = "BATTERY";
-        Vector2 power_box_label_size =
-            MeasureTextEx(
-                state->persistent.font, power_box_label,
-                power_box_label_font_size, 1.0 );
-
-        DrawTextEx(
-            state->persistent.font, power_box_label,
-            { 30.0, 30.0 + 4.0 },
-            power_box_label_font_size, 1, WHITE );
-
-        Rectangle power_box = {
-            30.0f + power_box_label_size.x + 8.0f,
-            30.0f,
-            player->max_power * 2.0f,
-            28.0
-        };
-
-        Rectangle outline = power_box;
-        outline.x -= 2.0;
-        outline.y -= 2.0;
-        outline.width  += 4.0;
-        outline.height += 4.0;
-
-        Rectangle power_box_fill = power_box;
-        power_box_fill.width = (player->power / player->max_power) * power_box.width;
-
-        power_box_fill.x += 2.0;
-        power_box_fill.y += 2.0;
-        power_box_fill.width  -= 4.0;
-        power_box_fill.height -= 4.0;
-
-        #define draw( rect, color ) \
-            DrawRectangleRounded( rect, 0.6, 4, color )
-
-        static constexpr Color OUTLINE_COLOR  = { 249, 211, 94, 255 };
-        static constexpr Color POWER_BG_COLOR = { 50, 20, 71, 255 };
-        static constexpr Color POWER_FG_COLOR = { 52, 158, 231, 255 };
-
-        draw( outline       , OUTLINE_COLOR );
-        draw( power_box     , POWER_BG_COLOR );
-        draw( power_box_fill, POWER_FG_COLOR );
-
-        #undef draw
-
-        Vector2 text_pos = { 30.0, outline.y + outline.height };
-        font_size = 24.0;
-        switch( game->condition ) {
-            case LevelCondition::NONE: break;
-            case LevelCondition::DEFEAT_ENEMIES: {
-                DrawTextEx(
-                    state->persistent.font,
-                    TextFormat(
-                        "ENEMIES: %i / %i",
-                        game->total_enemy_count - game->enemy_counter,
-                        game->total_enemy_count ),
-                    text_pos, font_size, 1.0, WHITE );
-            } break;
-            case LevelCondition::COLLECT_BATTERIES: {
-                DrawTextEx(
-                    state->persistent.font,
-                    TextFormat(
-                        "BATTERIES: %i / %i",
-                        game->total_battery_count - game->battery_counter,
-                        game->total_battery_count ),
-                    text_pos, font_size, 1.0, WHITE );
-
-            } break;
-            case LevelCondition::DEFEAT_ENEMIES_AND_COLLECT_BATTERIES: {
-                DrawTextEx(
-                    state->persistent.font,
-                    TextFormat(
-                        "ENEMIES: %i / %i\nBATTERIES: %i / %i",
-                        game->total_enemy_count - game->enemy_counter,
-                        game->total_enemy_count,
-                        game->total_battery_count - game->battery_counter,
-                        game->total_battery_count ),
-                    text_pos, font_size, 1.0, WHITE );
-            } break;
-            case LevelCondition::COUNT:
-              break;
         }
 
-        Vector2 power_box_center = {
-            power_box.x + (power_box.width / 2.0f),
-            power_box.y + (power_box.height / 2.0f)
-        };
-        float power_text_font_size = 24.0;
-        const char* power_text =
-            TextFormat( "%i / %i", (int)roundf( player->power ), (int)player->max_power );
-        Vector2 power_text_size =
-            MeasureTextEx( state->persistent.font, power_text, power_text_font_size, 1.0 );
-        DrawTextPro(
-            state->persistent.font,
-            power_text,
-            power_box_center,
-            power_text_size / 2.0, 0.0, 24.0, 1.0,
-            RAYWHITE );
+        // NOTE(alicia): HUD is only laid out and redrawn
+        // when one of these changes.
+        HudValues hud_values;
+        hud_values.screen_width        = (int)screen.x;
+        hud_values.screen_height       = (int)screen.y;
+        hud_values.level               = running_map_counter;
+        hud_values.condition           = (int)game->condition;
+        hud_values.is_using_gamepad    = player->input.is_using_gamepad ? 1 : 0;
+        hud_values.power               = (int)roundf( player->power );
+        hud_values.max_power           = (int)player->max_power;
+        hud_values.power_fill          =
+            (int)roundf( hud_power_fill( player->power, player->max_power ) );
+        hud_values.enemies_defeated    = frame->total_enemy_count - frame->enemy_counter;
+        hud_values.total_enemy_count   = frame->total_enemy_count;
+        hud_values.batteries_collected = frame->total_battery_count - frame->battery_counter;
+        hud_values.total_battery_count = frame->total_battery_count;
+
+        hud_update( &game->hud, state->persistent.font, hud_values );
+        hud_draw( &game->hud, banner_alpha );
 
         if( game->is_paused ) {
             if( !draw_pause_menu( game->pause_menu_state ) ) {
@@ -1914,40 +2349,40 @@ void game_draw( GlobalState* state, float dt ) {
                 0.0f, fsize, 1.0f, RED );
         }
 
-        if( game->is_exiting_stage ) {
+        if( frame->is_exiting_stage ) {
             Color fade = ColorAlpha(
-                WHITE, fmin( game->exit_stage_timer / LEVEL_EXIT_FADE_TIME, 1.0f ) );
+                WHITE, fmin( frame->exit_stage_timer / LEVEL_EXIT_FADE_TIME, 1.0f ) );
             DrawRectangleRec( { 0.0, 0.0, screen.x, screen.y }, fade );
 
             const char* time_text;
-            if( game->total_enemy_count && game->total_battery_count ) {
+            if( frame->total_enemy_count && frame->total_battery_count ) {
                 time_text = TextFormat(
                     "TIME:      %.3f\n"
                     "ENEMIES:   %i / %i\n"
                     "BATTERIES: %i / %i",
-                    game->level_timer,
-                    game->total_enemy_count - game->enemy_counter,
-                    game->total_enemy_count,
-                    game->total_battery_count - game->battery_counter,
-                    game->total_battery_count );
+                    frame->level_timer,
+                    frame->total_enemy_count - frame->enemy_counter,
+                    frame->total_enemy_count,
+                    frame->total_battery_count - frame->battery_counter,
+                    frame->total_battery_count );
 
-            } else if( game->total_enemy_count ) {
+            } else if( frame->total_enemy_count ) {
                 time_text = TextFormat(
                     "TIME:      %.3f\n"
                     "ENEMIES:   %i / %i",
-                    game->level_timer,
-                    game->total_enemy_count - game->enemy_counter,
-                    game->total_enemy_count );
-            } else if( game->total_battery_count ) {
+                    frame->level_timer,
+                    frame->total_enemy_count - frame->enemy_counter,
+                    frame->total_enemy_count );
+            } else if( frame->total_battery_count ) {
                 time_text = TextFormat(
                     "TIME:      %.3f\n"
                     "BATTERIES: %i / %i",
-                    game->level_timer,
-                    game->total_battery_count - game->battery_counter,
-                    game->total_battery_count
+                    frame->level_timer,
+                    frame->total_battery_count - frame->battery_counter,
+                    frame->total_battery_count
                 );
             } else {
-                time_text = TextFormat( "TIME: %.3f", game->level_timer );
+                time_text = TextFormat( "TIME: %.3f", frame->level_timer );
             }
 
             float fsize = 48;
@@ -1966,6 +2401,86 @@ void game_draw( GlobalState* state, float dt ) {
             state->persistent.font,
             TextFormat( "%i FPS", GetFPS() ),
             {}, 24.0, 1.0, GREEN );
+
+        auto* pose_stats = &game->pose_cache.stats;
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "POSES %i/%i HIT %.0f%% SKINNED %i DECODED %i UPLOADS %i %.2fms",
+                pose_stats->hits, pose_stats->lookups,
+                pose_cache_hit_rate( *pose_stats ) * 100.0f,
+                pose_stats->skinned, pose_stats->decoded, pose_stats->uploads,
+                pose_stats->time * 1000.0 ),
+            { 0.0, 24.0 }, 24.0, 1.0, GREEN );
+
+        auto* bake = &state->persistent.anim_bake;
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "BAKE %i FRAMES %.1fMB IN %.0fms",
+                bake->frame_count, bake->memory / (1024.0 * 1024.0),
+                bake->bake_time * 1000.0 ),
+            { 0.0, 48.0 }, 24.0, 1.0, GREEN );
+
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "ANIM LOD FULL %i REDUCED %i FROZEN %i",
+                game->anim_lod_counts[(int)AnimationLOD::FULL],
+                game->anim_lod_counts[(int)AnimationLOD::REDUCED],
+                game->anim_lod_counts[(int)AnimationLOD::FROZEN] ),
+            { 0.0, 72.0 }, 24.0, 1.0, GREEN );
+
+        auto* cull = &game->cull_stats;
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "CULL OBJECTS %i/%i WALLS %i/%i CHUNKS %i/%i",
+                cull->objects_drawn, cull->objects_drawn + cull->objects_culled,
+                cull->walls_drawn, cull->walls_drawn + cull->walls_culled,
+                cull->chunks_drawn, cull->chunks_drawn + cull->chunks_culled ),
+            { 0.0, 96.0 }, 24.0, 1.0, GREEN );
+
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "PVS CELL %i VISIBLE %i/%i",
+                game->pvs.camera_leaf, game->pvs.visible_leaf_count, game->pvs.leaves.len ),
+            { 0.0, 120.0 }, 24.0, 1.0, GREEN );
+
+        auto* render = &game->render_queue.stats;
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "DRAWS %i/%i SHADERS %i TEXTURES %i UNIFORMS %i SKIPPED %i",
+                render->draw_calls, render->items,
+                render->shader_changes, render->texture_changes,
+                render->uniform_uploads, render->uniforms_skipped ),
+            { 0.0, 144.0 }, 24.0, 1.0, GREEN );
+
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "HUD REBUILDS %i BANNER %i",
+                game->hud.stats.rebuilds, game->hud.stats.banner_rebuilds ),
+            { 0.0, 168.0 }, 24.0, 1.0, GREEN );
+
+        Rectangle viewport = dynamic_resolution_viewport( dr, state->rt.texture );
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "RES %.0f%% %ix%i FRAME %.1fms BUDGET %.1fms RAISE %.0fs",
+                dr->scale * 100.0f, (int)viewport.width, (int)viewport.height,
+                dr->frame_time * 1000.0f, dr->budget * 1000.0f, dr->raise_time ),
+            { 0.0, 192.0 }, 24.0, 1.0, GREEN );
+
+        DrawTextEx(
+            state->persistent.font,
+            TextFormat(
+                "FLOOR CHUNKS %i TRIS %i AREA %.1f / %.1f",
+                game->floor.len, game->floor.outline.indexes.len / 3,
+                game->floor.outline.triangle_area, game->floor.outline.polygon_area ),
+            { 0.0, 216.0 }, 24.0, 1.0, GREEN );
 #endif
 
     }
@@ -1973,13 +2488,47 @@ void game_draw( GlobalState* state, float dt ) {
     EndDrawing();
 }
 
+void draw_loading_screen( GlobalState* state, float progress ) {
+    BeginDrawing();
+    ClearBackground( BLACK );
+
+    Vector2 screen = get_screen();
+
+    float   fsize        = 32.0;
+    Vector2 text_measure = MeasureTextEx( state->persistent.font, "Loading", fsize, 1.0 );
+    DrawTextPro(
+        state->persistent.font, "Loading",
+        (screen / 2.0) - Vector2{ 0.0, fsize }, text_measure / 2.0, 0.0,
+        fsize, 1.0, WHITE );
+
+    Rectangle bar = { 0.0, 0.0, screen.x / 3.0f, 8.0 };
+    bar.x = (screen.x / 2.0f) - (bar.width / 2.0f);
+    bar.y = (screen.y / 2.0f);
+
+    DrawRectangleLinesEx( bar, 1.0, GRAY );
+    bar.width *= progress;
+    DrawRectangleRec( bar, WHITE );
+
+    EndDrawing();
+}
 void blit_texture( GlobalState* state ) {
-    BeginShaderMode( state->sh_post_process );
-        DrawTextureRec(
+    Rectangle viewport = dynamic_resolution_viewport(
+        &state->dynamic_resolution, state->rt.texture );
+    Rectangle dst = {
+        0, 0, (float)state->rt.texture.width, (float)state->rt.texture.height };
+
+    // NOTE(alicia): FXAA offsets are in texels of whole target
+    // so resolution doesn't change with scale.
+    if( OptionFXAA() ) {
+        BeginShaderMode( state->sh_post_process );
+    }
+        DrawTexturePro(
             state->rt.texture,
-            { 0, 0, (float)state->rt.texture.width, -(float)state->rt.texture.height },
-            {}, WHITE );
-    EndShaderMode();
+            { 0, 0, viewport.width, -viewport.height },
+            dst, {}, 0.0, WHITE );
+    if( OptionFXAA() ) {
+        EndShaderMode();
+    }
 }
 void set_pause( GlobalState* state, bool paused ) {
     auto* game = &state->transient.game;
@@ -1995,32 +2544,6 @@ void set_pause( GlobalState* state, bool paused ) {
         DisableCursor();
     }
 }
-void load_sound_set( SoundBuffer* buf, const char* name ) {
-    if( buf->buf ) {
-        free( buf->buf );
-    }
-
-    int count = 0;
-    for( ;; ) {
-        const char* path_to_test = TextFormat( "resources/audio/sfx/%s_%i.wav", name, count );
-        if( !FileExists( path_to_test ) ) {
-            break;
-        }
-        count++;
-    }
-    if( !count ) {
-        TraceLog( LOG_ERROR, "No sound effects exist with name %s!", name );
-        return;
-    }
-
-    buf->buf = (Sound*)calloc( count, sizeof(Sound) );
-    buf->cap = count;
-
-    for( int i = 0; i < buf->cap; ++i ) {
-        Sound sound = LoadSound( TextFormat( "resources/audio/sfx/%s_%i.wav", name, i ) );
-        buf_append( buf, sound );
-    }
-}
 void upload_obj( GlobalState* state, Object& obj ) {
     auto* objects = &state->transient.game.objects;
     if( objects->len ) {
@@ -2055,10 +2578,143 @@ void spawn_level_exit( GlobalState* state, Vector2 position, LevelCondition cond
     Object obj = Object::create_level_exit( position, condition );
     upload_obj( state, obj );
 }
-void load_next_map( GlobalState* state ) {
-    load_map( state, TextFormat( "resources/maps/level_%02i.map", running_map_counter++ ) );
+bool map_decode( AssetLoader* assets, MapData* out_map, const char* path ) {
+    out_map->is_valid      = false;
+    out_map->objects.len   = 0;
+    out_map->player_spawn  = {};
+    out_map->enemy_count   = 0;
+    out_map->battery_count = 0;
+    out_map->condition     = LevelCondition::NONE;
+
+    // NOTE(alicia): vertexes and segments may still point into
+    // previous file so they have to be dropped before it's closed.
+    map_buf_reset( &out_map->vertexes );
+    map_buf_reset( &out_map->segments );
+    map_buf_reset( &out_map->accel_data );
+    out_map->accel = {};
+    mapped_file_close( &out_map->file );
+
+    if( !assets_file_view( assets, path, &out_map->file ) ) {
+        return false;
+    }
+    TraceLog( LOG_INFO, "Mapped %i bytes.", (int)out_map->file.size );
+
+    MapFileView view = {};
+    if(
+        out_map->file.size > INT32_MAX ||
+        !map_file_parse( out_map->file.data, (int)out_map->file.size, &view )
+    ) {
+        mapped_file_close( &out_map->file );
+        return false;
+    }
+
+    for( uint32_t i = 0; i < view.object_count; ++i ) {
+        auto* o = view.objects + i;
+        switch( o->type ) {
+            case ObjectType::ENEMY: {
+                Object enemy = Object::create_enemy(
+                    { o->position.x, 0.0, o->position.y },
+                    o->rotation, E_DEFAULT_RADIUS );
+                buf_append( &out_map->objects, enemy );
+                out_map->enemy_count++;
+            } break;
+
+            case ObjectType::PLAYER_SPAWN: {
+                out_map->player_spawn = { o->position.x, 0, o->position.y };
+            } break;
+
+            case ObjectType::BATTERY: {
+                Object battery = Object::create_battery( o->position );
+                buf_append( &out_map->objects, battery );
+                out_map->battery_count++;
+            } break;
+            case ObjectType::LEVEL_EXIT: {
+                Object level_exit = Object::create_level_exit(
+                    o->position, o->level_exit.condition );
+                buf_append( &out_map->objects, level_exit );
+                out_map->condition = o->level_exit.condition;
+            } break;
+            case ObjectType::NONE:
+            case ObjectType::COUNT: break;
+        }
+    }
+
+    // NOTE(alicia): vertexes and segments are used in place,
+    // only v1 segments have to be widened.
+    map_buf_view( &out_map->vertexes, view.vertexes, (int)view.vertex_count );
+    if( view.segments ) {
+        map_buf_view( &out_map->segments, view.segments, (int)view.segment_count );
+    } else {
+        map_buf_reserve( &out_map->segments, (int)view.segment_count );
+        for( uint32_t i = 0; i < view.segment_count; ++i ) {
+            out_map->segments.buf[i] = map_view_segment( &view, i );
+        }
+        out_map->segments.len = view.segment_count;
+    }
+
+    if(
+        view.accel && map_accel_parse(
+            view.accel, view.accel_size,
+            out_map->vertexes.buf, out_map->vertexes.len,
+            out_map->segments.buf, out_map->segments.len,
+            &out_map->accel )
+    ) {
+        map_buf_view( &out_map->accel_data, (uint8_t*)view.accel, (int)view.accel_size );
+    } else {
+        // NOTE(alicia): map was saved before acceleration data existed
+        // or its version is stale, resave it in the editor to bake it.
+        TraceLog( LOG_INFO, "Rebuilding acceleration data for %s . . .", path );
+
+        uint32_t accel_size = 0;
+        void*    accel      = map_accel_build(
+            out_map->vertexes.buf, out_map->vertexes.len,
+            out_map->segments.buf, out_map->segments.len, &accel_size );
+        if( accel ) {
+            map_buf_free( &out_map->accel_data );
+            out_map->accel_data.buf = (uint8_t*)accel;
+            out_map->accel_data.len = out_map->accel_data.cap = (int)accel_size;
+
+            map_accel_parse(
+                accel, accel_size,
+                out_map->vertexes.buf, out_map->vertexes.len,
+                out_map->segments.buf, out_map->segments.len,
+                &out_map->accel );
+        }
+    }
+
+    out_map->is_valid = true;
+    return true;
 }
-void load_map( GlobalState* state, const char* path ) {
+void map_free( MapData* map ) {
+    if( map->objects.buf ) {
+        free( map->objects.buf );
+    }
+    map_buf_free( &map->vertexes );
+    map_buf_free( &map->segments );
+    map_buf_free( &map->accel_data );
+    mapped_file_close( &map->file );
+    *map = {};
+}
+
+static void map_decode_job( void* params ) {
+    auto* state = (GlobalState*)params;
+    auto* game  = &state->transient.game;
+    map_decode( &state->persistent.assets, &game->next_map.map, game->next_map.path );
+}
+void prefetch_map( GlobalState* state, int index ) {
+    auto* game = &state->transient.game;
+    jobs_wait( &game->next_map.counter );
+
+    // NOTE(alicia): TextFormat isn't thread safe so path is copied.
+    strcpy(
+        game->next_map.path,
+        TextFormat( "resources/maps/level_%02i.map", index ) );
+    game->next_map.index = index;
+    jobs_submit( &game->next_map.counter, map_decode_job, state );
+}
+
+/// @brief Reset everything that isn't loaded from the map file.
+void level_reset_state( GlobalState* state ) {
     auto* game   = &state->transient.game;
     state->timer = 0.0;
 
@@ -2073,6 +2729,7 @@ void load_map( GlobalState* state, const char* path ) {
 
     game->battery_counter     = 0;
     game->total_battery_count = 0;
+    game->battery_time        = 0;
 
     player_init( &game->player );
     camera_init( &game->camera );
@@ -2091,84 +2748,153 @@ void load_map( GlobalState* state, const char* path ) {
             game->materials.wall.maps->texture = game->textures.wall;
         } break;
     }
+}
+/// @brief Swap decoded map into game state.
+/// @return False if map is invalid, in which case game mode has been unloaded.
+bool map_enter( GlobalState* state, MapData* map, const char* path ) {
+    auto* game = &state->transient.game;
 
-    int size = 0;
-    unsigned char* data = LoadFileData( path, &size );
-    TraceLog( LOG_INFO, "Loaded %i bytes.", size );
+    level_reset_state( state );
 
-    MapFileHeader* header = (MapFileHeader*)data;
-    if(
-        ( size < (int)sizeof(*header) ) ||
-        ( memcmp( header->identifier, MAP_IDENTIFIER, 4 ) != 0 ) ||
-        ( size != (int)header->total_size )
-    ) {
+    if( !map->is_valid ) {
         TraceLog( LOG_ERROR, "%s is an invalid file!", path );
         mode_set( state, Mode::MAIN_MENU );
-        return;
+        return false;
     }
 
-    MapFileObject*  obj  = (MapFileObject*)(header + 1);
-    Vector2*        vert = (Vector2*)(obj + header->object_count);
-    MapFileSegment* seg  = (MapFileSegment*)(vert + header->vertex_count);
+    // NOTE(alicia): old level's buffers go back to map
+    // so their memory is reused for the next decode.
+    ObjectBuffer objects = game->objects;
+    game->objects        = map->objects;
+    map->objects         = objects;
+
+    VertexBuffer vertexes = game->vertexes;
+    game->vertexes        = map->vertexes;
+    map->vertexes         = vertexes;
+
+    SegmentBuffer segments = game->segments;
+    game->segments         = map->segments;
+    map->segments          = segments;
+
+    AccelBuffer accel_data = game->accel_data;
+    game->accel_data       = map->accel_data;
+    map->accel_data        = accel_data;
+
+    MapAccelView accel = game->accel;
+    game->accel        = map->accel;
+    map->accel         = accel;
+
+    MappedFile file = game->map_file;
+    game->map_file  = map->file;
+    map->file       = file;
+    map->is_valid   = false;
+
+    auto* query = &game->segment_query;
+    if( query->cap < game->segments.len ) {
+        query->stamps = (uint32_t*)realloc(
+            query->stamps, sizeof(uint32_t) * game->segments.len );
+        query->results = (uint32_t*)realloc(
+            query->results, sizeof(uint32_t) * game->segments.len );
+        query->cap = game->segments.len;
+    }
+    if( query->stamps ) {
+        memset( query->stamps, 0, sizeof(uint32_t) * query->cap );
+    }
+    query->stamp = 0;
+
+    wall_batch_build(
+        &game->walls, game->models.wall.meshes[0],
+        game->vertexes.buf, game->segments.buf, game->segments.len );
+    floor_mesh_build(
+        &game->floor,
+        game->vertexes.buf, game->segments.buf, game->segments.len );
+    pvs_build(
+        &game->pvs, game->vertexes.buf, game->segments.buf, game->segments.len,
+        game->walls.segment_chunk, game->walls.len );
+
+    game->enemy_counter       = map->enemy_count;
+    game->total_enemy_count   = map->enemy_count;
+    game->battery_counter     = map->battery_count;
+    game->total_battery_count = map->battery_count;
+    game->condition           = map->condition;
+    game->player.position     = map->player_spawn;
+
+    auto* start = &game->level_start;
+    if( start->objects.cap < game->objects.len ) {
+        start->objects.buf = (Object*)realloc(
+            start->objects.buf, sizeof(Object) * game->objects.len );
+        start->objects.cap = game->objects.len;
+    }
+    if( game->objects.len ) {
+        memcpy( start->objects.buf, game->objects.buf, sizeof(Object) * game->objects.len );
+    }
+    start->objects.len   = game->objects.len;
+    start->player_spawn  = map->player_spawn;
+    start->enemy_count   = map->enemy_count;
+    start->battery_count = map->battery_count;
+    start->condition     = map->condition;
+    start->is_valid      = true;
 
-    auto* st = game;
-    st->objects.len  = 0;
-    st->segments.len = 0;
-    st->vertexes.len = 0;
+    frame_packet_capture( state, game->frames + game->frame_read );
 
-    if( st->objects.cap < header->object_count) {
-        st->objects.buf = (Object*)realloc(
-            st->objects.buf, sizeof(Object) * header->object_count );
-    }
-    if( st->vertexes.cap < header->vertex_count ) {
-        st->vertexes.buf = (Vector2*)realloc(
-            st->vertexes.buf, sizeof(Vector2) * header->vertex_count );
+    TraceLog( LOG_INFO, "Loaded %s!", path );
+    return true;
+}
+void reset_level( GlobalState* state ) {
+    auto* game  = &state->transient.game;
+    auto* start = &game->level_start;
+
+    if( !start->is_valid ) {
+        running_map_counter--;
+        load_next_map( state );
+        return;
     }
-    if( st->segments.cap < header->segment_count ) {
-        st->segments.buf = (Segment*)realloc(
-            st->segments.buf, sizeof(Segment) * header->segment_count );
+
+    level_reset_state( state );
+
+    // NOTE(alicia): objects are only ever modified in place or appended
+    // during play so capacity always fits the snapshot.
+    if( start->objects.len ) {
+        memcpy( game->objects.buf, start->objects.buf, sizeof(Object) * start->objects.len );
     }
+    game->objects.len = start->objects.len;
 
-    for( uint16_t i = 0; i < header->object_count; ++i ) {
-        auto* o = obj + i;
-        switch( o->type ) {
-            case ObjectType::ENEMY: {
-                spawn_enemy(
-                    state, { o->position.x, 0.0, o->position.y },
-                    o->rotation, E_DEFAULT_RADIUS );
-                game->enemy_counter++;
-                game->total_enemy_count++;
-            } break;
+    game->enemy_counter       = start->enemy_count;
+    game->total_enemy_count   = start->enemy_count;
+    game->battery_counter     = start->battery_count;
+    game->total_battery_count = start->battery_count;
+    game->condition           = start->condition;
+    game->player.position     = start->player_spawn;
 
-            case ObjectType::PLAYER_SPAWN: {
-                game->player.position = { o->position.x, 0, o->position.y };
-            } break;
+    frame_packet_capture( state, game->frames + game->frame_read );
+}
+void load_next_map( GlobalState* state ) {
+    auto* game  = &state->transient.game;
+    int   index = running_map_counter++;
+
+    jobs_wait( &game->next_map.counter );
+    if( game->next_map.index != index || !game->next_map.path[0] ) {
+        strcpy(
+            game->next_map.path,
+            TextFormat( "resources/maps/level_%02i.map", index ) );
+        map_decode( &state->persistent.assets, &game->next_map.map, game->next_map.path );
+    }
+    game->next_map.index = -1;
 
-            case ObjectType::BATTERY: {
-                spawn_battery( state, o->position );
-                game->battery_counter++;
-                game->total_battery_count++;
-            } break;
-            case ObjectType::LEVEL_EXIT: {
-                spawn_level_exit( state, o->position, o->level_exit.condition );
-                game->condition = o->level_exit.condition;
-            } break;
-            case ObjectType::NONE:
-            case ObjectType::COUNT: break;
-        }
+    if( map_enter( state, &game->next_map.map, game->next_map.path ) ) {
+        prefetch_map( state, running_map_counter );
     }
+}
+void load_map( GlobalState* state, const char* path ) {
+    auto* game = &state->transient.game;
 
-    memcpy( st->vertexes.buf, vert, sizeof(Vector2) * header->vertex_count );
-    st->vertexes.len = header->vertex_count;
+    jobs_wait( &game->next_map.counter );
+    map_decode( &state->persistent.assets, &game->next_map.map, path );
+    game->next_map.index = -1;
 
-    for( uint16_t i = 0; i < header->segment_count; ++i ) {
-        Segment s = {};
-        s.start = seg[i].start;
-        s.end   = seg[i].end;
-        buf_append( &st->segments, s );
+    if( map_enter( state, &game->next_map.map, path ) ) {
+        prefetch_map( state, running_map_counter );
     }
-    UnloadFileData( data );
-    TraceLog( LOG_INFO, "Loaded %s!", path );
 }
 void DrawPlane(
     Material mat, Vector2 texture_tile, Vector3 centerPos,
@@ -2230,6 +2956,58 @@ void DrawPlaneInv(
         rlEnd();
     rlPopMatrix();
 }
+/// @brief Battery spin and bob, applied before battery's translation.
+Matrix battery_bob_transform( float time ) {
+    return
+        MatrixRotateXYZ( Vector3{ 0.2, time, 0.2 } ) *
+        MatrixTranslate( 0.0, Lerp( 1.0 - 0.1, 1.0 + 0.2, (sin( time ) + 1.0) / 2.0 ), 0.0 );
+}
+void submit_instances(
+    GlobalState* state, const Mesh& mesh, Material material,
+    const Matrix* instances, int instance_count, bool apply_bob, int pose_slot
+) {
+    auto* game  = &state->transient.game;
+    auto* queue = &game->render_queue;
+    auto* frame = game->frames + game->frame_read;
+    if( !instance_count ) {
+        return;
+    }
+
+#if defined(PLATFORM_WEB)
+    Matrix bob = MatrixIdentity();
+    if( apply_bob ) {
+        bob = battery_bob_transform( frame->battery_time );
+    }
+    for( int i = 0; i < instance_count; ++i ) {
+        RenderItem* item = render_queue_mesh( queue, &mesh, material, bob * instances[i] );
+        if( pose_slot >= 0 ) {
+            item->prepare      = render_prepare_pose;
+            item->prepare_user = state;
+            item->prepare_arg  = pose_slot;
+        }
+    }
+#else
+    material.shader = apply_bob ? state->sh_instanced_bob : state->sh_instanced;
+    RenderItem* item = render_queue_instanced(
+        queue, &mesh, material, instances, instance_count );
+
+    if( apply_bob ) {
+        render_item_uniform(
+            item, state->sh_instanced_bob_loc_bob_time,
+            &frame->battery_time, SHADER_UNIFORM_FLOAT );
+    }
+
+    if( pose_slot >= 0 ) {
+        item->prepare      = render_prepare_pose;
+        item->prepare_user = state;
+        item->prepare_arg  = pose_slot;
+    }
+#endif
+}
+void render_prepare_pose( void* user, int slot ) {
+    auto* game = &((GlobalState*)user)->transient.game;
+    pose_cache_upload( &game->pose_cache, game->models.bot.meshes[0], slot );
+}
 Vector2 world_collision_check(
     int segment_count, Segment* segments, Vector2* vertexes,
     Vector2 position, Vector2 velocity, float radius
@@ -2260,4 +3038,35 @@ Vector2 world_collision_check(
 
     return velocity;
 }
+Vector2 segment_normal( GlobalState* state, uint32_t index ) {
+    auto* game = &state->transient.game;
+    if( game->accel.is_valid ) {
+        return game->accel.normals[index];
+    }
+
+    // NOTE(alicia): same as map_accel_build bakes.
+    Segment* seg   = game->segments.buf + index;
+    Vector2  start = game->vertexes.buf[seg->start];
+    Vector2  end   = game->vertexes.buf[seg->end];
+    return Vector2Rotate( Vector2Normalize( start - end ), 90 * (M_PI / 180.0) );
+}
+int segments_near( GlobalState* state, Vector2 min, Vector2 max ) {
+    auto* game  = &state->transient.game;
+    auto* query = &game->segment_query;
 
+    // NOTE(alicia): without acceleration data every segment is near.
+    if( !game->accel.is_valid ) {
+        for( int i = 0; i < game->segments.len; ++i ) {
+            query->results[i] = i;
+        }
+        return game->segments.len;
+    }
+
+    if( ++query->stamp == 0 ) {
+        memset( query->stamps, 0, sizeof(uint32_t) * query->cap );
+        query->stamp = 1;
+    }
+    return map_accel_query(
+        &game->accel, min, max, query->stamps, query->stamp,
+        query->results, query->cap );
+}
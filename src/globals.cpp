@@ -9,6 +9,7 @@
 struct Globals {
     Vector2 camera_sensitivity = { 0.75f, 0.75f };
     bool    fxaa_on            = true;
+    bool    dynamic_resolution = true;
 
     bool inverse_x = true;
     bool inverse_y = false;
@@ -77,6 +78,12 @@ bool OptionFXAA() {
 void OptionFXAA( bool is_on ) {
     globals.fxaa_on = is_on;
 }
+bool OptionDynamicResolution() {
+    return globals.dynamic_resolution;
+}
+void OptionDynamicResolution( bool is_on ) {
+    globals.dynamic_resolution = is_on;
+}
 
 Font GameFont() {
     return globals.game_font;
@@ -108,9 +108,20 @@ bool draw_options_menu() {
     }
     r_slider.y = r_button.y += button_spacing + button_height;
 
-    if( GuiButton( r_button, TextFormat( "FXAA: %s", OptionFXAA() ? "ON" : "OFF" )) ) {
+    // NOTE(alicia): FXAA and dynamic resolution share a row
+    // so that options still fit at small window sizes.
+    Rectangle r_half = r_button;
+    r_half.width = (r_button.width - button_spacing) / 2.0;
+    if( GuiButton( r_half, TextFormat( "FXAA: %s", OptionFXAA() ? "ON" : "OFF" )) ) {
         OptionFXAA( !OptionFXAA() );
     }
+    r_half.x += r_half.width + button_spacing;
+    if( GuiButton(
+        r_half, TextFormat(
+            "Dynamic Resolution: %s", OptionDynamicResolution() ? "ON" : "OFF" )
+    ) ) {
+        OptionDynamicResolution( !OptionDynamicResolution() );
+    }
     r_slider.y = r_button.y += button_spacing + button_height;
 
     Vector2 sensitivity = OptionCameraSensitivity();
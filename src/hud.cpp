@@ -0,0 +1,278 @@
+/**
+ * @file   hud.cpp
+ * @brief  Retained HUD, text is laid out and drawn into
+ * render textures only when displayed values change.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "hud.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "math_ex.h"
+#include <string.h>
+
+#define HUD_POWER_BOX_X        (30.0f)
+#define HUD_POWER_BOX_Y        (30.0f)
+#define HUD_POWER_BOX_HEIGHT   (28.0f)
+#define HUD_POWER_BOX_BORDER   (2.0f)
+#define HUD_LABEL_FONT_SIZE    (24.0f)
+#define HUD_COUNTER_FONT_SIZE  (24.0f)
+#define HUD_BANNER_FONT_SIZE   (36.0f)
+#define HUD_TUTORIAL_FONT_SIZE (36.0f)
+
+static constexpr Color HUD_OUTLINE_COLOR  = { 249, 211, 94, 255 };
+static constexpr Color HUD_POWER_BG_COLOR = { 50, 20, 71, 255 };
+static constexpr Color HUD_POWER_FG_COLOR = { 52, 158, 231, 255 };
+
+float hud_power_fill( float power, float max_power ) {
+    float width = max_power * 2.0f;
+    return ((power / max_power) * width) - (HUD_POWER_BOX_BORDER * 2.0f);
+}
+
+static bool hud_target_fit( RenderTexture* rt, int width, int height ) {
+    width  = Max( width, 1 );
+    height = Max( height, 1 );
+    if( IsRenderTextureValid( *rt ) ) {
+        if( rt->texture.width == width && rt->texture.height == height ) {
+            return true;
+        }
+        UnloadRenderTexture( *rt );
+    }
+    *rt = LoadRenderTexture( width, height );
+    if( !IsRenderTextureValid( *rt ) ) {
+        *rt = {};
+        return false;
+    }
+    SetTextureFilter( rt->texture, TEXTURE_FILTER_BILINEAR );
+    return true;
+}
+
+static void hud_target_begin( RenderTexture rt ) {
+    BeginTextureMode( rt );
+    ClearBackground( BLANK );
+
+    // NOTE(alicia): texture holds premultiplied color,
+    // otherwise alpha gets multiplied twice on text edges
+    // once when drawing into texture and again when drawing texture.
+    rlSetBlendFactorsSeparate(
+        RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA,
+        RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+        RL_FUNC_ADD, RL_FUNC_ADD );
+    BeginBlendMode( BLEND_CUSTOM_SEPARATE );
+}
+static void hud_target_end() {
+    EndBlendMode();
+    EndTextureMode();
+}
+
+static const char* hud_tutorial_text( const HudValues& values ) {
+    switch( values.level ) {
+        case 1: {
+            if( values.is_using_gamepad ) {
+                return "Use the Left Stick to move.\nPress the X button to attack and the A button to dodge.\nAll actions consume battery.";
+            } else {
+                return "Press the WASD keys to move.\nPress the Left Mouse Button to attack and the Space bar to dodge.\nAll actions consume battery.";
+            }
+        } break;
+    }
+    return nullptr;
+}
+
+static void hud_rebuild( Hud* hud, Font font, const HudValues& values ) {
+    if( !hud_target_fit( &hud->rt, values.screen_width, values.screen_height ) ) {
+        return;
+    }
+    hud_target_begin( hud->rt );
+
+    Vector2 screen = { (float)values.screen_width, (float)values.screen_height };
+
+    const char* tutorial_text = hud_tutorial_text( values );
+    if( tutorial_text ) {
+        Vector2 text_size = MeasureTextEx(
+            font, tutorial_text, HUD_TUTORIAL_FONT_SIZE, 1.0 );
+        Vector2 position = {
+            5.0f,
+            screen.y - (text_size.y + 5.0f)
+        };
+        DrawTextEx( font, tutorial_text, position, HUD_TUTORIAL_FONT_SIZE, 1.0, WHITE );
+    }
+
+    const char* power_box_label  = "BATTERY";
+    Vector2 power_box_label_size =
+        MeasureTextEx( font, power_box_label, HUD_LABEL_FONT_SIZE, 1.0 );
+
+    DrawTextEx(
+        font, power_box_label,
+        { HUD_POWER_BOX_X, HUD_POWER_BOX_Y + 4.0f },
+        HUD_LABEL_FONT_SIZE, 1, WHITE );
+
+    Rectangle power_box = {
+        HUD_POWER_BOX_X + power_box_label_size.x + 8.0f,
+        HUD_POWER_BOX_Y,
+        values.max_power * 2.0f,
+        HUD_POWER_BOX_HEIGHT
+    };
+
+    Rectangle outline = power_box;
+    outline.x -= HUD_POWER_BOX_BORDER;
+    outline.y -= HUD_POWER_BOX_BORDER;
+    outline.width  += HUD_POWER_BOX_BORDER * 2.0f;
+    outline.height += HUD_POWER_BOX_BORDER * 2.0f;
+
+    Rectangle power_box_fill = power_box;
+    power_box_fill.x += HUD_POWER_BOX_BORDER;
+    power_box_fill.y += HUD_POWER_BOX_BORDER;
+    power_box_fill.width   = (float)values.power_fill;
+    power_box_fill.height -= HUD_POWER_BOX_BORDER * 2.0f;
+
+    #define draw( rect, color ) \
+        DrawRectangleRounded( rect, 0.6, 4, color )
+
+    draw( outline  , HUD_OUTLINE_COLOR );
+    draw( power_box, HUD_POWER_BG_COLOR );
+    if( values.power_fill > 0 ) {
+        draw( power_box_fill, HUD_POWER_FG_COLOR );
+    }
+
+    #undef draw
+
+    Vector2 text_pos = { HUD_POWER_BOX_X, outline.y + outline.height };
+    switch( (LevelCondition)values.condition ) {
+        case LevelCondition::NONE: break;
+        case LevelCondition::DEFEAT_ENEMIES: {
+            DrawTextEx(
+                font,
+                TextFormat(
+                    "ENEMIES: %i / %i",
+                    values.enemies_defeated, values.total_enemy_count ),
+                text_pos, HUD_COUNTER_FONT_SIZE, 1.0, WHITE );
+        } break;
+        case LevelCondition::COLLECT_BATTERIES: {
+            DrawTextEx(
+                font,
+                TextFormat(
+                    "BATTERIES: %i / %i",
+                    values.batteries_collected, values.total_battery_count ),
+                text_pos, HUD_COUNTER_FONT_SIZE, 1.0, WHITE );
+        } break;
+        case LevelCondition::DEFEAT_ENEMIES_AND_COLLECT_BATTERIES: {
+            DrawTextEx(
+                font,
+                TextFormat(
+                    "ENEMIES: %i / %i\nBATTERIES: %i / %i",
+                    values.enemies_defeated, values.total_enemy_count,
+                    values.batteries_collected, values.total_battery_count ),
+                text_pos, HUD_COUNTER_FONT_SIZE, 1.0, WHITE );
+        } break;
+        case LevelCondition::COUNT:
+          break;
+    }
+
+    Vector2 power_box_center = {
+        power_box.x + (power_box.width / 2.0f),
+        power_box.y + (power_box.height / 2.0f)
+    };
+    const char* power_text = TextFormat( "%i / %i", values.power, values.max_power );
+    Vector2 power_text_size =
+        MeasureTextEx( font, power_text, HUD_LABEL_FONT_SIZE, 1.0 );
+    DrawTextPro(
+        font, power_text, power_box_center,
+        power_text_size / 2.0, 0.0, HUD_LABEL_FONT_SIZE, 1.0, RAYWHITE );
+
+    hud_target_end();
+    hud->stats.rebuilds++;
+}
+
+static void hud_rebuild_banner( Hud* hud, Font font, const HudValues& values ) {
+    const char* level_text  = TextFormat( "LEVEL %02i", values.level );
+    Vector2     level_size  = MeasureTextEx( font, level_text, HUD_BANNER_FONT_SIZE, 1.0 );
+    const char* description = get_description( (LevelCondition)values.condition );
+    Vector2     description_size =
+        MeasureTextEx( font, description, HUD_BANNER_FONT_SIZE, 1.0 );
+
+    Vector2 size = {
+        fmaxf( level_size.x, description_size.x ),
+        level_size.y + 0.4f + description_size.y
+    };
+    if( !hud_target_fit( &hud->banner, (int)ceilf( size.x ), (int)ceilf( size.y ) ) ) {
+        return;
+    }
+
+    // NOTE(alicia): level text is centered on a quarter of
+    // screen height, description goes right under it.
+    Vector2 screen = { (float)values.screen_width, (float)values.screen_height };
+    hud->banner_position = {
+        floorf( (screen.x - size.x) / 2.0f ),
+        floorf( (screen.y / 4.0f) - (level_size.y / 2.0f) )
+    };
+
+    hud_target_begin( hud->banner );
+
+    DrawTextEx(
+        font, level_text,
+        { floorf( (size.x - level_size.x) / 2.0f ), 0.0f },
+        HUD_BANNER_FONT_SIZE, 1.0, RAYWHITE );
+    DrawTextEx(
+        font, description,
+        { floorf( (size.x - description_size.x) / 2.0f ), level_size.y + 0.4f },
+        HUD_BANNER_FONT_SIZE, 1.0, RAYWHITE );
+
+    hud_target_end();
+    hud->stats.banner_rebuilds++;
+}
+
+void hud_update( Hud* hud, Font font, const HudValues& values ) {
+    bool is_banner_changed =
+        !hud->is_banner_valid                             ||
+        hud->values.screen_width  != values.screen_width  ||
+        hud->values.screen_height != values.screen_height ||
+        hud->values.level         != values.level         ||
+        hud->values.condition     != values.condition;
+    bool is_changed =
+        !hud->is_valid || memcmp( &hud->values, &values, sizeof(values) ) != 0;
+
+    if( is_banner_changed ) {
+        hud_rebuild_banner( hud, font, values );
+        hud->is_banner_valid = IsRenderTextureValid( hud->banner );
+    }
+    if( is_changed ) {
+        hud_rebuild( hud, font, values );
+        hud->is_valid = IsRenderTextureValid( hud->rt );
+    }
+    hud->values = values;
+}
+
+void hud_draw( Hud* hud, float banner_alpha ) {
+    BeginBlendMode( BLEND_ALPHA_PREMULTIPLY );
+
+    // NOTE(alicia): render textures are stored upside down.
+    if( hud->is_banner_valid && banner_alpha > 0.0f ) {
+        unsigned char a = (unsigned char)(Clamp( banner_alpha, 0.0f, 1.0f ) * 255.0f);
+        DrawTextureRec(
+            hud->banner.texture,
+            { 0.0f, 0.0f,
+              (float)hud->banner.texture.width,
+              -(float)hud->banner.texture.height },
+            hud->banner_position, Color{ a, a, a, a } );
+    }
+    if( hud->is_valid ) {
+        DrawTextureRec(
+            hud->rt.texture,
+            { 0.0f, 0.0f,
+              (float)hud->rt.texture.width,
+              -(float)hud->rt.texture.height },
+            {}, WHITE );
+    }
+
+    EndBlendMode();
+}
+
+void hud_free( Hud* hud ) {
+    if( IsRenderTextureValid( hud->rt ) ) {
+        UnloadRenderTexture( hud->rt );
+    }
+    if( IsRenderTextureValid( hud->banner ) ) {
+        UnloadRenderTexture( hud->banner );
+    }
+    *hud = {};
+}
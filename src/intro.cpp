@@ -11,7 +11,8 @@
 
 void mode_intro_load( GlobalState* state ) {
     if( !IsTextureValid( state->persistent.tex_main_menu ) ) {
-        state->persistent.tex_main_menu = LoadTexture( "resources/textures/logo.png" );
+        state->persistent.tex_main_menu = assets_load_texture(
+            &state->persistent.assets, "resources/textures/logo.png" );
         SetTextureFilter(
             state->persistent.tex_main_menu, TEXTURE_FILTER_BILINEAR );
     }
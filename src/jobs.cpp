@@ -0,0 +1,269 @@
+/**
+ * @file   jobs.cpp
+ * @brief  Minimal worker thread pool.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 04, 2025
+*/
+#include "jobs.h"
+
+#if defined(PLATFORM_WEB)
+    #define JOBS_NO_THREADS
+#elif defined(_WIN32)
+    // NOTE(alicia): windows.h clashes with raylib so
+    // only declare what is needed.
+    extern "C" {
+        typedef unsigned long (__stdcall _ThreadProc)( void* );
+        __declspec(dllimport) void* __stdcall CreateThread(
+            void*, unsigned long long, _ThreadProc*, void*, unsigned long, unsigned long* );
+        __declspec(dllimport) void* __stdcall CreateSemaphoreA(
+            void*, long, long, const char* );
+        __declspec(dllimport) int __stdcall ReleaseSemaphore( void*, long, long* );
+        __declspec(dllimport) unsigned long __stdcall WaitForSingleObject( void*, unsigned long );
+        __declspec(dllimport) int __stdcall CloseHandle( void* );
+        __declspec(dllimport) int __stdcall SwitchToThread(void);
+        __declspec(dllimport) unsigned long __stdcall GetActiveProcessorCount( unsigned short );
+    }
+    #define _INFINITE (0xFFFFFFFF)
+    #define _ALL_PROCESSOR_GROUPS (0xFFFF)
+#else
+    #include <pthread.h>
+    #include <semaphore.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+struct Job {
+    JobFn*      fn;
+    void*       params;
+    JobCounter* counter;
+};
+
+struct JobQueue {
+    Job  ring[JOBS_QUEUE_SIZE];
+    int  front;
+    int  back;
+    bool lock;
+    bool exit;
+
+    int thread_count;
+#if !defined(JOBS_NO_THREADS)
+#if defined(_WIN32)
+    void* semaphore;
+    void* threads[JOBS_MAX_THREADS];
+#else
+    sem_t     semaphore;
+    pthread_t threads[JOBS_MAX_THREADS];
+#endif
+#endif
+} job_queue;
+
+static void queue_lock() {
+    while( __atomic_test_and_set( &job_queue.lock, __ATOMIC_ACQUIRE ) ) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+static void queue_unlock() {
+    __atomic_clear( &job_queue.lock, __ATOMIC_RELEASE );
+}
+static bool queue_pop( Job* out_job ) {
+    queue_lock();
+    if( job_queue.front == job_queue.back ) {
+        queue_unlock();
+        return false;
+    }
+    *out_job = job_queue.ring[job_queue.front];
+    job_queue.front = (job_queue.front + 1) % JOBS_QUEUE_SIZE;
+    queue_unlock();
+    return true;
+}
+// NOTE(alicia): takes oldest job tracked by counter,
+// jobs queued in front of it are shifted back one slot.
+static bool queue_pop_counter( JobCounter* counter, Job* out_job ) {
+    queue_lock();
+    for( int i = job_queue.front; i != job_queue.back; i = (i + 1) % JOBS_QUEUE_SIZE ) {
+        if( job_queue.ring[i].counter != counter ) {
+            continue;
+        }
+        *out_job = job_queue.ring[i];
+        while( i != job_queue.front ) {
+            int prev = (i + JOBS_QUEUE_SIZE - 1) % JOBS_QUEUE_SIZE;
+            job_queue.ring[i] = job_queue.ring[prev];
+            i = prev;
+        }
+        job_queue.front = (job_queue.front + 1) % JOBS_QUEUE_SIZE;
+        queue_unlock();
+        return true;
+    }
+    queue_unlock();
+    return false;
+}
+static void job_run( Job* job ) {
+    job->fn( job->params );
+    __atomic_sub_fetch( &job->counter->pending, 1, __ATOMIC_RELEASE );
+}
+static void thread_yield() {
+#if defined(JOBS_NO_THREADS)
+#elif defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+#if !defined(JOBS_NO_THREADS)
+static void semaphore_wait() {
+#if defined(_WIN32)
+    WaitForSingleObject( job_queue.semaphore, _INFINITE );
+#else
+    while( sem_wait( &job_queue.semaphore ) != 0 ) {}
+#endif
+}
+static void semaphore_signal( int count ) {
+#if defined(_WIN32)
+    ReleaseSemaphore( job_queue.semaphore, count, 0 );
+#else
+    for( int i = 0; i < count; ++i ) {
+        sem_post( &job_queue.semaphore );
+    }
+#endif
+}
+
+#if defined(_WIN32)
+static unsigned long __stdcall worker_proc( void* ) {
+#else
+static void* worker_proc( void* ) {
+#endif
+    for( ;; ) {
+        semaphore_wait();
+        if( __atomic_load_n( &job_queue.exit, __ATOMIC_ACQUIRE ) ) {
+            break;
+        }
+
+        Job job;
+        while( queue_pop( &job ) ) {
+            job_run( &job );
+        }
+    }
+    return 0;
+}
+#endif
+
+bool jobs_init() {
+#if defined(JOBS_NO_THREADS)
+    job_queue.thread_count = 0;
+    return true;
+#else
+    int cpu_count;
+#if defined(_WIN32)
+    cpu_count = (int)GetActiveProcessorCount( _ALL_PROCESSOR_GROUPS );
+    job_queue.semaphore = CreateSemaphoreA( 0, 0, JOBS_QUEUE_SIZE * 2, 0 );
+    if( !job_queue.semaphore ) {
+        return false;
+    }
+#else
+    cpu_count = (int)sysconf( _SC_NPROCESSORS_ONLN );
+    if( sem_init( &job_queue.semaphore, 0, 0 ) != 0 ) {
+        return false;
+    }
+#endif
+    // NOTE(alicia): main thread also runs jobs while waiting.
+    int count = cpu_count - 1;
+    if( count < 1 ) {
+        count = 1;
+    }
+    if( count > JOBS_MAX_THREADS ) {
+        count = JOBS_MAX_THREADS;
+    }
+
+    for( int i = 0; i < count; ++i ) {
+#if defined(_WIN32)
+        job_queue.threads[i] = CreateThread( 0, 0, worker_proc, 0, 0, 0 );
+        if( !job_queue.threads[i] ) {
+            break;
+        }
+#else
+        if( pthread_create( job_queue.threads + i, 0, worker_proc, 0 ) != 0 ) {
+            break;
+        }
+#endif
+        job_queue.thread_count++;
+    }
+
+    return job_queue.thread_count > 0;
+#endif
+}
+void jobs_shutdown() {
+#if !defined(JOBS_NO_THREADS)
+    __atomic_store_n( &job_queue.exit, true, __ATOMIC_RELEASE );
+    semaphore_signal( job_queue.thread_count );
+
+    for( int i = 0; i < job_queue.thread_count; ++i ) {
+#if defined(_WIN32)
+        WaitForSingleObject( job_queue.threads[i], _INFINITE );
+        CloseHandle( job_queue.threads[i] );
+#else
+        pthread_join( job_queue.threads[i], 0 );
+#endif
+    }
+
+#if defined(_WIN32)
+    CloseHandle( job_queue.semaphore );
+#else
+    sem_destroy( &job_queue.semaphore );
+#endif
+    job_queue.thread_count = 0;
+#endif
+}
+int jobs_thread_count() {
+    return job_queue.thread_count;
+}
+
+void jobs_submit( JobCounter* counter, JobFn* fn, void* params ) {
+    Job job;
+    job.fn      = fn;
+    job.params  = params;
+    job.counter = counter;
+
+    __atomic_add_fetch( &counter->pending, 1, __ATOMIC_RELAXED );
+
+#if defined(JOBS_NO_THREADS)
+    job_run( &job );
+#else
+    if( !job_queue.thread_count ) {
+        job_run( &job );
+        return;
+    }
+
+    queue_lock();
+    int next = (job_queue.back + 1) % JOBS_QUEUE_SIZE;
+    if( next == job_queue.front ) {
+        queue_unlock();
+        job_run( &job );
+        return;
+    }
+    job_queue.ring[job_queue.back] = job;
+    job_queue.back = next;
+    queue_unlock();
+
+    semaphore_signal( 1 );
+#endif
+}
+bool jobs_done( JobCounter* counter ) {
+    return __atomic_load_n( &counter->pending, __ATOMIC_ACQUIRE ) == 0;
+}
+void jobs_wait( JobCounter* counter ) {
+    while( !jobs_done( counter ) ) {
+        // NOTE(alicia): only help with jobs tracked by counter,
+        // running anything else (like a simulation or map decode)
+        // would stall the waiting thread for unrelated work.
+        Job job;
+        if( queue_pop_counter( counter, &job ) ) {
+            job_run( &job );
+        } else {
+            thread_yield();
+        }
+    }
+}
+
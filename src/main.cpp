@@ -80,6 +80,14 @@ int main( int argc, char** argv ) {
 
 #endif
 
+    // NOTE(alicia): mode unload waits on background map decode
+    // and unloads music streamed from pack, both read from pack
+    // so they have to finish before assets are shut down.
+    mode_unload( global_state, global_state->mode );
+    // NOTE(alicia): jobs still queued run on this thread when waited on.
+    jobs_shutdown();
+    anim_bake_free( &global_state->persistent.anim_bake );
+    assets_shutdown( &global_state->persistent.assets );
     CloseAudioDevice();
     CloseWindow();
     return 0;
@@ -93,6 +101,17 @@ int main( int argc, char** argv ) {
 #include "audio.cpp"
 #include "globals.cpp"
 #include "shaders.cpp"
+#include "jobs.cpp"
+#include "assets.cpp"
+#include "skinning.cpp"
+#include "mapped_file.cpp"
+#include "wall_batch.cpp"
+#include "floor_mesh.cpp"
+#include "cull.cpp"
+#include "pvs.cpp"
+#include "render_queue.cpp"
+#include "hud.cpp"
+#include "dynamic_resolution.cpp"
 
 // Thank you GCC
 #pragma GCC diagnostic push
@@ -8,16 +8,26 @@
 #include "state.h"
 #include "blit.h"
 #include "globals.h"
+#include "jobs.h"
 
 void mode_main_menu_load( GlobalState* state ) {
     if( !IsTextureValid( state->persistent.tex_main_menu ) ) {
-        state->persistent.tex_main_menu = LoadTexture( "resources/textures/logo.png" );
+        state->persistent.tex_main_menu = assets_load_texture(
+            &state->persistent.assets, "resources/textures/logo.png" );
         SetTextureFilter(
             state->persistent.tex_main_menu, TEXTURE_FILTER_BILINEAR );
     }
     state->transient.main_menu.music =
-        LoadMusicStream( "resources/audio/music/music_main_menu.wav" );
+        assets_load_music(
+            &state->persistent.assets, "resources/audio/music/music_main_menu.wav" );
     PlayMusicStream( state->transient.main_menu.music );
+
+    // NOTE(alicia): without worker threads this would
+    // just move the load hitch to the main menu.
+    if( jobs_thread_count() ) {
+        mode_game_prefetch( state, &state->transient.main_menu.prefetch );
+        state->transient.main_menu.is_prefetching = true;
+    }
 }
 void mode_main_menu_update( GlobalState* state, float dt ) {
     BeginDrawing();
@@ -58,6 +68,7 @@ void mode_main_menu_update( GlobalState* state, float dt ) {
         float spacing = button_rect.height + 6.0;
 
         if( GuiButton( button_rect, "Start Game" ) ) {
+            state->transient.main_menu.is_starting_game = true;
             mode_set( state, Mode::GAME );
             EndDrawing();
             return;
@@ -103,5 +114,11 @@ void mode_main_menu_update( GlobalState* state, float dt ) {
 }
 void mode_main_menu_unload( GlobalState* state ) {
     UnloadMusicStream( state->transient.main_menu.music );
+
+    if( state->transient.main_menu.is_prefetching ) {
+        mode_game_prefetch_release(
+            state, &state->transient.main_menu.prefetch,
+            state->transient.main_menu.is_starting_game );
+    }
 }
 
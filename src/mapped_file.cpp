@@ -0,0 +1,146 @@
+/**
+ * @file   mapped_file.cpp
+ * @brief  Read-only memory mapped files.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 07, 2025
+*/
+#include "mapped_file.h"
+
+#if defined(PLATFORM_WEB)
+    #include <stdio.h>
+    #include <stdlib.h>
+#elif defined(_WIN32)
+    // NOTE(alicia): windows.h clashes with raylib so
+    // only declare what is needed.
+    extern "C" {
+        __declspec(dllimport) void* __stdcall CreateFileA(
+            const char*, unsigned long, unsigned long, void*,
+            unsigned long, unsigned long, void* );
+        __declspec(dllimport) int __stdcall GetFileSizeEx( void*, long long* );
+        __declspec(dllimport) void* __stdcall CreateFileMappingA(
+            void*, void*, unsigned long, unsigned long, unsigned long, const char* );
+        __declspec(dllimport) void* __stdcall MapViewOfFile(
+            void*, unsigned long, unsigned long, unsigned long, unsigned long long );
+        __declspec(dllimport) int __stdcall UnmapViewOfFile( const void* );
+        __declspec(dllimport) int __stdcall CloseHandle( void* );
+    }
+    #define _GENERIC_READ           (0x80000000)
+    #define _FILE_SHARE_READ        (0x00000001)
+    #define _OPEN_EXISTING          (3)
+    #define _FILE_ATTRIBUTE_NORMAL  (0x00000080)
+    #define _PAGE_READONLY          (0x02)
+    #define _FILE_MAP_READ          (0x0004)
+    #define _INVALID_HANDLE_VALUE   ((void*)(long long)-1)
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+bool mapped_file_open( const char* path, MappedFile* out_file ) {
+    *out_file = {};
+
+#if defined(PLATFORM_WEB)
+    FILE* file = fopen( path, "rb" );
+    if( !file ) {
+        return false;
+    }
+    fseek( file, 0, SEEK_END );
+    long size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+    if( size <= 0 ) {
+        fclose( file );
+        return false;
+    }
+
+    void* data = malloc( size );
+    if( fread( data, 1, size, file ) != (size_t)size ) {
+        free( data );
+        fclose( file );
+        return false;
+    }
+    fclose( file );
+
+    out_file->data = data;
+    out_file->size = size;
+    return true;
+#elif defined(_WIN32)
+    void* file = CreateFileA(
+        path, _GENERIC_READ, _FILE_SHARE_READ, nullptr,
+        _OPEN_EXISTING, _FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( file == _INVALID_HANDLE_VALUE ) {
+        return false;
+    }
+
+    long long size = 0;
+    if( !GetFileSizeEx( file, &size ) || size <= 0 ) {
+        CloseHandle( file );
+        return false;
+    }
+
+    void* mapping = CreateFileMappingA( file, nullptr, _PAGE_READONLY, 0, 0, nullptr );
+    if( !mapping ) {
+        CloseHandle( file );
+        return false;
+    }
+
+    void* data = MapViewOfFile( mapping, _FILE_MAP_READ, 0, 0, 0 );
+    if( !data ) {
+        CloseHandle( mapping );
+        CloseHandle( file );
+        return false;
+    }
+
+    out_file->data      = data;
+    out_file->size      = (size_t)size;
+    out_file->is_mapped = true;
+    out_file->file      = file;
+    out_file->mapping   = mapping;
+    return true;
+#else
+    int fd = open( path, O_RDONLY );
+    if( fd < 0 ) {
+        return false;
+    }
+
+    struct stat st;
+    if( fstat( fd, &st ) != 0 || st.st_size <= 0 ) {
+        close( fd );
+        return false;
+    }
+
+    void* data = mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    // NOTE(alicia): mapping keeps its own reference to file.
+    close( fd );
+    if( data == MAP_FAILED ) {
+        return false;
+    }
+    // NOTE(alicia): whole file is read during validation anyway.
+    madvise( data, st.st_size, MADV_WILLNEED );
+
+    out_file->data      = data;
+    out_file->size      = st.st_size;
+    out_file->is_mapped = true;
+    return true;
+#endif
+}
+void mapped_file_close( MappedFile* file ) {
+    if( !file->data || file->is_view ) {
+        *file = {};
+        return;
+    }
+
+#if defined(PLATFORM_WEB)
+    free( file->data );
+#elif defined(_WIN32)
+    UnmapViewOfFile( file->data );
+    CloseHandle( file->mapping );
+    CloseHandle( file->file );
+#else
+    munmap( file->data, file->size );
+#endif
+
+    *file = {};
+}
+
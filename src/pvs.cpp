@@ -0,0 +1,829 @@
+/**
+ * @file   pvs.cpp
+ * @brief  Cell and portal visibility built from map segments.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "pvs.h"
+#include "raymath.h"
+#include "shared/buffer.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PVS_TAU (2.0f * PI)
+// NOTE(alicia): cone has to widen by this much to revisit a cell.
+#define PVS_CONE_EPSILON (0.0001f)
+
+struct PvsBuildSegment {
+    Vector2 start;
+    Vector2 end;
+    int     segment;
+};
+/// @brief Convex polygon vertex, tag belongs to edge from this vertex to next.
+/// Tag is -1 for root bounds or (node << 1) | side for splitter edges.
+struct PvsBuildVertex {
+    Vector2 position;
+    int     tag;
+};
+struct PvsBuildPolygon {
+    PvsBuildVertex* buf;
+    int             len;
+};
+/// @brief Wall lying on a node's splitter.
+struct PvsBuildWall {
+    int   node;
+    float t0, t1;
+    int   segment;
+};
+/// @brief Part of a cell's boundary lying on a node's splitter.
+struct PvsBuildEdge {
+    int   node;
+    int   side;
+    float t0, t1;
+    int   leaf;
+};
+struct PvsBuildPair {
+    int leaf;
+    int value;
+};
+
+struct PvsBuilder {
+    Pvs* pvs;
+    struct {
+        PvsBuildWall* buf;
+        int           len;
+        int           cap;
+    } walls;
+    struct {
+        PvsBuildEdge* buf;
+        int           len;
+        int           cap;
+    } edges;
+    struct {
+        PvsBuildPair* buf;
+        int           len;
+        int           cap;
+    } portal_pairs;
+    struct {
+        PvsPortal* buf;
+        int        len;
+        int        cap;
+    } portals;
+    struct {
+        PvsBuildPair* buf;
+        int           len;
+        int           cap;
+    } chunk_pairs;
+};
+
+static float pvs_side( Vector2 normal, float dist, Vector2 point ) {
+    return Vector2DotProduct( normal, point ) - dist;
+}
+static int pvs_classify( float side ) {
+    if( side > PVS_EPSILON ) {
+        return 1;
+    }
+    if( side < -PVS_EPSILON ) {
+        return -1;
+    }
+    return 0;
+}
+/// @brief Direction along node's splitter, parameter t is dot( direction, p ).
+static Vector2 pvs_node_direction( const PvsNode* node ) {
+    return Vector2{ node->normal.y, -node->normal.x };
+}
+static Vector2 pvs_node_point( const PvsNode* node, float t ) {
+    return (node->normal * node->dist) + (pvs_node_direction( node ) * t);
+}
+
+static int pvs_make_leaf( PvsBuilder* b, const PvsBuildPolygon* polygon ) {
+    Pvs* pvs  = b->pvs;
+    int  leaf = pvs->leaves.len;
+    buf_append( &pvs->leaves, PvsLeaf{} );
+
+    for( int i = 0; i < polygon->len; ++i ) {
+        const PvsBuildVertex* v = polygon->buf + i;
+        if( v->tag < 0 ) {
+            continue;
+        }
+        const PvsBuildVertex* next = polygon->buf + ((i + 1) % polygon->len);
+
+        PvsBuildEdge edge;
+        edge.node = v->tag >> 1;
+        edge.side = v->tag & 1;
+        edge.leaf = leaf;
+
+        Vector2 direction = pvs_node_direction( pvs->nodes.buf + edge.node );
+        float t0 = Vector2DotProduct( direction, v->position );
+        float t1 = Vector2DotProduct( direction, next->position );
+        edge.t0 = fminf( t0, t1 );
+        edge.t1 = fmaxf( t0, t1 );
+        if( (edge.t1 - edge.t0) > PVS_EPSILON ) {
+            buf_append( &b->edges, edge );
+        }
+    }
+    return ~leaf;
+}
+
+static void pvs_clip_polygon(
+    const PvsBuildPolygon* polygon, Vector2 normal, float dist, int node,
+    PvsBuildPolygon* out_front, PvsBuildPolygon* out_back
+) {
+    out_front->len = 0;
+    out_back->len  = 0;
+
+    bool has_front = false, has_back = false;
+    for( int i = 0; i < polygon->len; ++i ) {
+        int side = pvs_classify( pvs_side( normal, dist, polygon->buf[i].position ) );
+        has_front |= side > 0;
+        has_back  |= side < 0;
+    }
+
+    // NOTE(alicia): convex polygon touching splitter
+    // is entirely on one side of it.
+    if( !has_back ) {
+        memcpy( out_front->buf, polygon->buf, sizeof(PvsBuildVertex) * polygon->len );
+        out_front->len = polygon->len;
+        return;
+    }
+    if( !has_front ) {
+        memcpy( out_back->buf, polygon->buf, sizeof(PvsBuildVertex) * polygon->len );
+        out_back->len = polygon->len;
+        return;
+    }
+
+    int front_tag = (node << 1) | 0;
+    int back_tag  = (node << 1) | 1;
+    for( int i = 0; i < polygon->len; ++i ) {
+        PvsBuildVertex p = polygon->buf[i];
+        PvsBuildVertex q = polygon->buf[(i + 1) % polygon->len];
+
+        float dp = pvs_side( normal, dist, p.position );
+        float dq = pvs_side( normal, dist, q.position );
+        int   sp = pvs_classify( dp );
+        int   sq = pvs_classify( dq );
+
+        switch( sp ) {
+            case 1: {
+                out_front->buf[out_front->len++] = p;
+            } break;
+            case -1: {
+                out_back->buf[out_back->len++] = p;
+            } break;
+            case 0: {
+                out_front->buf[out_front->len++] =
+                    PvsBuildVertex{ p.position, sq > 0 ? p.tag : front_tag };
+                out_back->buf[out_back->len++] =
+                    PvsBuildVertex{ p.position, sq < 0 ? p.tag : back_tag };
+            } break;
+        }
+
+        if( (sp * sq) < 0 ) {
+            Vector2 point = Vector2Lerp( p.position, q.position, dp / (dp - dq) );
+            if( sp > 0 ) {
+                out_front->buf[out_front->len++] = PvsBuildVertex{ point, front_tag };
+                out_back->buf[out_back->len++]   = PvsBuildVertex{ point, p.tag };
+            } else {
+                out_back->buf[out_back->len++]   = PvsBuildVertex{ point, back_tag };
+                out_front->buf[out_front->len++] = PvsBuildVertex{ point, p.tag };
+            }
+        }
+    }
+}
+
+static int pvs_choose_splitter( const PvsBuildSegment* segments, int count ) {
+    int  step       = count > PVS_SPLIT_CANDIDATES ? count / PVS_SPLIT_CANDIDATES : 1;
+    int  best       = 0;
+    long best_score = -1;
+    for( int c = 0; c < count; c += step ) {
+        Vector2 direction = Vector2Normalize( segments[c].end - segments[c].start );
+        Vector2 normal    = { -direction.y, direction.x };
+        float   dist      = Vector2DotProduct( normal, segments[c].start );
+
+        long front = 0, back = 0, splits = 0;
+        for( int i = 0; i < count; ++i ) {
+            int sa = pvs_classify( pvs_side( normal, dist, segments[i].start ) );
+            int sb = pvs_classify( pvs_side( normal, dist, segments[i].end ) );
+            if( (sa * sb) < 0 ) {
+                splits++;
+            } else if( sa > 0 || sb > 0 ) {
+                front++;
+            } else if( sa < 0 || sb < 0 ) {
+                back++;
+            }
+        }
+
+        // NOTE(alicia): splits make more cells and portals,
+        // imbalance makes a deeper tree.
+        long score = (splits * 4) + labs( front - back );
+        if( best_score < 0 || score < best_score ) {
+            best       = c;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+static int pvs_build_node(
+    PvsBuilder* b, const PvsBuildSegment* segments, int count,
+    const PvsBuildPolygon* polygon
+) {
+    if( !count || polygon->len < 3 ) {
+        return pvs_make_leaf( b, polygon );
+    }
+
+    Pvs* pvs = b->pvs;
+
+    const PvsBuildSegment* splitter = segments + pvs_choose_splitter( segments, count );
+
+    PvsNode node = {};
+    Vector2 direction = Vector2Normalize( splitter->end - splitter->start );
+    node.normal = Vector2{ -direction.y, direction.x };
+    node.dist   = Vector2DotProduct( node.normal, splitter->start );
+
+    int node_index = pvs->nodes.len;
+    buf_append( &pvs->nodes, node );
+
+    // NOTE(alicia): every segment is split at most once so
+    // neither side can have more than count segments.
+    PvsBuildSegment* front = (PvsBuildSegment*)malloc( sizeof(PvsBuildSegment) * count * 2 );
+    PvsBuildSegment* back  = front + count;
+    int front_count = 0, back_count = 0;
+
+    for( int i = 0; i < count; ++i ) {
+        const PvsBuildSegment* seg = segments + i;
+
+        float da = pvs_side( node.normal, node.dist, seg->start );
+        float db = pvs_side( node.normal, node.dist, seg->end );
+        int   sa = pvs_classify( da );
+        int   sb = pvs_classify( db );
+
+        if( !sa && !sb ) {
+            PvsBuildWall wall;
+            wall.node    = node_index;
+            wall.t0      = Vector2DotProduct( direction, seg->start );
+            wall.t1      = Vector2DotProduct( direction, seg->end );
+            wall.segment = seg->segment;
+            if( wall.t0 > wall.t1 ) {
+                float temp = wall.t0;
+                wall.t0    = wall.t1;
+                wall.t1    = temp;
+            }
+            buf_append( &b->walls, wall );
+        } else if( (sa * sb) < 0 ) {
+            Vector2 point = Vector2Lerp( seg->start, seg->end, da / (da - db) );
+
+            PvsBuildSegment a = *seg, c = *seg;
+            a.end   = point;
+            c.start = point;
+            if( sa > 0 ) {
+                front[front_count++] = a;
+                back[back_count++]   = c;
+            } else {
+                back[back_count++]   = a;
+                front[front_count++] = c;
+            }
+        } else if( sa > 0 || sb > 0 ) {
+            front[front_count++] = *seg;
+        } else {
+            back[back_count++] = *seg;
+        }
+    }
+
+    // NOTE(alicia): clipping a convex polygon adds at most two vertexes,
+    // sized for every edge crossing in case rounding makes it not quite convex.
+    int polygon_cap = (polygon->len * 2) + 2;
+    PvsBuildPolygon front_polygon, back_polygon;
+    front_polygon.buf = (PvsBuildVertex*)malloc( sizeof(PvsBuildVertex) * polygon_cap * 2 );
+    back_polygon.buf  = front_polygon.buf + polygon_cap;
+    pvs_clip_polygon(
+        polygon, node.normal, node.dist, node_index, &front_polygon, &back_polygon );
+
+    int front_child = pvs_build_node( b, front, front_count, &front_polygon );
+    int back_child  = pvs_build_node( b, back, back_count, &back_polygon );
+
+    free( front_polygon.buf );
+    free( front );
+
+    pvs->nodes.buf[node_index].front = front_child;
+    pvs->nodes.buf[node_index].back  = back_child;
+    return node_index;
+}
+
+static int pvs_wall_cmp( const void* a, const void* b ) {
+    auto* lhs = (const PvsBuildWall*)a;
+    auto* rhs = (const PvsBuildWall*)b;
+    if( lhs->node != rhs->node ) {
+        return lhs->node - rhs->node;
+    }
+    if( lhs->t0 != rhs->t0 ) {
+        return lhs->t0 < rhs->t0 ? -1 : 1;
+    }
+    return 0;
+}
+static int pvs_edge_cmp( const void* a, const void* b ) {
+    auto* lhs = (const PvsBuildEdge*)a;
+    auto* rhs = (const PvsBuildEdge*)b;
+    if( lhs->node != rhs->node ) {
+        return lhs->node - rhs->node;
+    }
+    if( lhs->side != rhs->side ) {
+        return lhs->side - rhs->side;
+    }
+    if( lhs->t0 != rhs->t0 ) {
+        return lhs->t0 < rhs->t0 ? -1 : 1;
+    }
+    return 0;
+}
+static int pvs_pair_cmp( const void* a, const void* b ) {
+    auto* lhs = (const PvsBuildPair*)a;
+    auto* rhs = (const PvsBuildPair*)b;
+    if( lhs->leaf != rhs->leaf ) {
+        return lhs->leaf - rhs->leaf;
+    }
+    return lhs->value - rhs->value;
+}
+
+static void pvs_add_portal( PvsBuilder* b, int node, float t0, float t1, int from, int to ) {
+    if( (t1 - t0) < PVS_MIN_PORTAL_WIDTH ) {
+        return;
+    }
+    const PvsNode* n = b->pvs->nodes.buf + node;
+
+    PvsPortal portal;
+    portal.start = pvs_node_point( n, t0 );
+    portal.end   = pvs_node_point( n, t1 );
+
+    // NOTE(alicia): portal pairs hold index into portals
+    // so that portals can be sorted by cell they leave from.
+    portal.leaf = to;
+    buf_append( &b->portal_pairs, (PvsBuildPair{ from, b->portals.len }) );
+    buf_append( &b->portals, portal );
+
+    portal.leaf = from;
+    buf_append( &b->portal_pairs, (PvsBuildPair{ to, b->portals.len }) );
+    buf_append( &b->portals, portal );
+}
+/// @brief Add portals for parts of [t0, t1] that aren't covered by walls.
+static void pvs_add_open_portals(
+    PvsBuilder* b, int node, float t0, float t1, int from, int to,
+    const PvsBuildWall* walls, int wall_count
+) {
+    float cursor = t0;
+    for( int i = 0; i < wall_count; ++i ) {
+        const PvsBuildWall* wall = walls + i;
+        if( wall->t1 <= cursor ) {
+            continue;
+        }
+        if( wall->t0 >= t1 ) {
+            break;
+        }
+        if( wall->t0 > cursor ) {
+            pvs_add_portal( b, node, cursor, wall->t0, from, to );
+        }
+        cursor = wall->t1;
+        if( cursor >= t1 ) {
+            return;
+        }
+    }
+    pvs_add_portal( b, node, cursor, t1, from, to );
+}
+
+void pvs_build(
+    Pvs* pvs, const Vector2* vertexes,
+    const MapFileSegment* segments, int segment_count,
+    const int* segment_chunk, int chunk_count
+) {
+    pvs->root            = ~0;
+    pvs->nodes.len       = 0;
+    pvs->leaves.len      = 0;
+    pvs->portals.len     = 0;
+    pvs->leaf_chunks.len = 0;
+    pvs->chunk_count     = chunk_count;
+
+    PvsBuilder builder = {};
+    builder.pvs = pvs;
+
+    PvsBuildSegment* build_segments =
+        (PvsBuildSegment*)malloc( sizeof(PvsBuildSegment) * (segment_count ? segment_count : 1) );
+    int build_segment_count = 0;
+
+    Vector2 min = { FLT_MAX, FLT_MAX };
+    Vector2 max = { -FLT_MAX, -FLT_MAX };
+    for( int i = 0; i < segment_count; ++i ) {
+        Vector2 start = vertexes[segments[i].start];
+        Vector2 end   = vertexes[segments[i].end];
+        min = Vector2Min( min, Vector2Min( start, end ) );
+        max = Vector2Max( max, Vector2Max( start, end ) );
+
+        // NOTE(alicia): zero length wall has no splitter.
+        if( Vector2Distance( start, end ) <= PVS_EPSILON ) {
+            continue;
+        }
+        build_segments[build_segment_count++] = PvsBuildSegment{ start, end, i };
+    }
+    if( !build_segment_count ) {
+        min = max = Vector2{};
+    }
+    min -= Vector2{ PVS_BOUNDS_PADDING, PVS_BOUNDS_PADDING };
+    max += Vector2{ PVS_BOUNDS_PADDING, PVS_BOUNDS_PADDING };
+
+    PvsBuildVertex root_vertexes[4] = {
+        { { min.x, min.y }, -1 },
+        { { max.x, min.y }, -1 },
+        { { max.x, max.y }, -1 },
+        { { min.x, max.y }, -1 },
+    };
+    PvsBuildPolygon root = { root_vertexes, 4 };
+
+    pvs->root = pvs_build_node( &builder, build_segments, build_segment_count, &root );
+    free( build_segments );
+
+    qsort( builder.walls.buf, builder.walls.len, sizeof(PvsBuildWall), pvs_wall_cmp );
+    qsort( builder.edges.buf, builder.edges.len, sizeof(PvsBuildEdge), pvs_edge_cmp );
+
+    // NOTE(alicia): walk cell edges one splitter at a time.
+    // Cells on the same side of a splitter don't overlap so front and back
+    // edges can be swept like two sorted lists of intervals.
+    int wall_cursor = 0;
+    int edge_cursor = 0;
+    while( edge_cursor < builder.edges.len ) {
+        int node = builder.edges.buf[edge_cursor].node;
+
+        int edge_first = edge_cursor;
+        while( edge_cursor < builder.edges.len && builder.edges.buf[edge_cursor].node == node ) {
+            edge_cursor++;
+        }
+        int back_first = edge_first;
+        while( back_first < edge_cursor && builder.edges.buf[back_first].side == 0 ) {
+            back_first++;
+        }
+
+        while( wall_cursor < builder.walls.len && builder.walls.buf[wall_cursor].node < node ) {
+            wall_cursor++;
+        }
+        int wall_first = wall_cursor;
+        int wall_last  = wall_cursor;
+        while( wall_last < builder.walls.len && builder.walls.buf[wall_last].node == node ) {
+            wall_last++;
+        }
+        const PvsBuildWall* walls = builder.walls.buf + wall_first;
+        int wall_count = wall_last - wall_first;
+
+        const PvsBuildEdge* front = builder.edges.buf + edge_first;
+        const PvsBuildEdge* back  = builder.edges.buf + back_first;
+        int front_count = back_first - edge_first;
+        int back_count  = edge_cursor - back_first;
+
+        int i = 0, j = 0;
+        while( i < front_count && j < back_count ) {
+            float t0 = fmaxf( front[i].t0, back[j].t0 );
+            float t1 = fminf( front[i].t1, back[j].t1 );
+            if( t1 > t0 ) {
+                pvs_add_open_portals(
+                    &builder, node, t0, t1, front[i].leaf, back[j].leaf, walls, wall_count );
+            }
+            if( front[i].t1 < back[j].t1 ) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+
+        // NOTE(alicia): cells on either side of a wall can see it.
+        for( int e = edge_first; e < edge_cursor; ++e ) {
+            const PvsBuildEdge* edge = builder.edges.buf + e;
+            for( int w = 0; w < wall_count; ++w ) {
+                if( walls[w].t0 >= edge->t1 ) {
+                    break;
+                }
+                if( (fminf( walls[w].t1, edge->t1 ) - fmaxf( walls[w].t0, edge->t0 )) <= PVS_EPSILON ) {
+                    continue;
+                }
+                int chunk = segment_chunk ? segment_chunk[walls[w].segment] : -1;
+                if( chunk >= 0 ) {
+                    buf_append( &builder.chunk_pairs, (PvsBuildPair{ edge->leaf, chunk }) );
+                }
+            }
+        }
+    }
+
+    // NOTE(alicia): group portals and chunks by cell.
+    qsort(
+        builder.portal_pairs.buf, builder.portal_pairs.len,
+        sizeof(PvsBuildPair), pvs_pair_cmp );
+    for( int i = 0; i < builder.portal_pairs.len; ++i ) {
+        const PvsBuildPair* pair = builder.portal_pairs.buf + i;
+        PvsLeaf* leaf = pvs->leaves.buf + pair->leaf;
+        if( !leaf->portal_count ) {
+            leaf->first_portal = pvs->portals.len;
+        }
+        leaf->portal_count++;
+        buf_append( &pvs->portals, builder.portals.buf[pair->value] );
+    }
+
+    qsort(
+        builder.chunk_pairs.buf, builder.chunk_pairs.len,
+        sizeof(PvsBuildPair), pvs_pair_cmp );
+    for( int i = 0; i < builder.chunk_pairs.len; ++i ) {
+        const PvsBuildPair* pair = builder.chunk_pairs.buf + i;
+        if(
+            i &&
+            pair->leaf  == builder.chunk_pairs.buf[i - 1].leaf &&
+            pair->value == builder.chunk_pairs.buf[i - 1].value
+        ) {
+            continue;
+        }
+        PvsLeaf* leaf = pvs->leaves.buf + pair->leaf;
+        if( !leaf->chunk_count ) {
+            leaf->first_chunk = pvs->leaf_chunks.len;
+        }
+        leaf->chunk_count++;
+        buf_append( &pvs->leaf_chunks, pair->value );
+    }
+
+    // NOTE(alicia): chunk that no cell claimed is always drawn
+    // rather than never drawn.
+    pvs->orphan_chunks.len = 0;
+    uint8_t* claimed = (uint8_t*)calloc( chunk_count ? chunk_count : 1, 1 );
+    for( int i = 0; i < pvs->leaf_chunks.len; ++i ) {
+        claimed[pvs->leaf_chunks.buf[i]] = 1;
+    }
+    for( int i = 0; i < chunk_count; ++i ) {
+        if( !claimed[i] ) {
+            buf_append( &pvs->orphan_chunks, i );
+        }
+    }
+    free( claimed );
+
+    free( builder.walls.buf );
+    free( builder.edges.buf );
+    free( builder.portal_pairs.buf );
+    free( builder.portals.buf );
+    free( builder.chunk_pairs.buf );
+
+    int leaf_count = pvs->leaves.len;
+    if( pvs->state_cap < leaf_count ) {
+        pvs->leaf_stamps = (uint32_t*)realloc( pvs->leaf_stamps, sizeof(uint32_t) * leaf_count );
+        pvs->leaf_cones  = (PvsCone*)realloc( pvs->leaf_cones, sizeof(PvsCone) * leaf_count );
+        pvs->leaf_queued = (uint8_t*)realloc( pvs->leaf_queued, leaf_count );
+        pvs->queue       = (int*)realloc( pvs->queue, sizeof(int) * leaf_count );
+        pvs->state_cap   = leaf_count;
+    }
+    if( pvs->state_chunk_cap < chunk_count ) {
+        pvs->chunk_stamps    = (uint32_t*)realloc( pvs->chunk_stamps, sizeof(uint32_t) * chunk_count );
+        pvs->state_chunk_cap = chunk_count;
+    }
+    memset( pvs->leaf_stamps, 0, sizeof(uint32_t) * pvs->state_cap );
+    memset( pvs->leaf_queued, 0, pvs->state_cap );
+    if( pvs->chunk_stamps ) {
+        memset( pvs->chunk_stamps, 0, sizeof(uint32_t) * pvs->state_chunk_cap );
+    }
+    pvs->stamp              = 0;
+    pvs->camera_leaf        = 0;
+    pvs->visible_leaf_count = leaf_count;
+}
+void pvs_free( Pvs* pvs ) {
+    free( pvs->nodes.buf );
+    free( pvs->leaves.buf );
+    free( pvs->portals.buf );
+    free( pvs->leaf_chunks.buf );
+    free( pvs->orphan_chunks.buf );
+    free( pvs->leaf_stamps );
+    free( pvs->chunk_stamps );
+    free( pvs->leaf_cones );
+    free( pvs->leaf_queued );
+    free( pvs->queue );
+    *pvs = {};
+}
+
+int pvs_locate( const Pvs* pvs, Vector2 point ) {
+    if( !pvs->leaves.len ) {
+        return 0;
+    }
+    int index = pvs->root;
+    while( index >= 0 ) {
+        const PvsNode* node = pvs->nodes.buf + index;
+        index = pvs_side( node->normal, node->dist, point ) >= 0.0f ? node->front : node->back;
+    }
+    return ~index;
+}
+
+static float pvs_wrap( float angle ) {
+    angle = fmodf( angle, PVS_TAU );
+    if( angle < 0.0f ) {
+        angle += PVS_TAU;
+    }
+    return angle;
+}
+static PvsCone pvs_cone_full() {
+    return PvsCone{ 0.0f, PVS_TAU };
+}
+static bool pvs_cone_is_full( PvsCone cone ) {
+    return cone.span >= PVS_TAU;
+}
+/// @brief Intersect cones, result may be wider than the
+/// real intersection when it's made of two pieces.
+static bool pvs_cone_intersect( PvsCone a, PvsCone b, PvsCone* out_cone ) {
+    if( pvs_cone_is_full( a ) ) {
+        *out_cone = b;
+        return true;
+    }
+    if( pvs_cone_is_full( b ) ) {
+        *out_cone = a;
+        return true;
+    }
+
+    // NOTE(alicia): b in a's frame is [offset, offset + b.span],
+    // part past PVS_TAU wraps around to [0, wrapped_end].
+    float offset = pvs_wrap( b.start - a.start );
+    float lo = PVS_TAU, hi = -1.0f;
+    if( offset <= a.span ) {
+        lo = offset;
+        hi = fminf( a.span, offset + b.span );
+    }
+    float wrapped_end = offset + b.span - PVS_TAU;
+    if( wrapped_end >= 0.0f ) {
+        lo = 0.0f;
+        hi = fmaxf( hi, fminf( a.span, wrapped_end ) );
+    }
+    if( hi < lo ) {
+        return false;
+    }
+
+    *out_cone = PvsCone{ pvs_wrap( a.start + lo ), hi - lo };
+    return true;
+}
+/// @brief Smallest cone starting at either cone's start that covers both.
+static PvsCone pvs_cone_union( PvsCone a, PvsCone b ) {
+    if( pvs_cone_is_full( a ) || pvs_cone_is_full( b ) ) {
+        return pvs_cone_full();
+    }
+    float span_a = fmaxf( a.span, pvs_wrap( b.start - a.start ) + b.span );
+    float span_b = fmaxf( b.span, pvs_wrap( a.start - b.start ) + a.span );
+
+    PvsCone result = span_a <= span_b ? PvsCone{ a.start, span_a } : PvsCone{ b.start, span_b };
+    if( result.span >= PVS_TAU ) {
+        return pvs_cone_full();
+    }
+    return result;
+}
+static PvsCone pvs_portal_cone( Vector2 eye, const PvsPortal* portal ) {
+    Vector2 a = portal->start - eye;
+    Vector2 b = portal->end   - eye;
+
+    float length = Vector2Distance( portal->start, portal->end );
+    float cross  = (a.x * b.y) - (a.y * b.x);
+    if( fabsf( cross ) <= (PVS_EYE_EPSILON * length) ) {
+        return pvs_cone_full();
+    }
+
+    float angle_a = atan2f( a.y, a.x );
+    float angle_b = atan2f( b.y, b.x );
+    if( cross > 0.0f ) {
+        return PvsCone{ pvs_wrap( angle_a ), pvs_wrap( angle_b - angle_a ) };
+    } else {
+        return PvsCone{ pvs_wrap( angle_b ), pvs_wrap( angle_a - angle_b ) };
+    }
+}
+static float pvs_portal_distance_sqr( Vector2 eye, const PvsPortal* portal ) {
+    Vector2 direction = portal->end - portal->start;
+    float   length    = Vector2LengthSqr( direction );
+    float   t         = 0.0f;
+    if( length > 0.0f ) {
+        t = Clamp( Vector2DotProduct( eye - portal->start, direction ) / length, 0.0f, 1.0f );
+    }
+    return Vector2DistanceSqr( eye, portal->start + (direction * t) );
+}
+
+static void pvs_mark_all( Pvs* pvs ) {
+    for( int i = 0; i < pvs->leaves.len; ++i ) {
+        pvs->leaf_stamps[i] = pvs->stamp;
+    }
+}
+
+void pvs_update( Pvs* pvs, Vector2 camera, float far ) {
+    int leaf_count = pvs->leaves.len;
+    if( !leaf_count ) {
+        return;
+    }
+
+    pvs->stamp++;
+    if( !pvs->stamp ) {
+        memset( pvs->leaf_stamps, 0, sizeof(uint32_t) * pvs->state_cap );
+        if( pvs->chunk_stamps ) {
+            memset( pvs->chunk_stamps, 0, sizeof(uint32_t) * pvs->state_chunk_cap );
+        }
+        pvs->stamp = 1;
+    }
+    uint32_t stamp = pvs->stamp;
+
+    int head = 0, count = 0;
+
+    int start = pvs->camera_leaf = pvs_locate( pvs, camera );
+    pvs->leaf_stamps[start] = stamp;
+    pvs->leaf_cones[start]  = pvs_cone_full();
+    pvs->leaf_queued[start] = 1;
+    pvs->queue[0]           = start;
+    count = 1;
+
+    float far_sqr = far * far;
+    int   budget  = leaf_count * PVS_MAX_VISITS_PER_LEAF;
+    while( count ) {
+        if( !budget-- ) {
+            pvs_mark_all( pvs );
+            for( int i = 0; i < count; ++i ) {
+                pvs->leaf_queued[pvs->queue[(head + i) % leaf_count]] = 0;
+            }
+            break;
+        }
+
+        int leaf = pvs->queue[head];
+        head = (head + 1) % leaf_count;
+        count--;
+        pvs->leaf_queued[leaf] = 0;
+
+        PvsCone cone = pvs->leaf_cones[leaf];
+
+        const PvsLeaf* l = pvs->leaves.buf + leaf;
+        for( int i = 0; i < l->portal_count; ++i ) {
+            const PvsPortal* portal = pvs->portals.buf + l->first_portal + i;
+            if( pvs_portal_distance_sqr( camera, portal ) > far_sqr ) {
+                continue;
+            }
+
+            PvsCone next;
+            if( !pvs_cone_intersect( cone, pvs_portal_cone( camera, portal ), &next ) ) {
+                continue;
+            }
+
+            int target = portal->leaf;
+            if( pvs->leaf_stamps[target] != stamp ) {
+                pvs->leaf_stamps[target] = stamp;
+                pvs->leaf_cones[target]  = next;
+            } else {
+                PvsCone merged = pvs_cone_union( pvs->leaf_cones[target], next );
+                if( merged.span <= (pvs->leaf_cones[target].span + PVS_CONE_EPSILON) ) {
+                    continue;
+                }
+                pvs->leaf_cones[target] = merged;
+            }
+
+            if( !pvs->leaf_queued[target] ) {
+                pvs->leaf_queued[target] = 1;
+                pvs->queue[(head + count) % leaf_count] = target;
+                count++;
+            }
+        }
+    }
+
+    for( int i = 0; i < pvs->orphan_chunks.len; ++i ) {
+        pvs->chunk_stamps[pvs->orphan_chunks.buf[i]] = stamp;
+    }
+
+    pvs->visible_leaf_count = 0;
+    for( int i = 0; i < leaf_count; ++i ) {
+        if( pvs->leaf_stamps[i] != stamp ) {
+            continue;
+        }
+        pvs->visible_leaf_count++;
+
+        const PvsLeaf* leaf = pvs->leaves.buf + i;
+        for( int c = 0; c < leaf->chunk_count; ++c ) {
+            pvs->chunk_stamps[pvs->leaf_chunks.buf[leaf->first_chunk + c]] = stamp;
+        }
+    }
+}
+
+bool pvs_leaf_visible( const Pvs* pvs, int leaf ) {
+    if( !pvs->stamp || leaf < 0 || leaf >= pvs->leaves.len ) {
+        return true;
+    }
+    return pvs->leaf_stamps[leaf] == pvs->stamp;
+}
+bool pvs_chunk_visible( const Pvs* pvs, int chunk ) {
+    if( !pvs->stamp || chunk < 0 || chunk >= pvs->chunk_count ) {
+        return true;
+    }
+    return pvs->chunk_stamps[chunk] == pvs->stamp;
+}
+bool pvs_box_visible( const Pvs* pvs, Vector2 min, Vector2 max ) {
+    if( !pvs->stamp ) {
+        return true;
+    }
+    Vector2 points[] = {
+        Vector2Lerp( min, max, 0.5f ),
+        { min.x, min.y },
+        { max.x, min.y },
+        { max.x, max.y },
+        { min.x, max.y },
+    };
+    for( int i = 0; i < (int)(sizeof(points) / sizeof(points[0])); ++i ) {
+        if( pvs_leaf_visible( pvs, pvs_locate( pvs, points[i] ) ) ) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file   render_queue.cpp
+ * @brief  Sorted mesh draws with shader uniform tracking.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 11, 2025
+*/
+#include "render_queue.h"
+#include "raymath.h"
+#include "shared/buffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int render_uniform_size( int type ) {
+    switch( type ) {
+        case SHADER_UNIFORM_FLOAT:     return sizeof(float);
+        case SHADER_UNIFORM_VEC2:      return sizeof(float) * 2;
+        case SHADER_UNIFORM_VEC3:      return sizeof(float) * 3;
+        case SHADER_UNIFORM_VEC4:      return sizeof(float) * 4;
+        case SHADER_UNIFORM_INT:       return sizeof(int);
+        case SHADER_UNIFORM_IVEC2:     return sizeof(int) * 2;
+        case SHADER_UNIFORM_IVEC3:     return sizeof(int) * 3;
+        case SHADER_UNIFORM_IVEC4:     return sizeof(int) * 4;
+        case SHADER_UNIFORM_SAMPLER2D: return sizeof(int);
+    }
+    return 0;
+}
+
+static void render_set_uniform(
+    RenderQueue* queue, unsigned int shader_id, Shader shader,
+    int loc, const void* value, int type
+) {
+    int size = render_uniform_size( type );
+    if( loc < 0 || !size ) {
+        return;
+    }
+
+    RenderCachedUniform* cached = nullptr;
+    for( int i = 0; i < queue->uniforms.len; ++i ) {
+        RenderCachedUniform* it = queue->uniforms.buf + i;
+        if( it->shader == shader_id && it->loc == loc ) {
+            cached = it;
+            break;
+        }
+    }
+
+    if( cached ) {
+        if( cached->type == type && !memcmp( cached->data, value, size ) ) {
+            queue->stats.uniforms_skipped++;
+            return;
+        }
+    } else {
+        RenderCachedUniform entry = {};
+        entry.shader = shader_id;
+        entry.loc    = loc;
+        buf_append( &queue->uniforms, entry );
+        cached = queue->uniforms.buf + (queue->uniforms.len - 1);
+    }
+
+    cached->type = type;
+    memcpy( cached->data, value, size );
+
+    SetShaderValue( shader, loc, value, type );
+    queue->stats.uniform_uploads++;
+}
+
+static int render_shader_slot( RenderQueue* queue, unsigned int shader_id ) {
+    for( int i = 0; i < queue->shaders.len; ++i ) {
+        if( queue->shaders.buf[i] == shader_id ) {
+            return i;
+        }
+    }
+    buf_append( &queue->shaders, shader_id );
+    return queue->shaders.len - 1;
+}
+
+static uint64_t render_key( RenderQueue* queue, const Material& material, float depth ) {
+    uint64_t shader  = (uint64_t)render_shader_slot( queue, material.shader.id );
+    uint64_t texture = material.maps ? material.maps[MATERIAL_MAP_DIFFUSE].texture.id : 0;
+
+    // NOTE(alicia): bits of positive float sort like integers,
+    // low bits of mantissa don't matter for front to back order.
+    uint32_t depth_bits;
+    depth = depth > 0.0f ? depth : 0.0f;
+    memcpy( &depth_bits, &depth, sizeof(depth_bits) );
+
+    if( shader >= RENDER_QUEUE_MAX_SHADERS ) {
+        shader = RENDER_QUEUE_MAX_SHADERS - 1;
+    }
+    return
+        (shader << 56)                      |
+        ((texture & 0xFFFF) << 40)          |
+        ((uint64_t)(depth_bits >> 8) << 16) |
+        ((uint64_t)queue->len & 0xFFFF);
+}
+
+static RenderItem* render_queue_push(
+    RenderQueue* queue, const Mesh* mesh, Material material, float depth
+) {
+    RenderItem item = {};
+    item.key       = render_key( queue, material, depth );
+    item.mesh      = mesh;
+    item.material  = material;
+    item.transform = MatrixIdentity();
+    buf_append( queue, item );
+    return queue->buf + (queue->len - 1);
+}
+
+void render_queue_begin( RenderQueue* queue, Vector3 eye ) {
+    queue->len          = 0;
+    queue->uniforms.len = 0;
+    queue->shaders.len  = 0;
+    queue->eye          = eye;
+    queue->stats        = {};
+}
+void render_queue_uniform(
+    RenderQueue* queue, Shader shader, int loc, const void* value, int type
+) {
+    render_set_uniform( queue, shader.id, shader, loc, value, type );
+}
+
+RenderItem* render_queue_mesh(
+    RenderQueue* queue, const Mesh* mesh, Material material, Matrix transform
+) {
+    return render_queue_mesh_at(
+        queue, mesh, material, transform,
+        Vector3{ transform.m12, transform.m13, transform.m14 } );
+}
+RenderItem* render_queue_mesh_at(
+    RenderQueue* queue, const Mesh* mesh, Material material,
+    Matrix transform, Vector3 sort_position
+) {
+    RenderItem* item = render_queue_push(
+        queue, mesh, material, Vector3DistanceSqr( sort_position, queue->eye ) );
+    item->transform = transform;
+    return item;
+}
+RenderItem* render_queue_instanced(
+    RenderQueue* queue, const Mesh* mesh, Material material,
+    const Matrix* instances, int instance_count
+) {
+    RenderItem* item     = render_queue_push( queue, mesh, material, 0.0f );
+    item->instances      = instances;
+    item->instance_count = instance_count;
+    return item;
+}
+void render_item_uniform( RenderItem* item, int loc, const void* value, int type ) {
+    int size = render_uniform_size( type );
+    if( item->uniform_count >= RENDER_ITEM_MAX_UNIFORMS || !size ) {
+        return;
+    }
+    RenderUniform* uniform = item->uniforms + item->uniform_count++;
+    uniform->loc  = loc;
+    uniform->type = type;
+    memcpy( uniform->data, value, size );
+}
+
+static int render_item_cmp( const void* a, const void* b ) {
+    uint64_t lhs = ((const RenderItem*)a)->key;
+    uint64_t rhs = ((const RenderItem*)b)->key;
+    if( lhs == rhs ) {
+        return 0;
+    }
+    return lhs < rhs ? -1 : 1;
+}
+
+void render_queue_flush( RenderQueue* queue ) {
+    qsort( queue->buf, queue->len, sizeof(RenderItem), render_item_cmp );
+
+    unsigned int last_shader  = 0;
+    unsigned int last_texture = 0;
+    for( int i = 0; i < queue->len; ++i ) {
+        const RenderItem* item = queue->buf + i;
+        if( item->instances && !item->instance_count ) {
+            continue;
+        }
+
+        unsigned int shader  = item->material.shader.id;
+        unsigned int texture = item->material.maps ?
+            item->material.maps[MATERIAL_MAP_DIFFUSE].texture.id : 0;
+        if( !i || shader != last_shader ) {
+            queue->stats.shader_changes++;
+            last_shader = shader;
+        }
+        if( !i || texture != last_texture ) {
+            queue->stats.texture_changes++;
+            last_texture = texture;
+        }
+
+        for( int u = 0; u < item->uniform_count; ++u ) {
+            const RenderUniform* uniform = item->uniforms + u;
+            render_set_uniform(
+                queue, shader, item->material.shader,
+                uniform->loc, uniform->data, uniform->type );
+        }
+
+        if( item->prepare ) {
+            item->prepare( item->prepare_user, item->prepare_arg );
+        }
+
+        if( item->instances ) {
+            DrawMeshInstanced(
+                *item->mesh, item->material, item->instances, item->instance_count );
+        } else {
+            DrawMesh( *item->mesh, item->material, item->transform );
+        }
+        queue->stats.draw_calls++;
+    }
+    queue->stats.items = queue->len;
+    queue->len         = 0;
+}
+void render_queue_free( RenderQueue* queue ) {
+    if( queue->buf ) {
+        free( queue->buf );
+    }
+    if( queue->uniforms.buf ) {
+        free( queue->uniforms.buf );
+    }
+    if( queue->shaders.buf ) {
+        free( queue->shaders.buf );
+    }
+    *queue = {};
+}
@@ -4,7 +4,12 @@
  * @author Alicia Amarilla (smushyaa@gmail.com)
  * @date   January 25, 2025
 */
+#include "shaders.h"
+#include <stdlib.h>
+#include <string.h>
 
+// NOTE(alicia): same source is compiled once per permutation,
+// see SHADER_PERMUTATION_DEFINES for what each flag defines.
 const char basic_shading_vert[] = R"(
 #version 100
 
@@ -14,58 +19,85 @@ attribute vec3 vertexPosition;
 attribute vec2 vertexTexCoord;
 attribute vec3 vertexNormal;
 attribute vec4 vertexColor;
+#if defined(INSTANCED)
+attribute mat4 instanceTransform;
+#endif
 
 uniform mat4 mvp;
+#if !defined(INSTANCED)
 uniform mat4 matModel;
+// NOTE(alicia): transpose(inverse(matModel)), computed on CPU once per draw.
+uniform mat4 matNormal;
+#endif
 
 uniform vec4 colDiffuse;
 
 /* FROM RAYLIB */
 
+#if defined(BOB)
+// NOTE(alicia): battery spin and bob, same motion that
+// used to be baked into each battery's transform on CPU.
+uniform float bob_time;
+mat3 rotate_xyz( vec3 angle );
+#endif
+
 varying vec3 v2f_position;
 varying vec2 v2f_uv;
 varying vec4 v2f_color;
 varying vec3 v2f_normal;
 
-mat3 inverse( mat3 m );
-mat3 transpose( mat3 m );
-
 void main() {
-    v2f_position = vec3( matModel * vec4( vertexPosition, 1.0 ) );
+#if defined(INSTANCED)
+    mat4 model = instanceTransform;
+#if defined(BOB)
+    mat3 rotation = rotate_xyz( vec3( 0.2, bob_time, 0.2 ) );
+    float bob     = mix( 1.0 - 0.1, 1.0 + 0.2, (sin( bob_time ) + 1.0) / 2.0 );
+
+    model = model * mat4(
+        vec4( rotation[0], 0.0 ),
+        vec4( rotation[1], 0.0 ),
+        vec4( rotation[2], 0.0 ),
+        vec4( 0.0, bob, 0.0, 1.0 ) );
+#endif
+    vec4 world_position = model * vec4( vertexPosition, 1.0 );
+
+    // NOTE(alicia): instance transforms are only ever rotation
+    // and translation so model matrix is its own normal matrix.
+    mat3 normal_mat = mat3( model );
+#else
+    vec4 world_position = matModel * vec4( vertexPosition, 1.0 );
+    mat3 normal_mat     = mat3( matNormal );
+#endif
+
+    v2f_position = world_position.xyz;
     v2f_uv       = vertexTexCoord;
     v2f_color    = vertexColor * colDiffuse;
+    v2f_normal   = normalize( normal_mat * vertexNormal );
 
-    mat3 normal_mat = transpose( inverse( mat3( matModel ) ) );
-    v2f_normal      = normalize( normal_mat * vertexNormal );
-
+#if defined(INSTANCED)
+    gl_Position = mvp * world_position;
+#else
     gl_Position = mvp * vec4( vertexPosition, 1.0 );
+#endif
 }
 
-mat3 transpose( mat3 m ) {
-    return mat3(
-        m[0][0], m[1][0], m[2][0],
-        m[0][1], m[1][1], m[2][1],
-        m[0][2], m[1][2], m[2][2] );
-}
-mat3 inverse( mat3 m ) {
-    float a00 = m[0][0], a01 = m[0][1], a02 = m[0][2];
-    float a10 = m[1][0], a11 = m[1][1], a12 = m[1][2];
-    float a20 = m[2][0], a21 = m[2][1], a22 = m[2][2];
-
-    float b01 =  a22 * a11 - a12 * a21;
-    float b11 = -a22 * a10 + a12 * a20;
-    float b21 =  a21 * a10 - a11 * a20;
-
-    float det = a00 * b01 + a01 * b11 + a02 * b21;
+#if defined(BOB)
+// NOTE(alicia): same as raymath's MatrixRotateXYZ.
+mat3 rotate_xyz( vec3 angle ) {
+    float cx = cos( -angle.x ), sx = sin( -angle.x );
+    float cy = cos( -angle.y ), sy = sin( -angle.y );
+    float cz = cos( -angle.z ), sz = sin( -angle.z );
 
-    return mat3( b01, ( -a22 * a01 + a02 * a21 ), (  a12 * a01 - a02 * a11 ),
-                 b11, (  a22 * a00 - a02 * a20 ), ( -a12 * a00 + a02 * a10 ),
-                 b21, ( -a21 * a00 + a01 * a20 ), (  a11 * a00 - a01 * a10 ) ) / det;
+    return mat3(
+        cz * cy, (cz * sy * sx) - (sz * cx), (cz * sy * cx) + (sz * sx),
+        sz * cy, (sz * sy * sx) + (cz * cx), (sz * sy * cx) - (cz * sx),
+        -sy,     cy * sx,                    cy * cx );
 }
+#endif
 
 )";
 
-const char basic_shading_wall_frag[] = R"(
+const char basic_shading_frag[] = R"(
 #version 100
 
 precision mediump float;
@@ -82,10 +114,12 @@ uniform sampler2D texture0;
 /* FROM RAYLIB */
 
 uniform vec3  camera_position;
-uniform vec2  clipping_planes;
-uniform float dist;
-uniform int   apply_dist;
+// NOTE(alicia): geometry fades out before this so it can be culled without popping.
+uniform float fog_far;
 
+float fog_fade( float d ) {
+    return fog_far > 0.0 ? clamp( (fog_far - d) / (fog_far * 0.25), 0.0, 1.0 ) : 1.0;
+}
 float invmix( float a, float b, float v ) {
     return ( v - a ) / ( b - a );
 }
@@ -95,12 +129,14 @@ float remap( float imin, float imax, float omin, float omax, float v ) {
 }
 
 void main() {
-    float density    = 0.05;
-    float d          = length( v2f_position - camera_position );
-    float fog_factor = clamp( exp( -density * d ), 0.0, 1.0 );
+    float d = length( v2f_position - camera_position );
 
-    vec2 uv = vec2(
-        (apply_dist != 0) ? mod(v2f_uv.x * dist * 0.1, 1.0) : v2f_uv.x, v2f_uv.y );
+#if defined(WRAP_UV)
+    // NOTE(alicia): wall uvs have segment length baked in.
+    vec2 uv = vec2( mod( v2f_uv.x, 1.0 ), v2f_uv.y );
+#else
+    vec2 uv = v2f_uv;
+#endif
 
     vec3 normal      = normalize( v2f_normal );
     vec3 base_color  = texture2D( texture0, uv ).rgb;
@@ -114,59 +150,83 @@ void main() {
     light_mask = remap( 0.0, 1.0, 0.1, 1.0, light_mask );
 
     vec3 frag_color = (color * light_mask) + (ambient * (1.0 - light_mask));
-    vec3 fog_color  = frag_color * vec3( 0.28, 0.28, 0.4);
 
-    vec3 final_color = mix( fog_color, frag_color, fog_factor );
+#if defined(DISTANCE_FOG)
+    float density    = 0.05;
+    float fog_factor = clamp( exp( -density * d ), 0.0, 1.0 );
+    vec3  fog_color  = frag_color * vec3( 0.28, 0.28, 0.4 );
+
+    frag_color = mix( fog_color, frag_color, fog_factor );
+#endif
 
-    gl_FragColor = vec4( final_color, 1.0 );
-    // gl_FragColor = vec4( vec3( fog_factor ), 1.0 );
+    gl_FragColor = vec4( frag_color * fog_fade( d ), 1.0 );
 }
 
 )";
 
-const char basic_shading_frag[] = R"(
-#version 100
-
-precision mediump float;
-
-varying vec3 v2f_position;
-varying vec2 v2f_uv;
-varying vec4 v2f_color;
-varying vec3 v2f_normal;
-
-/* FROM RAYLIB */
-
-uniform sampler2D texture0;
-
-/* FROM RAYLIB */
+// NOTE(alicia): same order as ShaderPermutation bits.
+static const char* SHADER_PERMUTATION_DEFINES[] = {
+    "#define INSTANCED\n",
+    "#define BOB\n",
+    "#define DISTANCE_FOG\n",
+    "#define WRAP_UV\n",
+};
+
+// NOTE(alicia): defines have to go after #version so
+// version line is copied first, then defines, then the rest.
+static char* shader_permutation_source( const char* src, uint32_t flags ) {
+    if( !src ) {
+        return nullptr;
+    }
+    while( *src == '\n' ) {
+        src++;
+    }
+    const char* body = src;
+    if( !strncmp( src, "#version", 8 ) ) {
+        body = strchr( src, '\n' );
+        body = body ? body + 1 : src + strlen( src );
+    }
 
-uniform vec3 camera_position;
+    int count = sizeof(SHADER_PERMUTATION_DEFINES) / sizeof(SHADER_PERMUTATION_DEFINES[0]);
+    size_t size = strlen( src ) + 1;
+    for( int i = 0; i < count; ++i ) {
+        if( flags & (1u << i) ) {
+            size += strlen( SHADER_PERMUTATION_DEFINES[i] );
+        }
+    }
 
-float invmix( float a, float b, float v ) {
-    return ( v - a ) / ( b - a );
-}
-float remap( float imin, float imax, float omin, float omax, float v ) {
-    float t = invmix( imin, imax, v );
-    return mix( omin, omax, t );
+    char* result = (char*)malloc( size );
+    if( !result ) {
+        return nullptr;
+    }
+    size_t at = body - src;
+    memcpy( result, src, at );
+    for( int i = 0; i < count; ++i ) {
+        if( flags & (1u << i) ) {
+            size_t len = strlen( SHADER_PERMUTATION_DEFINES[i] );
+            memcpy( result + at, SHADER_PERMUTATION_DEFINES[i], len );
+            at += len;
+        }
+    }
+    memcpy( result + at, body, strlen( body ) + 1 );
+    return result;
 }
 
-void main() {
-    vec3 normal      = normalize( v2f_normal );
-    vec3 base_color  = texture2D( texture0, v2f_uv ).rgb;
-    vec3 from_camera = normalize( camera_position - v2f_position );
+Shader shader_load_permutation( const char* vert, const char* frag, uint32_t flags ) {
+    char* vs = shader_permutation_source( vert, flags );
+    char* fs = shader_permutation_source( frag, flags );
 
-    vec3 color = v2f_color.rgb * base_color;
+    Shader result = LoadShaderFromMemory( vs, fs );
 
-    vec3 ambient = color * vec3( 0.24, 0.24, 0.32 );
-
-    float light_mask = max( dot( from_camera, normal ), 0.0 );
-    light_mask = remap( 0.0, 1.0, 0.1, 1.0, light_mask );
-
-    gl_FragColor = vec4( (color * light_mask) + (ambient * (1.0 - light_mask)), 1.0 );
+    if( vs ) {
+        free( vs );
+    }
+    if( fs ) {
+        free( fs );
+    }
+    return result;
 }
 
-)";
-
 const char post_process_frag[] = R"(
 #version 100
 
@@ -0,0 +1,505 @@
+/**
+ * @file   skinning.cpp
+ * @brief  CPU skinning split from raylib's UpdateModelAnimation.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 04, 2025
+*/
+#include "skinning.h"
+#include "raymath.h"
+#include "shared/buffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+void skin_pose_reserve( SkinnedPose* pose, int vertex_count ) {
+    if( pose->vertices && pose->vertex_count >= vertex_count ) {
+        return;
+    }
+    skin_pose_free( pose );
+
+    pose->vertices     = (float*)malloc( sizeof(float) * 3 * vertex_count );
+    pose->normals      = (float*)malloc( sizeof(float) * 3 * vertex_count );
+    pose->vertex_count = vertex_count;
+}
+void skin_pose_free( SkinnedPose* pose ) {
+    if( pose->vertices ) {
+        free( pose->vertices );
+    }
+    if( pose->normals ) {
+        free( pose->normals );
+    }
+    *pose = {};
+}
+
+// NOTE(alicia): same math as raylib's UpdateModelAnimationBones
+// but written to local buffers instead of the shared mesh.
+static void skin_bone_matrices(
+    const Transform* bind_pose, const ModelAnimation& anim, int frame,
+    int bone_count, Matrix* out_bones, Matrix* out_normal_bones
+) {
+    Transform* frame_pose = anim.framePoses[frame];
+    for( int i = 0; i < bone_count; ++i ) {
+        Vector3    in_translation = bind_pose[i].translation;
+        Quaternion in_rotation    = bind_pose[i].rotation;
+        Vector3    in_scale       = bind_pose[i].scale;
+
+        Vector3    out_translation = frame_pose[i].translation;
+        Quaternion out_rotation    = frame_pose[i].rotation;
+        Vector3    out_scale       = frame_pose[i].scale;
+
+        Quaternion inv_rotation    = QuaternionInvert( in_rotation );
+        Vector3    inv_translation =
+            Vector3RotateByQuaternion( Vector3Negate( in_translation ), inv_rotation );
+        Vector3    inv_scale = {
+            1.0f / in_scale.x, 1.0f / in_scale.y, 1.0f / in_scale.z };
+
+        Vector3 bone_translation = Vector3Add(
+            Vector3RotateByQuaternion(
+                Vector3Multiply( out_scale, inv_translation ), out_rotation ),
+            out_translation );
+        Quaternion bone_rotation = QuaternionMultiply( out_rotation, inv_rotation );
+        Vector3    bone_scale    = Vector3Multiply( out_scale, inv_scale );
+
+        out_bones[i] = MatrixMultiply(
+            MatrixMultiply(
+                QuaternionToMatrix( bone_rotation ),
+                MatrixTranslate(
+                    bone_translation.x, bone_translation.y, bone_translation.z ) ),
+            MatrixScale( bone_scale.x, bone_scale.y, bone_scale.z ) );
+        out_normal_bones[i] = MatrixTranspose( MatrixInvert( out_bones[i] ) );
+    }
+}
+
+void skin_mesh(
+    const Mesh& mesh, const Transform* bind_pose,
+    const ModelAnimation& anim, int frame, SkinnedPose* out_pose
+) {
+    if( !mesh.boneIds || !mesh.boneWeights || !anim.frameCount ) {
+        return;
+    }
+    frame = frame % anim.frameCount;
+
+    int bone_count = anim.boneCount;
+    if( bone_count > SKIN_MAX_BONES ) {
+        bone_count = SKIN_MAX_BONES;
+    }
+
+    Matrix bones[SKIN_MAX_BONES];
+    Matrix normal_bones[SKIN_MAX_BONES];
+    skin_bone_matrices( bind_pose, anim, frame, bone_count, bones, normal_bones );
+
+    const float*         src_vertices = mesh.vertices;
+    const float*         src_normals  = mesh.normals;
+    const float*         weights      = mesh.boneWeights;
+    const unsigned char* ids          = mesh.boneIds;
+
+    float* dst_vertices = out_pose->vertices;
+    float* dst_normals  = out_pose->normals;
+
+    for( int v = 0; v < mesh.vertexCount; ++v ) {
+        float vx = src_vertices[v * 3 + 0];
+        float vy = src_vertices[v * 3 + 1];
+        float vz = src_vertices[v * 3 + 2];
+
+        float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+        if( src_normals ) {
+            nx = src_normals[v * 3 + 0];
+            ny = src_normals[v * 3 + 1];
+            nz = src_normals[v * 3 + 2];
+        }
+
+        float px = 0.0f, py = 0.0f, pz = 0.0f;
+        float rx = 0.0f, ry = 0.0f, rz = 0.0f;
+        for( int j = 0; j < 4; ++j ) {
+            float weight = weights[v * 4 + j];
+            int   id     = ids[v * 4 + j];
+            if( weight == 0.0f || id >= bone_count ) {
+                continue;
+            }
+
+            const Matrix& m = bones[id];
+            px += (m.m0 * vx + m.m4 * vy + m.m8  * vz + m.m12) * weight;
+            py += (m.m1 * vx + m.m5 * vy + m.m9  * vz + m.m13) * weight;
+            pz += (m.m2 * vx + m.m6 * vy + m.m10 * vz + m.m14) * weight;
+
+            const Matrix& n = normal_bones[id];
+            rx += (n.m0 * nx + n.m4 * ny + n.m8  * nz) * weight;
+            ry += (n.m1 * nx + n.m5 * ny + n.m9  * nz) * weight;
+            rz += (n.m2 * nx + n.m6 * ny + n.m10 * nz) * weight;
+        }
+
+        dst_vertices[v * 3 + 0] = px;
+        dst_vertices[v * 3 + 1] = py;
+        dst_vertices[v * 3 + 2] = pz;
+
+        dst_normals[v * 3 + 0] = rx;
+        dst_normals[v * 3 + 1] = ry;
+        dst_normals[v * 3 + 2] = rz;
+    }
+}
+
+void skin_upload( const Mesh& mesh, const SkinnedPose* pose ) {
+    int size = sizeof(float) * 3 * mesh.vertexCount;
+    // NOTE(alicia): raylib buffer indices, 0 = positions, 2 = normals
+    UpdateMeshBuffer( mesh, 0, pose->vertices, size, 0 );
+    if( mesh.normals ) {
+        UpdateMeshBuffer( mesh, 2, pose->normals, size, 0 );
+    }
+}
+
+void skin_batch_clear( SkinBatch* batch ) {
+    batch->len = 0;
+}
+void skin_batch_push(
+    SkinBatch* batch, const Model& model,
+    const ModelAnimation& anim, int frame, SkinnedPose* out_pose
+) {
+    SkinRequest request;
+    request.mesh      = model.meshes;
+    request.bind_pose = model.bindPose;
+    request.anim      = &anim;
+    request.bake      = nullptr;
+    request.animation = 0;
+    request.frame     = frame;
+    request.out       = out_pose;
+
+    skin_pose_reserve( out_pose, model.meshes[0].vertexCount );
+    buf_append( batch, request );
+}
+void skin_batch_push_baked(
+    SkinBatch* batch, const AnimBake* bake,
+    int animation, int frame, SkinnedPose* out_pose
+) {
+    SkinRequest request = {};
+    request.bake      = bake;
+    request.animation = animation;
+    request.frame     = frame;
+    request.out       = out_pose;
+
+    skin_pose_reserve( out_pose, bake->vertex_count );
+    buf_append( batch, request );
+}
+
+static void skin_job( void* params ) {
+    SkinRequest* request = (SkinRequest*)params;
+    if( request->bake ) {
+        anim_bake_decode(
+            request->bake, request->animation, request->frame, request->out );
+        return;
+    }
+    skin_mesh(
+        *request->mesh, request->bind_pose,
+        *request->anim, request->frame, request->out );
+}
+
+void skin_batch_dispatch( SkinBatch* batch ) {
+    for( int i = 0; i < batch->len; ++i ) {
+        jobs_submit( &batch->counter, skin_job, batch->buf + i );
+    }
+}
+void skin_batch_wait( SkinBatch* batch ) {
+    jobs_wait( &batch->counter );
+}
+void skin_batch_free( SkinBatch* batch ) {
+    if( batch->buf ) {
+        free( batch->buf );
+    }
+    *batch = {};
+}
+
+struct BakeJob {
+    const AnimBake*       bake;
+    const Model*          model;
+    const ModelAnimation* anim;
+    int                   frame;
+    int                   baked_frame;
+};
+static void bake_job( void* params ) {
+    BakeJob* job  = (BakeJob*)params;
+    auto*    bake = job->bake;
+
+    SkinnedPose pose = {};
+    skin_pose_reserve( &pose, bake->vertex_count );
+    skin_mesh(
+        job->model->meshes[0], job->model->bindPose,
+        *job->anim, job->frame, &pose );
+
+    Vector3 min = {  1e30f,  1e30f,  1e30f };
+    Vector3 max = { -1e30f, -1e30f, -1e30f };
+    for( int v = 0; v < bake->vertex_count; ++v ) {
+        float* p = pose.vertices + (v * 3);
+        min.x = p[0] < min.x ? p[0] : min.x;
+        min.y = p[1] < min.y ? p[1] : min.y;
+        min.z = p[2] < min.z ? p[2] : min.z;
+        max.x = p[0] > max.x ? p[0] : max.x;
+        max.y = p[1] > max.y ? p[1] : max.y;
+        max.z = p[2] > max.z ? p[2] : max.z;
+    }
+
+    AnimBakeFrame* frame = bake->frames + job->baked_frame;
+    frame->min   = min;
+    frame->scale = {
+        (max.x - min.x) / 65535.0f,
+        (max.y - min.y) / 65535.0f,
+        (max.z - min.z) / 65535.0f };
+    Vector3 inv_scale = {
+        frame->scale.x > 0.0f ? 1.0f / frame->scale.x : 0.0f,
+        frame->scale.y > 0.0f ? 1.0f / frame->scale.y : 0.0f,
+        frame->scale.z > 0.0f ? 1.0f / frame->scale.z : 0.0f };
+
+    size_t   stride    = (size_t)bake->vertex_count * 3;
+    int16_t* positions = bake->positions + (stride * job->baked_frame);
+    int8_t*  normals   = bake->normals   + (stride * job->baked_frame);
+    for( int v = 0; v < bake->vertex_count; ++v ) {
+        float* p = pose.vertices + (v * 3);
+        float* n = pose.normals  + (v * 3);
+
+        positions[v * 3 + 0] = (int16_t)((int)((p[0] - min.x) * inv_scale.x + 0.5f) - 32768);
+        positions[v * 3 + 1] = (int16_t)((int)((p[1] - min.y) * inv_scale.y + 0.5f) - 32768);
+        positions[v * 3 + 2] = (int16_t)((int)((p[2] - min.z) * inv_scale.z + 0.5f) - 32768);
+
+        for( int j = 0; j < 3; ++j ) {
+            float c = n[j];
+            c = c < -1.0f ? -1.0f : (c > 1.0f ? 1.0f : c);
+            normals[v * 3 + j] = (int8_t)(c * 127.0f + (c < 0.0f ? -0.5f : 0.5f));
+        }
+    }
+
+    skin_pose_free( &pose );
+}
+bool anim_bake(
+    AnimBake* out_bake, const Model& model,
+    const ModelAnimation* animations, int animation_count,
+    const int* indexes, int index_count
+) {
+    double start = GetTime();
+    AnimBake bake = {};
+
+    if( !model.meshCount || !model.meshes[0].boneIds ) {
+        return false;
+    }
+
+    bake.vertex_count    = model.meshes[0].vertexCount;
+    bake.animation_count = animation_count;
+    bake.offsets         = (int*)malloc( sizeof(int) * animation_count );
+    if( !bake.offsets ) {
+        return false;
+    }
+    for( int i = 0; i < animation_count; ++i ) {
+        bake.offsets[i] = -1;
+    }
+
+    for( int i = 0; i < index_count; ++i ) {
+        int index = indexes[i];
+        if( index < 0 || index >= animation_count || bake.offsets[index] >= 0 ) {
+            continue;
+        }
+        bake.offsets[index] = bake.frame_count;
+        bake.frame_count   += animations[index].frameCount;
+    }
+
+    size_t values = (size_t)bake.frame_count * bake.vertex_count * 3;
+    bake.positions = (int16_t*)malloc( sizeof(int16_t) * values );
+    bake.normals   = (int8_t*)malloc( sizeof(int8_t) * values );
+    bake.frames    = (AnimBakeFrame*)malloc( sizeof(AnimBakeFrame) * bake.frame_count );
+    BakeJob* jobs  = (BakeJob*)malloc( sizeof(BakeJob) * bake.frame_count );
+    if( !bake.positions || !bake.normals || !bake.frames || !jobs ) {
+        if( jobs ) {
+            free( jobs );
+        }
+        anim_bake_free( &bake );
+        return false;
+    }
+
+    JobCounter counter = {};
+    for( int i = 0; i < animation_count; ++i ) {
+        if( bake.offsets[i] < 0 ) {
+            continue;
+        }
+        for( int frame = 0; frame < animations[i].frameCount; ++frame ) {
+            BakeJob* job     = jobs + bake.offsets[i] + frame;
+            job->bake        = out_bake;
+            job->model       = &model;
+            job->anim        = animations + i;
+            job->frame       = frame;
+            job->baked_frame = bake.offsets[i] + frame;
+        }
+    }
+
+    // NOTE(alicia): jobs read bake through out_bake
+    // so it has to be filled in before dispatch.
+    *out_bake = bake;
+    for( int i = 0; i < bake.frame_count; ++i ) {
+        jobs_submit( &counter, bake_job, jobs + i );
+    }
+    jobs_wait( &counter );
+    free( jobs );
+
+    out_bake->memory =
+        (sizeof(int16_t) + sizeof(int8_t)) * values +
+        sizeof(AnimBakeFrame) * bake.frame_count +
+        sizeof(int) * animation_count;
+    out_bake->bake_time = GetTime() - start;
+    return true;
+}
+bool anim_bake_has( const AnimBake* bake, int animation ) {
+    return
+        bake->offsets && animation >= 0 &&
+        animation < bake->animation_count &&
+        bake->offsets[animation] >= 0;
+}
+void anim_bake_decode(
+    const AnimBake* bake, int animation, int frame, SkinnedPose* out_pose
+) {
+    size_t stride      = (size_t)bake->vertex_count * 3;
+    int    baked_frame = bake->offsets[animation] + frame;
+
+    const AnimBakeFrame* header    = bake->frames + baked_frame;
+    const int16_t*       positions = bake->positions + (stride * baked_frame);
+    const int8_t*        normals   = bake->normals   + (stride * baked_frame);
+
+    // NOTE(alicia): fold the +32768 bias into min so
+    // decode is a single multiply-add per component.
+    Vector3 base = {
+        header->min.x + 32768.0f * header->scale.x,
+        header->min.y + 32768.0f * header->scale.y,
+        header->min.z + 32768.0f * header->scale.z };
+
+    float* dst_vertices = out_pose->vertices;
+    float* dst_normals  = out_pose->normals;
+    for( int v = 0; v < bake->vertex_count; ++v ) {
+        dst_vertices[v * 3 + 0] = base.x + positions[v * 3 + 0] * header->scale.x;
+        dst_vertices[v * 3 + 1] = base.y + positions[v * 3 + 1] * header->scale.y;
+        dst_vertices[v * 3 + 2] = base.z + positions[v * 3 + 2] * header->scale.z;
+
+        // NOTE(alicia): shaders normalize, no need to do it here.
+        dst_normals[v * 3 + 0] = normals[v * 3 + 0] * (1.0f / 127.0f);
+        dst_normals[v * 3 + 1] = normals[v * 3 + 1] * (1.0f / 127.0f);
+        dst_normals[v * 3 + 2] = normals[v * 3 + 2] * (1.0f / 127.0f);
+    }
+}
+void anim_bake_free( AnimBake* bake ) {
+    if( bake->positions ) {
+        free( bake->positions );
+    }
+    if( bake->normals ) {
+        free( bake->normals );
+    }
+    if( bake->frames ) {
+        free( bake->frames );
+    }
+    if( bake->offsets ) {
+        free( bake->offsets );
+    }
+    *bake = {};
+}
+
+void pose_cache_begin_frame( PoseCache* cache ) {
+    cache->frame_stamp++;
+
+    cache->total.lookups += cache->stats.lookups;
+    cache->total.hits    += cache->stats.hits;
+    cache->total.skinned += cache->stats.skinned;
+    cache->total.decoded += cache->stats.decoded;
+    cache->total.uploads += cache->stats.uploads;
+    cache->total.time    += cache->stats.time;
+    cache->stats = {};
+
+    if( !cache->buf ) {
+        cache->uploaded = -1;
+    }
+}
+int pose_cache_acquire( PoseCache* cache, int animation, int frame, int vertex_count ) {
+    cache->stats.lookups++;
+
+    int recycle = -1;
+    for( int i = 0; i < cache->len; ++i ) {
+        auto* entry = cache->buf + i;
+        if( entry->animation == animation && entry->frame == frame ) {
+            cache->stats.hits++;
+            entry->last_used = cache->frame_stamp;
+            return i;
+        }
+
+        if(
+            entry->last_used != cache->frame_stamp &&
+            (recycle < 0 || entry->last_used < cache->buf[recycle].last_used)
+        ) {
+            recycle = i;
+        }
+    }
+
+    if( recycle < 0 ) {
+        PoseCacheEntry entry = {};
+        buf_append( cache, entry );
+        recycle = cache->len - 1;
+    }
+
+    auto* entry = cache->buf + recycle;
+    entry->animation = animation;
+    entry->frame     = frame;
+    entry->last_used = cache->frame_stamp;
+    entry->is_dirty  = true;
+    skin_pose_reserve( &entry->pose, vertex_count );
+
+    if( cache->uploaded == recycle ) {
+        cache->uploaded = -1;
+    }
+    return recycle;
+}
+void pose_cache_dispatch(
+    PoseCache* cache, SkinBatch* batch, const AnimBake* bake,
+    const Model& model, const ModelAnimation* animations
+) {
+    skin_batch_clear( batch );
+    for( int i = 0; i < cache->len; ++i ) {
+        auto* entry = cache->buf + i;
+        if( !entry->is_dirty ) {
+            continue;
+        }
+        entry->is_dirty = false;
+
+        if( bake && anim_bake_has( bake, entry->animation ) ) {
+            skin_batch_push_baked(
+                batch, bake, entry->animation, entry->frame, &entry->pose );
+            cache->stats.decoded++;
+            continue;
+        }
+
+        skin_batch_push(
+            batch, model, animations[entry->animation],
+            entry->frame, &entry->pose );
+        cache->stats.skinned++;
+    }
+    skin_batch_dispatch( batch );
+}
+void pose_cache_upload( PoseCache* cache, const Mesh& mesh, int slot ) {
+    if( cache->uploaded == slot ) {
+        return;
+    }
+    skin_upload( mesh, &cache->buf[slot].pose );
+    cache->uploaded = slot;
+    cache->stats.uploads++;
+}
+void pose_cache_free( PoseCache* cache ) {
+    if( cache->buf ) {
+        for( int i = 0; i < cache->len; ++i ) {
+            skin_pose_free( &cache->buf[i].pose );
+        }
+        free( cache->buf );
+    }
+    *cache = {};
+}
+float pose_cache_hit_rate( const PoseCacheStats& stats ) {
+    if( !stats.lookups ) {
+        return 0.0f;
+    }
+    return (float)stats.hits / (float)stats.lookups;
+}
+
+static int pose_draw_cmp( const void* a, const void* b ) {
+    return ((const PoseDraw*)a)->slot - ((const PoseDraw*)b)->slot;
+}
+void pose_draws_sort( PoseDraw* draws, int count ) {
+    qsort( draws, count, sizeof(PoseDraw), pose_draw_cmp );
+}
+
@@ -0,0 +1,202 @@
+/**
+ * @file   wall_batch.cpp
+ * @brief  Static wall meshes merged at level load.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   February 10, 2025
+*/
+#include "wall_batch.h"
+#include "raymath.h"
+#include "shared/buffer.h"
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct WallSortItem {
+    uint32_t tile;
+    int      segment;
+};
+static int wall_sort_cmp( const void* a, const void* b ) {
+    auto* lhs = (const WallSortItem*)a;
+    auto* rhs = (const WallSortItem*)b;
+    if( lhs->tile != rhs->tile ) {
+        return lhs->tile < rhs->tile ? -1 : 1;
+    }
+    return lhs->segment - rhs->segment;
+}
+
+/// @brief Same transform walls were drawn with when they were drawn one at a time.
+static Matrix wall_transform( Vector2 start, Vector2 end ) {
+    float angle = Vector2Angle( start - end, Vector2{ 0.0, 1.0 });
+    float dist  = Vector2Distance( start, end );
+    return
+        MatrixScale( 0.1, 10.0, dist ) *
+        MatrixRotateY( angle ) *
+        MatrixTranslate( start.x, 0.0, start.y );
+}
+
+static void wall_chunk_build(
+    WallChunk* chunk, const Mesh& wall,
+    const Vector2* vertexes, const MapFileSegment* segments,
+    const WallSortItem* items, int count
+) {
+    int wall_vertex_count = wall.vertexCount;
+    int wall_index_count  = wall.indices ? wall.triangleCount * 3 : 0;
+
+    Mesh mesh = {};
+    mesh.vertexCount   = wall_vertex_count * count;
+    mesh.triangleCount = wall.triangleCount * count;
+    // NOTE(alicia): UnloadMesh frees these with RL_FREE.
+    mesh.vertices  = (float*)MemAlloc( sizeof(float) * 3 * mesh.vertexCount );
+    mesh.normals   = (float*)MemAlloc( sizeof(float) * 3 * mesh.vertexCount );
+    mesh.texcoords = (float*)MemAlloc( sizeof(float) * 2 * mesh.vertexCount );
+    if( wall.colors ) {
+        mesh.colors = (unsigned char*)MemAlloc( 4 * mesh.vertexCount );
+    }
+    if( wall.indices ) {
+        mesh.indices = (unsigned short*)MemAlloc(
+            sizeof(unsigned short) * wall_index_count * count );
+    }
+
+    Vector3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vector3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    for( int i = 0; i < count; ++i ) {
+        const MapFileSegment* seg = segments + items[i].segment;
+        Vector2 start = vertexes[seg->start];
+        Vector2 end   = vertexes[seg->end];
+        float   dist  = Vector2Distance( start, end );
+
+        Matrix transform = wall_transform( start, end );
+        // NOTE(alicia): shader used to do this per vertex with matModel.
+        Matrix normal_transform = transform;
+        normal_transform.m12 = normal_transform.m13 = normal_transform.m14 = 0.0f;
+        normal_transform = MatrixTranspose( MatrixInvert( normal_transform ) );
+
+        int base = i * wall_vertex_count;
+        for( int v = 0; v < wall_vertex_count; ++v ) {
+            Vector3 position = Vector3Transform(
+                *(Vector3*)(wall.vertices + (v * 3)), transform );
+            Vector3 normal = Vector3Normalize( Vector3Transform(
+                *(Vector3*)(wall.normals + (v * 3)), normal_transform ) );
+
+            *(Vector3*)(mesh.vertices + ((base + v) * 3)) = position;
+            *(Vector3*)(mesh.normals  + ((base + v) * 3)) = normal;
+
+            // NOTE(alicia): segment length used to come from the dist uniform.
+            mesh.texcoords[((base + v) * 2) + 0] =
+                wall.texcoords[(v * 2) + 0] * dist * WALL_TEXTURE_SCALE;
+            mesh.texcoords[((base + v) * 2) + 1] = wall.texcoords[(v * 2) + 1];
+
+            if( mesh.colors ) {
+                memcpy( mesh.colors + ((base + v) * 4), wall.colors + (v * 4), 4 );
+            }
+
+            min = Vector3Min( min, position );
+            max = Vector3Max( max, position );
+        }
+
+        if( mesh.indices ) {
+            unsigned short* indices = mesh.indices + (i * wall_index_count);
+            for( int j = 0; j < wall_index_count; ++j ) {
+                indices[j] = (unsigned short)(base + wall.indices[j]);
+            }
+        }
+    }
+
+    UploadMesh( &mesh, false );
+
+    chunk->mesh          = mesh;
+    chunk->bounds        = BoundingBox{ min, max };
+    chunk->segment_count = count;
+}
+
+void wall_batch_build(
+    WallBatch* batch, const Mesh& wall,
+    const Vector2* vertexes, const MapFileSegment* segments, int segment_count
+) {
+    wall_batch_clear( batch );
+    if( !segment_count || !wall.vertexCount ) {
+        return;
+    }
+
+    batch->segment_chunk = (int*)realloc( batch->segment_chunk, sizeof(int) * segment_count );
+    for( int i = 0; i < segment_count; ++i ) {
+        batch->segment_chunk[i] = -1;
+    }
+
+    WallSortItem* items = (WallSortItem*)malloc( sizeof(WallSortItem) * segment_count );
+    int item_count = 0;
+
+    Vector2 origin = {};
+    for( int i = 0; i < segment_count; ++i ) {
+        Vector2 mid = Vector2Lerp(
+            vertexes[segments[i].start], vertexes[segments[i].end], 0.5f );
+        origin = i ? Vector2Min( origin, mid ) : mid;
+    }
+
+    for( int i = 0; i < segment_count; ++i ) {
+        Vector2 start = vertexes[segments[i].start];
+        Vector2 end   = vertexes[segments[i].end];
+        // NOTE(alicia): zero length wall has no area and its
+        // normal transform can't be inverted.
+        if( Vector2Equals( start, end ) ) {
+            continue;
+        }
+
+        Vector2  tile = (Vector2Lerp( start, end, 0.5f ) - origin) / WALL_CHUNK_TILE_SIZE;
+        uint32_t x    = (uint32_t)Clamp( tile.x, 0.0f, (float)UINT16_MAX );
+        uint32_t y    = (uint32_t)Clamp( tile.y, 0.0f, (float)UINT16_MAX );
+
+        items[item_count].tile    = (y << 16) | x;
+        items[item_count].segment = i;
+        item_count++;
+    }
+    qsort( items, item_count, sizeof(WallSortItem), wall_sort_cmp );
+
+    int max_per_chunk = WALL_CHUNK_MAX_VERTEXES / wall.vertexCount;
+    if( max_per_chunk < 1 ) {
+        max_per_chunk = 1;
+    }
+
+    int first = 0;
+    while( first < item_count ) {
+        int last = first + 1;
+        while(
+            last < item_count &&
+            items[last].tile == items[first].tile &&
+            (last - first) < max_per_chunk
+        ) {
+            last++;
+        }
+
+        for( int i = first; i < last; ++i ) {
+            batch->segment_chunk[items[i].segment] = batch->len;
+        }
+
+        WallChunk chunk = {};
+        wall_chunk_build( &chunk, wall, vertexes, segments, items + first, last - first );
+        buf_append( batch, chunk );
+        batch->segment_count += chunk.segment_count;
+
+        first = last;
+    }
+
+    free( items );
+}
+void wall_batch_clear( WallBatch* batch ) {
+    for( int i = 0; i < batch->len; ++i ) {
+        UnloadMesh( batch->buf[i].mesh );
+    }
+    batch->len           = 0;
+    batch->segment_count = 0;
+}
+void wall_batch_free( WallBatch* batch ) {
+    wall_batch_clear( batch );
+    if( batch->buf ) {
+        free( batch->buf );
+    }
+    if( batch->segment_chunk ) {
+        free( batch->segment_chunk );
+    }
+    *batch = {};
+}